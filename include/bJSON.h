@@ -3,19 +3,76 @@
 //--File Info-----------------------------------------------------------------------------------------------------------
 
 /// @file bJSON.h
-/// @version 0.1.1
+/// @version 0.2.0
 /// @brief a simple JSON serialization library for C++.
 ///
 /// Provides serialization capabilities and helper macros to define the serialization implementation for a desired
-/// type. JSON parsing capability is planned in the future.
+/// type. JSON text can be validated, re-formatted, and read into typed values with JSONPullReader (which the code
+/// generated by bjsongen uses).
 ///
 /// @remark constexpr serialization functionality was initially planned but relying on small string optimization is not
 /// the best decision. For now, constexpr functionality has been removed.
 ///
-/// @todo - implement JSON parsing
+/// @todo - implement parsing JSON text into JSONValues
 
 //--Changelog---------------------------------------------------------------------------------------------------------//
 /*                                                                                                                    //
+//  v0.2.0  -   Added JSONPath, which compiles JSONPath expressions (children, wildcards, recursive descent, slices   //
+//              and filters) into a bytecode program evaluated without recursion. Added JSONPointer and JSONPatch,    //
+//              which applies RFC 6902 patches in place and rolls failed patches back through an undo log. Added      //
+//              diff(), which generates a JSONPatch between two documents using memoized subtree hashes and an LCS    //
+//              over array elements. Added structural hashing (hash, hash128, and the streaming JSONHasher), opt-in   //
+//              hash caching via cache_hash, deep equality (operator==), and std::hash<JSONValue>; JSONPath filters,  //
+//              JSONPatch tests, and diff use them. Added dedupe(), which hash-conses equal subtrees into an          //
+//              immutable JSONSharedDocument, reports memory before and after, and serializes shared nodes once.      //
+//              Added JSONSchema, which compiles a JSON Schema subset into a flat rule table with hashed property     //
+//              lookups and an NFA-based pattern matcher, and validates a JSONValue or a stream of parse events in a  //
+//              single pass. Added JSONWriter (a format/sink policy writer), the canonical format (sorted keys,       //
+//              ECMAScript number forms, minimal escaping) with serialize_canonical, and a hashing sink behind        //
+//              canonical_hash. Added compact and pretty (indent width, CRLF) output styles as JSONWriter formats     //
+//              selected through JSONSerializeOptions; the default serializers now write through the same writer.     //
+//              Added minify() and reformat(), which re-format JSON text chunk by chunk through JSONReformatter       //
+//              without building a JSONValue, and the bjson command line tool. Added validate() and JSONValidator,    //
+//              which check the grammar and the UTF-8 of JSON text (in one piece or in chunks) without allocating or  //
+//              building values. Added JSONStringScanner, which validates the UTF-8 of strings (with AVX2/SSE4.1      //
+//              lookup tables or portable code) in the same pass as the escaping scan, and JSONUtf8Mode to reject     //
+//              invalid strings, replace them with U+FFFD, or trust them. Added an ASCII-only output mode             //
+//              (JSONSerializeOptions::ascii_only), which escapes every character which is not ASCII as \uXXXX (with  //
+//              surrogate pairs past U+FFFF) while the ASCII runs of each string are copied block by block. Added     //
+//              serialization of (and JSONValue construction from) std::string, std::u16string, std::u32string,       //
+//              std::wstring, their views, and their string literals; UTF-16/UTF-32 strings are transcoded to UTF-8   //
+//              as they are escaped (see JSONTranscoder), and char* literals no longer convert to bool. Added char    //
+//              output: JSONCharStringSink, JSONCharVectorSink, JSONSpanSink (a fixed size buffer),                   //
+//              serialize_into(...) for std::string, std::vector<char>, and std::span<char>, serialize_chars(...),    //
+//              and write(...), which writes a value to any sink in any output style. Added JSONIntegerFormatter,     //
+//              which writes integral numbers below 2^64 in full (e.g. 1000000 rather than 1e+06) two digits at a     //
+//              time; the NumberType serializer now writes straight into its output. Numbers which are doubles are    //
+//              now written in the shortest form of the double straight into the sink (e.g. 3.14 rather than          //
+//              3.1400000000000001243 where long double is wider), and NaN/infinity are rejected or written as null   //
+//              (JSONNonFiniteMode) instead of producing invalid JSON. Added configurable precision for numbers which //
+//              are not integers (JSONPrecision: shortest, significant digits like %g, or fixed decimals like %f) per //
+//              call (JSONSerializeOptions::precision) or per field (JSONRoundedNumber); most doubles are rounded by  //
+//              scaling to an integer rather than through std::to_chars. Added serialize_numbers(...) and             //
+//              JSONWriter::write_numbers(...), which write packed arrays of numbers (floats in the shortest form of  //
+//              the float). Integers with more than 8 digits are converted to digits 16 at a time with SSE4.1. Runs   //
+//              of numbers in arrays, and packed numbers, are formatted straight into blocks of memory                //
+//              (JSONBlockSink) together with their separators. Added JSONRawNumber, which keeps the JSON text of a   //
+//              number (e.g. 1.10, or integers too large for a NumberType), is serialized by copying it, and parses   //
+//              its value only on access. Raw numbers are created exactly from integers and decimals                  //
+//              (JSONRawNumber::decimal), convert back to integers exactly (to_integer, with an optional decimal      //
+//              scale), and compare by value without a big number library. Added serialization of std::chrono time    //
+//              points of the system clock (ISO-8601 UTC timestamps with the precision of their duration) and         //
+//              durations (ISO-8601 durations in seconds), JSONTimestamp for other precisions and epoch numbers, and  //
+//              parse_timestamp(...)/parse_duration(...); dates are converted with civil calendar arithmetic and      //
+//              written through a fixed template (JSONTimeFormatter). Added JSONBlob, which serializes binary data as //
+//              base64 encoded straight into the output, and decode_base64(...) (both vectorized with SSE4.1/AVX2).   //
+//              Added bJSON_ENUM(T, ...), which serializes an enum as the name of its value from constexpr tables of  //
+//              quoted names, and parse_enum(...), which reads names back through a perfect hash. Added               //
+//              bJSON_AGGREGATE(T, ...), which serializes a plain struct as an object of its members, decomposed with //
+//              structured bindings and written with constant key fragments. Added JSONPullReader, which reads JSON   //
+//              text straight into typed values, and the bjsongen tool, which generates headers of structs with       //
+//              unrolled serializers and switch-dispatched deserializers from a simple IDL.                           //
+//                                                                                                                    //
 //  v0.1.1  -   Removed constexpr functionality. Switched to u8string output for serialization to ensure utf8         //
 //              output. Added an inline serialization macro. Removed regex dependency. Ensured control characters     //
 //              (0x00 - 0x1F) which may be encoded in strings are "escaped" when serializing through the string       //
@@ -28,16 +85,30 @@
 
 //--Includes------------------------------------------------------------------------------------------------------------
 
+#include <algorithm>     // for clamping/sorting helpers
 #include <array>         // for char buffers
+#include <bit>           // for counting bits (escape masks)
 #include <charconv>      // for converting from numbers to strings
+#include <chrono>        // for timestamps and durations
+#include <cmath>         // for decomposing numbers (hashing)
+#include <cstdint>       // for fixed width integers (bytecode operands, hashes, etc.)
+#include <cstring>       // for memcpy
 #include <exception>     // for when serialization encounters an error
 #include <iostream>      // for printing to the console
+#include <limits>        // for numeric limits
+#include <span>          // for fixed size output buffers
 #include <string>        // for strings
+#include <string_view>   // for non-owning views of strings (query expressions, etc.)
 #include <type_traits>   // for templated type traits
 #include <unordered_map> // for JSONObjects (string keys and JSONValue values)
+#include <utility>       // for std::as_const (reading a mutable document without invalidating its hashes)
 #include <variant>       // for JSONValues to be able to hold one of multiple types
 #include <vector>        // for JSONArrays (list of JSONValues)
 
+#if !defined(bJSON_NO_SIMD) && (defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__))
+#    include <immintrin.h> // for vectorized string scanning, digit conversion, and base64
+#endif
+
 //--Macros--------------------------------------------------------------------------------------------------------------
 
 /// @brief we use some macro "hacks" so that when used in this file, the serialization helper macro doesn't include the
@@ -47,6 +118,15 @@
 /// will include the full namespace when used elsewhere in a codebase
 #define bJSON_NAMESPACE()
 
+/// @brief the instruction set used to scan strings (see JSONStringScanner), to convert long integers to digits (see
+/// JSONIntegerFormatter), and to encode and decode base64 (see JSONBase64), chosen from the compiler's target: AVX2,
+/// then SSE4.1, otherwise portable code. Define bJSON_NO_SIMD to always use the portable code
+#if !defined(bJSON_NO_SIMD) && defined(__AVX2__)
+#    define bJSON_SIMD_AVX2
+#elif !defined(bJSON_NO_SIMD) && (defined(__SSE4_1__) || defined(__AVX__))
+#    define bJSON_SIMD_SSE4
+#endif
+
 /// @brief "helper macro" which declares a type as JSON serializable, but does not implement a definition
 ///
 /// to provide a definition for the serialization implementation, use of the bJSON_DEFINE_SERIALIZATION() macro is
@@ -91,12 +171,202 @@
     bJSON_DECLARE_SERIALIZABLE(T);                                                                                     \
     inline bJSON_DEFINE_SERIALIZATION(T)
 
+/// @brief "helper macro" which registers an enum as JSON serializable, as the (quoted) name of its value. The
+/// enumerators are listed after the type, and the names are taken from the list:
+///
+/// bJSON_ENUM(Color, red, green, blue);
+///
+/// serializes Color::green as "green", and parse_enum(u8"green", color) reads it back (see JSONEnumTable<T> for the
+/// tables generated at compile time). Like the other helper macros, it is used outside of any namespace
+///
+/// @param T the enum to make serializable
+/// @param ... its enumerators (unqualified)
+#define bJSON_ENUM(T, ...)                                                                                             \
+    template <> struct bJSON_NAMESPACE()##JSONEnumNames<T>                                                             \
+    {                                                                                                                  \
+        static constexpr auto values{[] {                                                                              \
+            using enum T;                                                                                              \
+            return std::array{__VA_ARGS__};                                                                            \
+        }()};                                                                                                          \
+        static constexpr std::string_view list{#__VA_ARGS__};                                                          \
+    };                                                                                                                 \
+    bJSON_MAKE_SERIALIZABLE_INLINE(T)                                                                                  \
+    {                                                                                                                  \
+        return bJSON_NAMESPACE()##JSONEnumTable<T>::serialize(val);                                                    \
+    }                                                                                                                  \
+    static_assert(bJSON_NAMESPACE()##JSONEnumTable<T>::valid, "bJSON_ENUM(" #T ", ...) lists a name twice")
+
+/// @brief "helper macro" which registers an aggregate (a plain struct with public members and no base classes or
+/// constructors) as JSON serializable, as an object of its members. The names of the members are listed after the
+/// type, in the order they are declared:
+///
+/// bJSON_AGGREGATE(Point, x, y, label);
+///
+/// serializes Point{1, 2, u8"a"} as { "x" : 1, "y" : 2, "label" : "a" }. The members are found with structured
+/// bindings, so the names only label them; a list which does not name every member fails to compile (see
+/// JSONAggregateTable<T>)
+///
+/// @param T the aggregate to make serializable
+/// @param ... the names of its members
+#define bJSON_AGGREGATE(T, ...)                                                                                        \
+    template <> struct bJSON_NAMESPACE()##JSONAggregateNames<T>                                                        \
+    {                                                                                                                  \
+        static constexpr std::string_view list{#__VA_ARGS__};                                                          \
+    };                                                                                                                 \
+    bJSON_MAKE_SERIALIZABLE_INLINE(T)                                                                                  \
+    {                                                                                                                  \
+        return bJSON_NAMESPACE()##JSONAggregateTable<T>::serialize(val);                                               \
+    }                                                                                                                  \
+    static_assert(                                                                                                     \
+        bJSON_NAMESPACE()##JSONAggregateTable<T>::valid,                                                               \
+        "bJSON_AGGREGATE(" #T ", ...) must name every member of " #T ", which must be an aggregate")
+
 //--JSON Serialization--------------------------------------------------------------------------------------------------
 
 namespace ben
 {
     namespace json
     {
+        //--Unicode Transcoding-----------------------------------------------------------------------------------------
+
+        /// @brief transcodes UTF-16 and UTF-32 strings to UTF-8 (std::wstring is UTF-16 where wchar_t is 2 bytes, as on
+        /// Windows, and UTF-32 elsewhere)
+        ///
+        /// blocks of ASCII code units are narrowed at once (with SSE4.1 packing when it is enabled, see
+        /// JSONStringScanner); other code units are decoded one code point at a time
+        struct JSONTranscoder
+        {
+#if defined(bJSON_SIMD_AVX2)
+            static constexpr std::size_t block_size{32}; ///< the number of code units narrowed at once
+#elif defined(bJSON_SIMD_SSE4)
+            static constexpr std::size_t block_size{16}; ///< the number of code units narrowed at once
+#else
+            static constexpr std::size_t block_size{8}; ///< the number of code units narrowed at once
+#endif
+            static constexpr char32_t replacement{0xfffd}; ///< the code point which replaces invalid code units
+
+            /// @brief narrows a block of code units to UTF-8 if they are all ASCII
+            /// @param units the code units
+            /// @param size the number of code units (at most block_size)
+            /// @param out receives the narrowed code units (its contents are unspecified if they are not all ASCII)
+            /// @return true if every code unit is ASCII
+            template <typename Unit> static bool narrow(const Unit *units, std::size_t size, char8_t *out) noexcept
+            {
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+                if constexpr (sizeof(Unit) == 2)
+                {
+                    if (size == block_size)
+                    {
+                        __m128i any{_mm_setzero_si128()};
+                        for (std::size_t i = 0; i < block_size; i += 16)
+                        {
+                            const __m128i low{_mm_loadu_si128(reinterpret_cast<const __m128i *>(units + i))};
+                            const __m128i high{_mm_loadu_si128(reinterpret_cast<const __m128i *>(units + i + 8))};
+                            any = _mm_or_si128(any, _mm_or_si128(low, high));
+                            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(low, high));
+                        }
+                        return _mm_testz_si128(any, _mm_set1_epi16(static_cast<short>(0xff80))) != 0;
+                    }
+                }
+#endif
+                char32_t any{0};
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    any |= static_cast<char32_t>(units[i]);
+                    out[i] = static_cast<char8_t>(units[i]);
+                }
+                return any < 0x80;
+            }
+
+            /// @brief decodes the code point at a position
+            /// @param string the UTF-16 or UTF-32 string
+            /// @param at the position (advanced past the code units of the code point)
+            /// @param valid set to false if the code unit is an unpaired surrogate or past U+10FFFF, else to true
+            /// @return the code point (or replacement if it is not valid)
+            template <typename Unit>
+            static char32_t decode(std::basic_string_view<Unit> string, std::size_t &at, bool &valid) noexcept
+            {
+                const char32_t unit{static_cast<char32_t>(string[at++])};
+                if constexpr (sizeof(Unit) == 2)
+                {
+                    if (unit >= 0xd800 && unit <= 0xdbff && at < string.size())
+                    {
+                        const char32_t low{static_cast<char32_t>(string[at])};
+                        if (low >= 0xdc00 && low <= 0xdfff)
+                        {
+                            ++at;
+                            valid = true;
+                            return 0x10000 + ((unit - 0xd800) << 10) + (low - 0xdc00);
+                        }
+                    }
+                }
+                valid = (unit < 0xd800 || unit > 0xdfff) && unit <= 0x10ffff;
+                return valid ? unit : replacement;
+            }
+
+            /// @brief encodes a (valid) code point as UTF-8
+            /// @param code_point the code point
+            /// @param out receives the code units (at most 4)
+            /// @return the number of code units written
+            static std::size_t encode(char32_t code_point, char8_t *out) noexcept
+            {
+                if (code_point < 0x80)
+                {
+                    out[0] = static_cast<char8_t>(code_point);
+                    return 1;
+                }
+                if (code_point < 0x800)
+                {
+                    out[0] = static_cast<char8_t>(0xc0 | (code_point >> 6));
+                    out[1] = static_cast<char8_t>(0x80 | (code_point & 0x3f));
+                    return 2;
+                }
+                if (code_point < 0x10000)
+                {
+                    out[0] = static_cast<char8_t>(0xe0 | (code_point >> 12));
+                    out[1] = static_cast<char8_t>(0x80 | ((code_point >> 6) & 0x3f));
+                    out[2] = static_cast<char8_t>(0x80 | (code_point & 0x3f));
+                    return 3;
+                }
+                out[0] = static_cast<char8_t>(0xf0 | (code_point >> 18));
+                out[1] = static_cast<char8_t>(0x80 | ((code_point >> 12) & 0x3f));
+                out[2] = static_cast<char8_t>(0x80 | ((code_point >> 6) & 0x3f));
+                out[3] = static_cast<char8_t>(0x80 | (code_point & 0x3f));
+                return 4;
+            }
+
+            /// @brief transcodes a string to UTF-8, replacing invalid code units with U+FFFD
+            /// @param string the UTF-16 or UTF-32 string
+            /// @return the UTF-8 string
+            template <typename Unit> static std::u8string to_utf8(std::basic_string_view<Unit> string)
+            {
+                std::u8string utf8{};
+                utf8.reserve(string.size());
+
+                std::array<char8_t, block_size> ascii{};
+                for (std::size_t at = 0; at < string.size();)
+                {
+                    const std::size_t size{std::min(block_size, string.size() - at)};
+                    if (narrow(string.data() + at, size, ascii.data()))
+                    {
+                        utf8.append(ascii.data(), size);
+                        at += size;
+                        continue;
+                    }
+
+                    // a surrogate pair may end past the block, in which case the next block starts after it
+                    const std::size_t end{at + size};
+                    while (at < end)
+                    {
+                        bool                   valid{true};
+                        std::array<char8_t, 4> encoded{};
+                        utf8.append(encoded.data(), encode(decode(string, at, valid), encoded.data()));
+                    }
+                }
+                return utf8;
+            }
+        };
+
         //--Types-------------------------------------------------------------------------------------------------------
 
         /// @brief a struct containing the information associated with a JSON "value"
@@ -188,6 +458,14 @@ namespace ben
             /// implement
             std::variant<LiteralType, NumberType, StringType, ArrayType, ObjectType> value{LiteralType::null_v};
 
+            /// @brief the cached structural hash of this JSONValue (0 if it has not been cached)
+            ///
+            /// only filled in by ben::json::cache_hash(...). Copies and moves carry the cached hash along with the
+            /// value, and the mutating paths of this library (JSONPatch and resolving a JSONPointer against a non-const
+            /// document) reset it on every node they touch. Code which mutates value directly must call
+            /// ben::json::invalidate_hash(...) on the mutated node and all of its ancestors which have a cached hash
+            mutable std::uint64_t hash_cache{0};
+
             //--Default Ctor and Dtor-----------------------------------------------------------------------------------
 
             /// @brief leaves the JSONValue in such a state that .type == JSONValueType::undefined (i.e. it will be
@@ -237,6 +515,43 @@ namespace ben
             /// an empty u8string)
             constexpr JSONValue(const char8_t *const val) : JSONValue{std::u8string{val ? val : u8""}} { };
 
+            /// @brief std::u8string_view ctor
+            /// @param val the UTF-8 string to copy into the stored value
+            constexpr JSONValue(std::u8string_view val) : JSONValue{StringType{val}} { };
+
+            /// @brief std::string_view ctor
+            /// @param val the string (of UTF-8 code units) to copy into the stored value
+            constexpr JSONValue(std::string_view val) : JSONValue{StringType{val.begin(), val.end()}} { };
+
+            /// @brief char* string literal ctor (without it, a char* would convert to a bool)
+            /// @param val the string literal (if the char* is nullptr, converts to an empty u8string)
+            constexpr JSONValue(const char *const val) : JSONValue{std::string_view{val ? val : ""}} { };
+
+            /// @brief std::u16string_view ctor
+            /// @param val the UTF-16 string to transcode into the stored value (unpaired surrogates become U+FFFD)
+            JSONValue(std::u16string_view val) : JSONValue{JSONTranscoder::to_utf8(val)} { };
+
+            /// @brief std::u32string_view ctor
+            /// @param val the UTF-32 string to transcode into the stored value (invalid code points become U+FFFD)
+            JSONValue(std::u32string_view val) : JSONValue{JSONTranscoder::to_utf8(val)} { };
+
+            /// @brief std::wstring_view ctor
+            /// @param val the UTF-16 (or UTF-32, depending on the size of wchar_t) string to transcode into the stored
+            /// value (invalid code units become U+FFFD)
+            JSONValue(std::wstring_view val) : JSONValue{JSONTranscoder::to_utf8(val)} { };
+
+            /// @brief char16_t* string literal ctor
+            /// @param val the string literal (if the char16_t* is nullptr, converts to an empty u8string)
+            JSONValue(const char16_t *const val) : JSONValue{std::u16string_view{val ? val : u""}} { };
+
+            /// @brief char32_t* string literal ctor
+            /// @param val the string literal (if the char32_t* is nullptr, converts to an empty u8string)
+            JSONValue(const char32_t *const val) : JSONValue{std::u32string_view{val ? val : U""}} { };
+
+            /// @brief wchar_t* string literal ctor
+            /// @param val the string literal (if the wchar_t* is nullptr, converts to an empty u8string)
+            JSONValue(const wchar_t *const val) : JSONValue{std::wstring_view{val ? val : L""}} { };
+
             /// @brief const JSONValue::ArrayType& ctor
             /// @param val the JSONValue::ArrayType value to store in the JSONValue's variant
             /// @remark copies val into the stored value
@@ -259,15 +574,18 @@ namespace ben
 
             /// @brief copy ctor
             /// @param other the JSONValue to copy the type/value of
-            constexpr JSONValue(const JSONValue &other) : type{other.type}, value{other.value} { };
+            constexpr JSONValue(const JSONValue &other) :
+                type{other.type}, value{other.value}, hash_cache{other.hash_cache} { };
 
             /// @brief move ctor
             /// @param other the JSONValue to get the type/move the value from
             /// @remark sets other.type to JSONValueType::undefined, leaves other.value in a moved-from (likely invalid)
             /// state
-            constexpr JSONValue(JSONValue &&other) noexcept : type{other.type}, value{std::move(other.value)}
+            constexpr JSONValue(JSONValue &&other) noexcept :
+                type{other.type}, value{std::move(other.value)}, hash_cache{other.hash_cache}
             {
-                other.type = JSONValueType::undefined;
+                other.type       = JSONValueType::undefined;
+                other.hash_cache = 0;
             };
 
             //--Assignment Operators------------------------------------------------------------------------------------
@@ -277,8 +595,9 @@ namespace ben
             /// @return a reference to this JSONValue
             constexpr JSONValue &operator=(const JSONValue &other)
             {
-                type  = other.type;
-                value = other.value;
+                type       = other.type;
+                value      = other.value;
+                hash_cache = other.hash_cache;
 
                 return *this;
             };
@@ -290,338 +609,9758 @@ namespace ben
             /// state
             constexpr JSONValue &operator=(JSONValue &&other) noexcept
             {
-                type  = other.type;
-                value = std::move(other.value);
+                type       = other.type;
+                value      = std::move(other.value);
+                hash_cache = other.hash_cache;
 
-                other.type = JSONValueType::undefined;
+                other.type       = JSONValueType::undefined;
+                other.hash_cache = 0;
 
                 return *this;
             };
         };
 
-        //--Templates---------------------------------------------------------------------------------------------------
+        //--JSON String Scanning----------------------------------------------------------------------------------------
 
-        /// @brief templated struct which contains information associated with the JSON serialization of a type
-        ///
-        /// for all types T, the struct contains the following information:
-        ///     - JSONSerializationInfo<T>::SerializationFnType; an alias for a pointer to a function accepting a const
-        ///     T& as the single argument which returns a const std::u8string
-        ///     - JSONSerializationInfo<T>::serializable; a static constexpr bool which is true if type T is JSON
-        ///     serializable and false otherwise
-        ///     - JSONSerializationInfo<T>::serializer; a static constexpr function pointer of type
-        ///     JSONSerializationInfo<T>::SerializationFnType (depends on T) which points to the serialization
-        ///     implementation for type T if it exists or nullptr if it does not exist
-        ///     - JSONSerializationInfo<T>::serializer_impl(const T&); a static member function declaration for the
-        ///     implementation of the serialization of type T. If specialized via the helper macro, the
-        ///     JSONSerializationInfo<T>::serializer function pointer is set to the implementation method instead of
-        ///     nullptr
-        ///
-        /// @tparam T the type to get the JSON serialization information of
-        template <typename T> struct JSONSerializationInfo
+        /// @brief what the serialization of a string does if the string is not valid UTF-8
+        enum struct JSONUtf8Mode
         {
-            /// @brief an alias for a pointer to a function matching the type of the serialization implementation for
-            /// this type
-            using SerializationFnType = const std::string (*)(const T &);
-
-            /// @brief a constexpr boolean which is true if type T is JSON serializable and false otherwise
-            static constexpr bool serializable{false};
-
-            /// @brief the default serializer_impl for a generic type returns an empty string; implementations must be
-            /// provided for specializations
-            /// @param val the value of type T to serialize
-            /// @return an empty string (constexpr)
-            static constexpr std::u8string serializer_impl(const T &val) { return std::string{""}; };
-
-            /// @brief a constexpr function pointer to the SerializationFnType for type T which points to the
-            /// serialization implementation or nullptr if the type is not JSON serializable
-            static constexpr SerializationFnType serializer{nullptr};
+            reject,  ///< throw (so serialize(...) returns an empty string rather than invalid JSON)
+            replace, ///< write U+FFFD for each maximal invalid subsequence (as the WHATWG encoding standard does)
+            trust,   ///< copy the string without checking it (for strings which are known to be valid)
         };
 
-        /// @brief helper template which converts to a constexpr bool which is true if
-        /// JSONSerializationInfo<T>::serializable is declared and true, false otherwise
-        /// @tparam T the type to test for JSON serialization capability
-        template <typename T> constexpr bool is_json_serializable_v = JSONSerializationInfo<T>::serializable;
-
-        /// @brief helper template which converts to a constexpr JSONSerializationInfo<T>::SerializationFnType which is
-        /// nullptr if T is not JSON serializable, otherwise if T _is_ JSON serializable the value is the address of the
-        /// serialization implementation for type T
-        /// @tparam T the type to get the JSON serialization implementation function pointer for
-        template <typename T>
-        constexpr JSONSerializationInfo<T>::SerializationFnType json_serializer_v =
-            JSONSerializationInfo<T>::serializer;
+        /// @brief scans strings in blocks for the units which must be escaped and, in the same pass, validates their
+        /// UTF-8
+        ///
+        /// with AVX2 (32 unit blocks) or SSE4.1 (16 unit blocks) enabled at compile time (e.g. /arch:AVX2 or -mavx2),
+        /// UTF-8 is validated with the lookup algorithm of Keiser and Lemire: three 16-entry table lookups on the
+        /// nibbles of each pair of adjacent bytes classify every error but missing/extra continuation bytes of 3 and 4
+        /// byte sequences, which are caught by comparing against the bytes 2 and 3 positions back. Blocks of ASCII
+        /// only need a single test. Otherwise (or if bJSON_NO_SIMD is defined) blocks of 8 units are checked as a
+        /// 64-bit word while they are ASCII, and unit by unit when they are not
+        ///
+        /// errors are accumulated across blocks: once failed() the string is invalid, but the offending sequence may
+        /// have started (up to 3 units) before the current block (see sequence_start(...))
+        class JSONStringScanner
+        {
+          public:
+#if defined(bJSON_SIMD_AVX2)
+            static constexpr std::size_t block_size{32}; ///< the number of units scanned at once
+#elif defined(bJSON_SIMD_SSE4)
+            static constexpr std::size_t block_size{16}; ///< the number of units scanned at once
+#else
+            static constexpr std::size_t block_size{8}; ///< the number of units scanned at once
+#endif
 
-        /// @brief helper template which converts to a constexpr bool which is true if type T is not JSON serializable
-        /// directly but a JSONValue can be constructed from T and false otherwise
-        template <typename T>
-        constexpr bool converts_to_json_value_v =
-            (!is_json_serializable_v<T> && !std::is_same_v<JSONValue, T> && std::is_constructible_v<JSONValue, T>);
+            /// @brief one bit per unit of a block (the lowest bit for the first unit)
+            using Mask = std::uint32_t;
 
-        /// @brief templated serialization function which is enabled via the second template parameter which depends on
-        /// the type being JSON serializable
-        /// @tparam T the type (which is JSON serializable else the instantiation for T isn't compiled) to serialize
-        /// @tparam serializer the second template parameter which is of type
-        /// JSONSerializationInfo<T>::SerializationFnType which defaults to the json serialization implementation for
-        /// type T
-        /// @param val the value to serialize (passed by const ref)
-        /// @return const u8string containing the result of the serialization implementation for the value of type T
-        /// @note marked noexcept, which is not to say the serialization implementations themselves are not allowed to
-        /// throw; if the implementation throws, the exception (or whatever is thrown) is caught and an empty string is
-        /// returned as the result of serialization
-        template <
-            typename T,
-            std::enable_if_t<is_json_serializable_v<T>, typename JSONSerializationInfo<T>::SerializationFnType>
-                serializer = json_serializer_v<T>>
-        const std::u8string serialize(const T &val) noexcept
-        {
-            std::u8string serialized{u8""};
+            //--JSONStringScanner Scanning------------------------------------------------------------------------------
 
-            try
-            {
-                serialized.append(serializer(val));
-            }
-            catch (const std::exception &e)
+            /// @brief scans the next block of a string
+            /// @tparam validate false to skip the UTF-8 validation
+            /// @tparam ascii true to also report the units which are not ASCII (the units of multi-byte sequences)
+            /// @param block the next block_size units
+            /// @return the units of the block which must be escaped
+            template <bool validate, bool ascii = false> Mask scan(const char8_t *block) noexcept
             {
-                std::cout << "[ben::json::serialize] Error: " << e.what() << " Returning empty string.\n";
-            }
-            catch (...)
-            {
-                std::cout << "[ben::json::serialize] Error: An unknown error has occured. Returning empty string.\n";
-            }
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+                const Vector input{load(block)};
+                const Vector escapes{bitwise_or(
+                    bitwise_or(equal(input, splat(u8'\"')), equal(input, splat(u8'\\'))),
+                    equal(minimum(input, splat(0x1f)), input))};
 
-            return serialized;
-        }
+                if constexpr (validate)
+                {
+                    if (high_bits(input) == 0)
+                    {
+                        // an ASCII block is only invalid if the previous block ended within a sequence
+                        error = bitwise_or(error, prev_incomplete);
+                    }
+                    else
+                    {
+                        const Vector prev1{previous<1>(input, prev_input)};
+                        const Vector first_high{lookup(byte_1_high(), high_nibbles(prev1))};
+                        const Vector first_low{lookup(byte_1_low(), low_nibbles(prev1))};
+                        const Vector second_high{lookup(byte_2_high(), high_nibbles(input))};
+                        const Vector special{bitwise_and(bitwise_and(first_high, first_low), second_high)};
 
-        //--JSONSerializationInfo<JSONValue> Forward Declaration--------------------------------------------------------
+                        // the 3rd and 4th bytes of sequences must be continuation bytes (and flagged TWO_CONTS above)
+                        const Vector third{saturating_sub(previous<2>(input, prev_input), splat(0xe0 - 0x80))};
+                        const Vector fourth{saturating_sub(previous<3>(input, prev_input), splat(0xf0 - 0x80))};
+                        const Vector must_be_continuation{bitwise_and(bitwise_or(third, fourth), splat(0x80))};
 
-        // It is necessary to forward declare the JSONSerializationInfo<JSONValue>::serializer_impl(const JSONValue &)
-        // member function which must exist by the time a JSONValue::JSONArray or JSONValue::JSONObject serialization
-        // definition is provided AND before the conversion serialization template is instantiated (since the conversion
-        // template uses the JSONValue serializer). So, JSONSerializationInfo<JSONValue> is specialized here by hand
-        // rather than with the macro.  Serialization implementation definition provided below other / JSONValue variant
-        // type serialization implementation macro calls.
+                        error           = bitwise_or(error, bitwise_xor(must_be_continuation, special));
+                        prev_incomplete = saturating_sub(input, incomplete_bounds());
+                    }
+                    prev_input = input;
+                }
+                if constexpr (ascii)
+                {
+                    return high_bits(bitwise_or(escapes, input));
+                }
+                return high_bits(escapes);
+#else
+                constexpr std::uint64_t ones{0x0101010101010101ull};
+                constexpr std::uint64_t highs{0x8080808080808080ull};
 
-        bJSON_DECLARE_SERIALIZABLE(JSONValue);
+                std::uint64_t word{0};
+                std::memcpy(&word, block, 8);
 
-        //--JSON Value ("default") Types Registration-------------------------------------------------------------------
+                // the high bit of each byte which may be a quote, a backslash, or a control character is set
+                const std::uint64_t quote{word ^ (ones * u8'\"')};
+                const std::uint64_t backslash{word ^ (ones * u8'\\')};
+                const std::uint64_t special{
+                    ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash) | ((word - ones * 0x20) & ~word)};
 
-        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::LiteralType)
-        {
-            std::u8string serialized{u8""};
-            switch (val)
-            {
-            case JSONValue::LiteralType::null_v:
-                serialized.append(u8"null");
-                break;
-            case JSONValue::LiteralType::true_v:
-                serialized.append(u8"true");
-                break;
-            case JSONValue::LiteralType::false_v:
-                serialized.append(u8"false");
-                break;
-            default:
-                throw std::exception{"JSONLiteral had invalid value -- was it empty initialized by accident?"};
-                break;
-            }
-            return serialized;
-        }
+                Mask escapes{0};
+                if ((special & highs) != 0 || (ascii && (word & highs) != 0))
+                {
+                    if constexpr (std::endian::native == std::endian::little)
+                    {
+                        // the tests above may also flag a byte after a match (through the borrow); these do not, as
+                        // no byte of the sums carries into the next, so the mask is gathered from the high bits
+                        const std::uint64_t lows{~highs};
+                        const std::uint64_t exact{
+                            (~(((quote & lows) + lows) | quote) | ~(((backslash & lows) + lows) | backslash) |
+                             ~(((word & lows) + ones * 0x60) | word) | (ascii ? word : 0)) &
+                            highs};
+                        escapes = static_cast<Mask>(((exact >> 7) * 0x0102040810204080ull) >> 56);
+                    }
+                    else
+                    {
+                        for (std::size_t i = 0; i < 8; ++i)
+                        {
+                            escapes |= static_cast<Mask>(must_escape(block[i]) || (ascii && block[i] >= 0x80)) << i;
+                        }
+                    }
+                }
 
-        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::NumberType)
-        {
-            std::array<char, std::numeric_limits<JSONValue::NumberType>::max_digits10 + 1> ascii{'\0'};
+                if constexpr (validate)
+                {
+                    if ((word & highs) != 0 || pending != 0)
+                    {
+                        for (std::size_t i = 0; i < 8 && !invalid; ++i)
+                        {
+                            step(block[i]);
+                        }
+                    }
+                }
+                return escapes;
+#endif
+            }
 
-            // convert the number to characters...
-            std::to_chars_result res = std::to_chars(ascii.data(), ascii.data() + ascii.size(), val);
-            if (res.ec != std::errc{})
+            /// @brief true if the blocks scanned so far are not valid UTF-8
+            bool failed() const noexcept
             {
-                throw std::exception{std::make_error_code(res.ec).message().c_str()};
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+                return !all_zero(error);
+#else
+                return invalid;
+#endif
             }
 
-            // avoid UB with reinterpret_cast... annoying but quick and dirty for now.
-            std::u8string utf8;
-            for (const auto c : ascii)
+            /// @brief true if the last block scanned ended within a sequence
+            bool incomplete() const noexcept
             {
-                if (c == '\0')
-                {
-                    break;
-                }
-
-                utf8.push_back(static_cast<char8_t>(c));
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+                return !all_zero(prev_incomplete);
+#else
+                return pending != 0;
+#endif
             }
 
-            return utf8;
-        }
-
-        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::StringType)
-        {
-            std::u8string serialized{u8"\""};
+            //--JSONStringScanner Static Helpers------------------------------------------------------------------------
 
-            // avoid UB with reinterpret_csat... but also avoid regex since it would lead to issues with unicode
-            // characters! Also be sure to escape any of the "control characters" as per the JSON specification
-
-            for (const auto &unit : val)
+            /// @brief true if a unit must be escaped in a JSON string
+            static constexpr bool must_escape(char8_t unit) noexcept
             {
+                return unit < 0x20 || unit == u8'\"' || unit == u8'\\';
+            }
 
-                switch (unit)
-                {
-                case u8'\\':
-                    serialized.append(u8"\\\\");
-                    continue;
-                case u8'\"':
-                    serialized.append(u8"\\\"");
-                    continue;
-                case u8'\n':
-                    serialized.append(u8"\\n");
-                    continue;
-                case u8'\r':
-                    serialized.append(u8"\\r");
-                    continue;
-                case u8'\t':
-                    serialized.append(u8"\\t");
-                    continue;
-                case u8'\f':
-                    serialized.append(u8"\\f");
-                    continue;
-                case u8'\b':
-                    serialized.append(u8"\\b");
-                    continue;
-                default:
-                    break;
-                }
-                if (unit >= 0x00 && unit <= 0x1F)
+            /// @brief finds where the sequence which may continue past a position starts
+            /// @param string the string
+            /// @param at the position (e.g. the start of a block)
+            /// @return the position of the lead byte of a sequence which is cut by at, or at
+            static std::size_t sequence_start(std::u8string_view string, std::size_t at) noexcept
+            {
+                for (std::size_t back = 1; back <= 3 && back <= at; ++back)
                 {
-                    std::array<char, 3>  asHex{'\0'};
-                    std::to_chars_result res = std::to_chars(asHex.data(), asHex.data() + asHex.size(), unit, 16);
-                    if (res.ec != std::errc{})
+                    const char8_t unit{string[at - back]};
+                    if (unit < 0x80)
                     {
-                        throw std::exception{std::make_error_code(res.ec).message().c_str()};
+                        break;
                     }
-                    serialized.append(u8"\\u");
-                    size_t length{strnlen(asHex.data(), 2)};
-                    for (size_t i = 0; i < 4 - length; ++i)
+                    if (unit >= 0xc0)
                     {
-                        serialized.push_back(u8'0');
+                        return (unit >= 0xf0 ? 4u : (unit >= 0xe0 ? 3u : 2u)) > back ? at - back : at;
                     }
-                    for (size_t i = 0; i < length; ++i)
-                    {
-                        serialized.push_back(static_cast<char8_t>(asHex.at(i)));
-                    }
-                }
-                else
-                {
-                    serialized.push_back(unit);
                 }
+                return at;
             }
 
-            serialized.push_back(u8'\"');
-            return serialized;
-        }
-
-        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::ArrayType)
-        {
-            std::u8string serialized{u8"["};
-            for (auto first{true}; const auto &element : val)
+            /// @brief classifies the lead byte of a multi-byte UTF-8 sequence (overlong encodings, surrogates, and code
+            /// points past U+10FFFF are rejected through the range of the first continuation byte; the others range
+            /// from 0x80 to 0xbf)
+            /// @param lead the first (non-ASCII) unit of the sequence
+            /// @param lower set to the smallest valid first continuation byte
+            /// @param upper set to the largest valid first continuation byte
+            /// @return the number of continuation bytes which must follow, or 0 if the unit can not start a sequence
+            static constexpr std::size_t continuations(char8_t lead, char8_t &lower, char8_t &upper) noexcept
             {
-                if (element.type == JSONValue::JSONValueType::undefined)
+                lower = lead == 0xe0 ? 0xa0 : (lead == 0xf0 ? 0x90 : 0x80);
+                upper = lead == 0xed ? 0x9f : (lead == 0xf4 ? 0x8f : 0xbf);
+                if (lead < 0xc2 || lead > 0xf4)
                 {
-                    continue;
+                    return 0;
                 }
+                return lead >= 0xf0 ? 3 : (lead >= 0xe0 ? 2 : 1);
+            }
 
-                if (!first)
+            /// @brief checks the (non-ASCII) sequence starting at a position, unit by unit
+            /// @param string the string
+            /// @param at the position of the lead byte
+            /// @param valid set to true if the sequence is valid UTF-8
+            /// @return the size of the sequence if it is valid, otherwise the size of its maximal invalid subpart (at
+            /// least 1)
+            static std::size_t sequence_size(std::u8string_view string, std::size_t at, bool &valid) noexcept
+            {
+                char8_t           lower{0x80};
+                char8_t           upper{0xbf};
+                const std::size_t size{continuations(string[at], lower, upper) + 1};
+                if (size == 1)
                 {
-                    serialized.push_back(u8',');
+                    valid = false;
+                    return 1;
                 }
-                else
+
+                for (std::size_t i = 1; i < size; ++i)
                 {
-                    first = false;
+                    if (at + i >= string.size() || string[at + i] < lower || string[at + i] > upper)
+                    {
+                        valid = false;
+                        return i;
+                    }
+                    lower = 0x80;
+                    upper = 0xbf;
                 }
-
-                serialized.push_back(u8' ');
-                serialized.append(serialize(element));
+                valid = true;
+                return size;
             }
-            serialized.append(u8" ]");
-            return serialized;
-        };
 
-        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::ObjectType)
-        {
-            std::u8string serialized{u8"{"};
-            for (auto first{true}; const auto &[key, value] : val)
+          private:
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+            //--JSONStringScanner Vector Operations---------------------------------------------------------------------
+
+#    if defined(bJSON_SIMD_AVX2)
+            using Vector = __m256i;
+
+            static Vector load(const char8_t *p) noexcept
+            {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            }
+            static Vector splat(int v) noexcept { return _mm256_set1_epi8(static_cast<char>(v)); }
+            static Vector table(const std::array<char, 16> &t) noexcept
+            {
+                return _mm256_setr_epi8(
+                    t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7], t[8], t[9], t[10], t[11], t[12], t[13], t[14],
+                    t[15], t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7], t[8], t[9], t[10], t[11], t[12], t[13],
+                    t[14], t[15]);
+            }
+            static Vector bitwise_and(Vector a, Vector b) noexcept { return _mm256_and_si256(a, b); }
+            static Vector bitwise_or(Vector a, Vector b) noexcept { return _mm256_or_si256(a, b); }
+            static Vector bitwise_xor(Vector a, Vector b) noexcept { return _mm256_xor_si256(a, b); }
+            static Vector equal(Vector a, Vector b) noexcept { return _mm256_cmpeq_epi8(a, b); }
+            static Vector minimum(Vector a, Vector b) noexcept { return _mm256_min_epu8(a, b); }
+            static Vector saturating_sub(Vector a, Vector b) noexcept { return _mm256_subs_epu8(a, b); }
+            static Vector lookup(Vector t, Vector nibbles) noexcept { return _mm256_shuffle_epi8(t, nibbles); }
+            static Vector high_nibbles(Vector v) noexcept { return bitwise_and(_mm256_srli_epi16(v, 4), splat(0x0f)); }
+            static Vector low_nibbles(Vector v) noexcept { return bitwise_and(v, splat(0x0f)); }
+            static Mask   high_bits(Vector v) noexcept { return static_cast<Mask>(_mm256_movemask_epi8(v)); }
+            static bool   all_zero(Vector v) noexcept { return _mm256_testz_si256(v, v) != 0; }
+
+            /// @brief the units of input shifted back by N (with the last N units of prior shifted in)
+            template <int N> static Vector previous(Vector input, Vector prior) noexcept
+            {
+                return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prior, input, 0x21), 16 - N);
+            }
+
+            /// @brief the largest units which may end a block (anything larger is a lead byte cut by the block end)
+            static Vector incomplete_bounds() noexcept
+            {
+                return _mm256_setr_epi8(
+                    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                    -1, -1, -1, -1, static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1),
+                    static_cast<char>(0xc0 - 1));
+            }
+#    else
+            using Vector = __m128i;
+
+            static Vector load(const char8_t *p) noexcept
+            {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            }
+            static Vector splat(int v) noexcept { return _mm_set1_epi8(static_cast<char>(v)); }
+            static Vector table(const std::array<char, 16> &t) noexcept
+            {
+                return _mm_setr_epi8(
+                    t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7], t[8], t[9], t[10], t[11], t[12], t[13], t[14],
+                    t[15]);
+            }
+            static Vector bitwise_and(Vector a, Vector b) noexcept { return _mm_and_si128(a, b); }
+            static Vector bitwise_or(Vector a, Vector b) noexcept { return _mm_or_si128(a, b); }
+            static Vector bitwise_xor(Vector a, Vector b) noexcept { return _mm_xor_si128(a, b); }
+            static Vector equal(Vector a, Vector b) noexcept { return _mm_cmpeq_epi8(a, b); }
+            static Vector minimum(Vector a, Vector b) noexcept { return _mm_min_epu8(a, b); }
+            static Vector saturating_sub(Vector a, Vector b) noexcept { return _mm_subs_epu8(a, b); }
+            static Vector lookup(Vector t, Vector nibbles) noexcept { return _mm_shuffle_epi8(t, nibbles); }
+            static Vector high_nibbles(Vector v) noexcept { return bitwise_and(_mm_srli_epi16(v, 4), splat(0x0f)); }
+            static Vector low_nibbles(Vector v) noexcept { return bitwise_and(v, splat(0x0f)); }
+            static Mask   high_bits(Vector v) noexcept { return static_cast<Mask>(_mm_movemask_epi8(v)); }
+            static bool   all_zero(Vector v) noexcept { return _mm_testz_si128(v, v) != 0; }
+
+            /// @brief the units of input shifted back by N (with the last N units of prior shifted in)
+            template <int N> static Vector previous(Vector input, Vector prior) noexcept
+            {
+                return _mm_alignr_epi8(input, prior, 16 - N);
+            }
+
+            /// @brief the largest units which may end a block (anything larger is a lead byte cut by the block end)
+            static Vector incomplete_bounds() noexcept
+            {
+                return _mm_setr_epi8(
+                    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xf0 - 1),
+                    static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1));
+            }
+#    endif
+
+            //--JSONStringScanner Lookup Tables-------------------------------------------------------------------------
+
+            // the error classes of a pair of adjacent bytes (too_large_1000 and overlong_4 share a bit, and two_conts
+            // is the high bit so that it cancels out against must_be_continuation in scan(...))
+            static constexpr char too_short{1 << 0};                    ///< a lead byte not followed by a continuation
+            static constexpr char too_long{1 << 1};                     ///< ASCII followed by a continuation byte
+            static constexpr char overlong_3{1 << 2};                   ///< 11100000 100_____
+            static constexpr char too_large{1 << 3};                    ///< past U+10FFFF (11110100 1001____ and up)
+            static constexpr char surrogate{1 << 4};                    ///< 11101101 101_____
+            static constexpr char overlong_2{1 << 5};                   ///< 1100000_ 10______
+            static constexpr char too_large_1000{1 << 6};               ///< 11110101 1000____ and above
+            static constexpr char overlong_4{1 << 6};                   ///< 11110000 1000____
+            static constexpr char two_conts{static_cast<char>(1 << 7)}; ///< two continuation bytes in a row
+
+            // the classes decided by the high nibble of the first byte alone
+            static constexpr char carry{too_short | too_long | two_conts};
+
+            /// @brief the error classes by the high nibble of the first byte of a pair
+            static Vector byte_1_high() noexcept
+            {
+                return table(
+                    {too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long, two_conts,
+                     two_conts, two_conts, two_conts, too_short | overlong_2, too_short,
+                     too_short | overlong_3 | surrogate, too_short | too_large | too_large_1000 | overlong_4});
+            }
+
+            /// @brief the error classes by the low nibble of the first byte of a pair
+            static Vector byte_1_low() noexcept
+            {
+                constexpr char large{carry | too_large | too_large_1000};
+                return table(
+                    {carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry, carry | too_large,
+                     large, large, large, large, large, large, large, large, large | surrogate, large, large});
+            }
+
+            /// @brief the error classes by the high nibble of the second byte of a pair
+            static Vector byte_2_high() noexcept
+            {
+                constexpr char continuation{too_long | overlong_2 | two_conts};
+                return table(
+                    {too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+                     continuation | overlong_3 | too_large_1000 | overlong_4, continuation | overlong_3 | too_large,
+                     continuation | surrogate | too_large, continuation | surrogate | too_large, too_short, too_short,
+                     too_short, too_short});
+            }
+
+            //--JSONStringScanner Member Variables----------------------------------------------------------------------
+
+            Vector error{splat(0)};           ///< the errors found so far
+            Vector prev_input{splat(0)};      ///< the previous block
+            Vector prev_incomplete{splat(0)}; ///< non-zero if the previous block ended within a sequence
+#else
+            //--JSONStringScanner Member Variables----------------------------------------------------------------------
+
+            std::size_t pending{0};     ///< the continuation bytes still expected
+            char8_t     lower{0x80};    ///< the smallest valid next continuation byte
+            char8_t     upper{0xbf};    ///< the largest valid next continuation byte
+            bool        invalid{false}; ///< true once an error has been found
+
+            /// @brief checks the next unit
+            void step(char8_t unit) noexcept
+            {
+                if (pending != 0)
+                {
+                    invalid = unit < lower || unit > upper;
+                    lower   = 0x80;
+                    upper   = 0xbf;
+                    --pending;
+                    return;
+                }
+                if (unit < 0x80)
+                {
+                    return;
+                }
+
+                pending = continuations(unit, lower, upper);
+                invalid = pending == 0;
+            }
+#endif
+        };
+
+        //--JSON Writer-------------------------------------------------------------------------------------------------
+
+        /// @brief a sink which appends output to a u8string
+        ///
+        /// sinks receive the output of a JSONWriter; any type providing write(const char8_t *, std::size_t) and
+        /// put(char8_t) can be used as one
+        struct JSONStringSink
+        {
+            JSONValue::StringType &out; ///< the string to append to
+
+            void write(const char8_t *data, std::size_t size) { out.append(data, size); }
+            void put(char8_t unit) { out.push_back(unit); }
+        };
+
+        /// @brief a sink which writes output to a std::ostream (e.g. a file or std::cout)
+        struct JSONStreamSink
+        {
+            std::ostream &out; ///< the stream to write to
+
+            // char may alias any object, so viewing the UTF-8 code units as chars is well defined
+            void write(const char8_t *data, std::size_t size)
+            {
+                out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+            }
+            void put(char8_t unit) { out.put(static_cast<char>(unit)); }
+        };
+
+        /// @brief a sink which appends output to a std::string (e.g. the buffer of a socket or HTTP library)
+        struct JSONCharStringSink
+        {
+            std::string &out; ///< the string to append to
+
+            // char may alias any object, so viewing the UTF-8 code units as chars is well defined
+            void write(const char8_t *data, std::size_t size)
+            {
+                out.append(reinterpret_cast<const char *>(data), size);
+            }
+            void put(char8_t unit) { out.push_back(static_cast<char>(unit)); }
+        };
+
+        /// @brief a sink which appends output to a std::vector<char>
+        struct JSONCharVectorSink
+        {
+            std::vector<char> &out; ///< the vector to append to
+
+            // char may alias any object, so viewing the UTF-8 code units as chars is well defined
+            void write(const char8_t *data, std::size_t size)
+            {
+                const char *chars{reinterpret_cast<const char *>(data)};
+                out.insert(out.end(), chars, chars + size);
+            }
+            void put(char8_t unit) { out.push_back(static_cast<char>(unit)); }
+        };
+
+        /// @brief a sink which writes output into a fixed size buffer of chars (it never allocates)
+        struct JSONSpanSink
+        {
+            std::span<char> out;     ///< the buffer to write to
+            std::size_t     size{0}; ///< the number of chars written so far
+
+            /// @throws std::exception if the output does not fit in the buffer
+            void write(const char8_t *data, std::size_t count)
+            {
+                if (count > out.size() - size)
+                {
+                    throw std::exception{"[ben::json::JSONSpanSink] the output does not fit in the buffer"};
+                }
+                std::memcpy(out.data() + size, data, count);
+                size += count;
+            }
+
+            /// @throws std::exception if the output does not fit in the buffer
+            void put(char8_t unit)
+            {
+                if (size == out.size())
+                {
+                    throw std::exception{"[ben::json::JSONSpanSink] the output does not fit in the buffer"};
+                }
+                out[size++] = static_cast<char>(unit);
+            }
+        };
+
+        /// @brief a sink which gathers output in a block of memory and writes it to another sink when the block fills
+        /// up (or when it is flushed), so that e.g. a run of numbers and their separators is a few writes to the
+        /// other sink rather than a few per number. Numbers are formatted straight into the block (see reserve(...))
+        ///
+        /// the output still in the block when the sink is destroyed is discarded, so it must be flushed
+        /// @tparam Sink the sink the blocks are written to
+        template <typename Sink> class JSONBlockSink
+        {
+          public:
+            static constexpr std::size_t capacity{4096}; ///< the size of the block
+
+            explicit JSONBlockSink(Sink &sink) : sink{sink} { };
+
+            void write(const char8_t *data, std::size_t count)
+            {
+                if (count > capacity - size)
+                {
+                    flush();
+                    if (count > capacity)
+                    {
+                        sink.write(data, count);
+                        return;
+                    }
+                }
+                std::memcpy(block.data() + size, data, count);
+                size += count;
+            }
+
+            void put(char8_t unit)
+            {
+                if (size == capacity)
+                {
+                    flush();
+                }
+                block[size++] = unit;
+            }
+
+            /// @brief the space for (at most) count units of output, which are added by commit(...)
+            char8_t *reserve(std::size_t count)
+            {
+                if (count > capacity - size)
+                {
+                    flush();
+                }
+                return block.data() + size;
+            }
+
+            /// @brief adds the first count units of the space returned by reserve(...) to the output
+            void commit(std::size_t count) noexcept { size += count; }
+
+            /// @brief writes the output in the block to the other sink
+            void flush()
+            {
+                sink.write(block.data(), size);
+                size = 0;
+            }
+
+          private:
+            Sink                         &sink;   ///< the sink the blocks are written to
+            std::array<char8_t, capacity> block;   ///< the output not written yet (only read after it is written)
+            std::size_t                   size{0}; ///< the size of the output in the block
+        };
+
+        /// @brief what the serialization of a number does if the number is NaN or infinite (which JSON can not
+        /// represent)
+        enum struct JSONNonFiniteMode
+        {
+            error, ///< throw (so serialize(...) returns an empty string rather than invalid JSON)
+            null,  ///< write null instead
+        };
+
+        /// @brief how numbers which are not integers are rounded when they are serialized (integers are always written
+        /// in full)
+        enum struct JSONRounding
+        {
+            shortest,    ///< the shortest form which reads back as the same number (no rounding)
+            significant, ///< to a number of significant digits, without trailing zeros (like printf's %g)
+            decimals,    ///< to a number of digits after the decimal point (like printf's %f)
+        };
+
+        /// @brief the precision of the numbers which are not integers (see JSONRounding)
+        struct JSONPrecision
+        {
+            JSONRounding rounding{JSONRounding::shortest}; ///< how numbers are rounded
+            int          digits{0};                        ///< the number of significant (or decimal) digits
+        };
+
+        /// @brief formats integers two digits at a time
+        ///
+        /// the number of digits is found up front (from the bit width of the integer and one comparison against a
+        /// power of ten), so the digits are written from the back of the buffer straight into place: two per division
+        /// by 100, copied from a table of the digit pairs 00 to 99. With SSE4.1 (see bJSON_SIMD_SSE4), integers with
+        /// more than 8 digits (timestamps, counters, ids, etc.) are instead converted 16 digits at a time: two blocks
+        /// of 8 digits are divided by 10^4 and then by 10^3, 10^2, and 10^1 in parallel (with multiplications by
+        /// reciprocals), and the leading zeros are shifted out of the block
+        struct JSONIntegerFormatter
+        {
+            static constexpr std::size_t max_size{21}; ///< the size of the longest integer (with its sign)
+
+            /// @brief the digit pairs 00 to 99 (the pair of n starts at 2 * n)
+            static constexpr std::u8string_view pairs{
+                u8"00010203040506070809101112131415161718192021222324"
+                u8"25262728293031323334353637383940414243444546474849"
+                u8"50515253545556575859606162636465666768697071727374"
+                u8"75767778798081828384858687888990919293949596979899"};
+
+            /// @brief true if a number is an integer which format(...) can write (i.e. its magnitude is below 2^64)
+            static bool formattable(JSONValue::NumberType value) noexcept
+            {
+                return value == std::trunc(value) && std::fabs(value) < 0x1p64L;
+            }
+
+            /// @brief the number of decimal digits of an integer
+            static std::size_t digit_count(std::uint64_t value) noexcept
+            {
+                constexpr std::array<std::uint64_t, 20> powers{
+                    1ull, 10ull, 100ull, 1'000ull, 10'000ull, 100'000ull, 1'000'000ull, 10'000'000ull, 100'000'000ull,
+                    1'000'000'000ull, 10'000'000'000ull, 100'000'000'000ull, 1'000'000'000'000ull,
+                    10'000'000'000'000ull, 100'000'000'000'000ull, 1'000'000'000'000'000ull, 10'000'000'000'000'000ull,
+                    100'000'000'000'000'000ull, 1'000'000'000'000'000'000ull, 10'000'000'000'000'000'000ull};
+
+                // the bit width times 1233 / 4096 (about log10(2)) is the digit count or one less, which one comparison
+                // settles (the low bit is set so that 0 has 1 digit; it does not change the digit count of any other
+                // integer)
+                const std::size_t estimate{(static_cast<std::size_t>(std::bit_width(value | 1)) * 1233) >> 12};
+                return estimate + ((value | 1) >= powers[estimate] ? 1 : 0);
+            }
+
+            /// @brief writes the digits of an integer (and its sign) into a buffer
+            /// @param value the magnitude of the integer
+            /// @param negative true to write a minus sign first
+            /// @param out the buffer (at least max_size units)
+            /// @return the number of units written
+            static std::size_t format(std::uint64_t value, bool negative, char8_t *out) noexcept
+            {
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+                if (value >= 100'000'000)
+                {
+                    return format_vector(value, negative, out);
+                }
+#endif
+                out[0] = u8'-';
+                const std::size_t size{digit_count(value) + (negative ? 1 : 0)};
+                char8_t          *end{out + size};
+                while (value >= 100)
+                {
+                    const std::size_t pair{static_cast<std::size_t>(value % 100) * 2};
+                    value /= 100;
+                    end -= 2;
+                    end[0] = pairs[pair];
+                    end[1] = pairs[pair + 1];
+                }
+                if (value >= 10)
+                {
+                    end[-2] = pairs[value * 2];
+                    end[-1] = pairs[value * 2 + 1];
+                }
+                else
+                {
+                    end[-1] = static_cast<char8_t>(u8'0' + value);
+                }
+                return size;
+            }
+
+            /// @brief writes an integral number (see formattable(...)) to a sink
+            template <typename Sink> static void write(Sink &sink, JSONValue::NumberType value)
+            {
+                std::array<char8_t, max_size> digits{};
+                const std::uint64_t           magnitude{static_cast<std::uint64_t>(std::fabs(value))};
+                sink.write(digits.data(), format(magnitude, std::signbit(value), digits.data()));
+            }
+
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+          private:
+            /// @brief converts an integer below 10^8 to 8 digits (with leading zeros), one per 16-bit lane
+            static __m128i digits(std::uint32_t value) noexcept
+            {
+                // abcdefgh -> abcd, efgh (the reciprocal of 10^4 is exact for 8 digits)
+                const __m128i abcdefgh{_mm_cvtsi32_si128(static_cast<int>(value))};
+                const __m128i abcd{
+                    _mm_srli_epi64(_mm_mul_epu32(abcdefgh, _mm_set1_epi32(static_cast<int>(0xd1b71759))), 45)};
+                const __m128i efgh{_mm_sub_epi32(abcdefgh, _mm_mul_epu32(abcd, _mm_set1_epi32(10'000)))};
+
+                // each half (times 4) in four lanes, divided by 10^3, 10^2, 10^1, and 10^0:
+                // a, ab, abc, abcd, e, ef, efg, efgh
+                const __m128i halves{_mm_slli_epi64(_mm_unpacklo_epi16(abcd, efgh), 2)};
+                const __m128i pairs{_mm_unpacklo_epi16(halves, halves)};
+                const __m128i lanes{_mm_unpacklo_epi32(pairs, pairs)};
+                const __m128i quotients{_mm_mulhi_epu16(
+                    _mm_mulhi_epu16(lanes, _mm_setr_epi16(8389, 5243, 13108, -32768, 8389, 5243, 13108, -32768)),
+                    _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13, -32768, 1 << 7, 1 << 11, 1 << 13, -32768))};
+
+                // each quotient less ten times the one before it: a, b, c, d, e, f, g, h
+                return _mm_sub_epi16(quotients, _mm_slli_epi64(_mm_mullo_epi16(quotients, _mm_set1_epi16(10)), 16));
+            }
+
+            /// @brief format(...) of an integer with more than 8 digits
+            static std::size_t format_vector(std::uint64_t value, bool negative, char8_t *out) noexcept
+            {
+                constexpr std::uint64_t block{10'000'000'000'000'000ull}; // 10^16
+
+                out[0] = u8'-';
+                std::size_t size{negative ? std::size_t{1} : std::size_t{0}};
+                std::size_t zeros{0};
+                const bool  leading{value >= block};
+                if (leading)
+                {
+                    size += format(value / block, false, out + size);
+                    value %= block;
+                }
+
+                const std::uint64_t high{value / 100'000'000};
+                const std::uint64_t low{value % 100'000'000};
+                __m128i             units{_mm_add_epi8(
+                    _mm_packus_epi16(digits(static_cast<std::uint32_t>(high)), digits(static_cast<std::uint32_t>(low))),
+                    _mm_set1_epi8('0'))};
+                if (!leading)
+                {
+                    // the leading zeros of the block are shifted out (the bytes which wrap around to the back are past
+                    // the last digit, so they are ignored)
+                    const int mask{_mm_movemask_epi8(_mm_cmpeq_epi8(units, _mm_set1_epi8('0')))};
+                    zeros = static_cast<std::size_t>(std::countr_zero(~static_cast<unsigned>(mask)));
+                    units = _mm_shuffle_epi8(
+                        units, _mm_add_epi8(
+                                   _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                   _mm_set1_epi8(static_cast<char>(zeros))));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + size), units);
+                return size + 16 - zeros;
+            }
+#endif
+        };
+
+        /// @brief rounds numbers which are not integers to a JSONPrecision
+        ///
+        /// the output is that of std::to_chars(..., std::chars_format::general or fixed, digits), but numbers which
+        /// are doubles are usually rounded without it: the number is scaled by an (exact) power of ten, rounded to an
+        /// integer, and written by JSONIntegerFormatter with the decimal point inserted. The scaling is exact to half
+        /// an ulp, so it only falls back to std::to_chars when the scaled number is too close to halfway between two
+        /// integers to tell which way the exact value rounds (or it does not fit in 52 bits, or %g would write the
+        /// number in scientific notation)
+        struct JSONRoundingFormatter
+        {
+            /// @brief the digits a precision is clamped to: beyond max_digits10, more digits only spell out the
+            /// binary fraction (and every rounded number fits in a small buffer)
+            static constexpr int max_digits{std::numeric_limits<JSONValue::NumberType>::max_digits10};
+
+            /// @brief writes a finite number which is not an integer rounded to a precision (which is not shortest)
+            template <typename Sink>
+            static void write(Sink &sink, JSONValue::NumberType value, JSONPrecision precision)
+            {
+                const bool significant{precision.rounding == JSONRounding::significant};
+                const int  digits{std::clamp(precision.digits, significant ? 1 : 0, max_digits)};
+
+                std::array<char8_t, 64> utf8{};
+                const double            narrow{static_cast<double>(value)};
+                if (static_cast<JSONValue::NumberType>(narrow) == value)
+                {
+                    const std::size_t size{scaled(narrow, significant, digits, utf8.data())};
+                    if (size != 0)
+                    {
+                        sink.write(utf8.data(), size);
+                        return;
+                    }
+                }
+
+                char *const                chars{reinterpret_cast<char *>(utf8.data())};
+                const std::to_chars_result res{std::to_chars(
+                    chars, chars + utf8.size(), value,
+                    significant ? std::chars_format::general : std::chars_format::fixed, digits)};
+                if (res.ec != std::errc{})
+                {
+                    throw std::exception{std::make_error_code(res.ec).message().c_str()};
+                }
+                sink.write(utf8.data(), static_cast<std::size_t>(res.ptr - chars));
+            }
+
+          private:
+            /// @brief rounds a double by scaling it to an integer
+            /// @return the number of units written to out (0 if the number has to be rounded by std::to_chars)
+            static std::size_t scaled(double value, bool significant, int digits, char8_t *out) noexcept
+            {
+                constexpr std::array<double, 16> powers{1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+                int decimals{digits};
+                if (significant)
+                {
+                    // the exponent of the leading digit (found among the exponents %g writes without scientific
+                    // notation); when it is off by one (the bounds are not exact), the digit count of the rounded
+                    // integer is off too, which is checked below
+                    constexpr std::array<double, 26> bounds{1e-4, 1e-3, 1e-2, 1e-1, 1e0,  1e1,  1e2,  1e3,  1e4,
+                                                            1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11, 1e12, 1e13,
+                                                            1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21};
+
+                    const auto bound{std::upper_bound(bounds.begin(), bounds.end(), std::fabs(value))};
+                    const int  exponent{static_cast<int>(bound - bounds.begin()) - 5};
+                    if (exponent < -4 || exponent >= digits)
+                    {
+                        return 0; // %g writes the number in scientific notation
+                    }
+                    decimals = digits - 1 - exponent;
+                }
+                if (decimals >= static_cast<int>(powers.size()))
+                {
+                    return 0;
+                }
+
+                const double magnitude{std::fabs(value) * powers[static_cast<std::size_t>(decimals)]};
+                const double rounded{std::nearbyint(magnitude)};
+                if (magnitude >= 0x1p52 || std::fabs(std::fabs(magnitude - rounded) - 0.5) <= magnitude * 0x1p-50)
+                {
+                    return 0;
+                }
+
+                const std::uint64_t integer{static_cast<std::uint64_t>(rounded)};
+                std::size_t         count{JSONIntegerFormatter::digit_count(integer)};
+                if (significant)
+                {
+                    // P digits, or P + 1 when the number rounds up to a power of ten (which %g writes the same way
+                    // once trailing zeros are removed, unless it no longer has any decimals)
+                    const std::size_t expected{static_cast<std::size_t>(digits)};
+                    const bool        carried{count == expected + 1 && decimals > 0 && rounded == powers[expected]};
+                    if (integer == 0 || (count != expected && !carried))
+                    {
+                        return 0;
+                    }
+                }
+
+                std::array<char8_t, JSONIntegerFormatter::max_size> integral{};
+                count = JSONIntegerFormatter::format(integer, false, integral.data());
+
+                const std::size_t fraction{static_cast<std::size_t>(decimals)};
+                std::size_t       size{0};
+                if (std::signbit(value))
+                {
+                    out[size++] = u8'-';
+                }
+                if (count > fraction)
+                {
+                    std::copy_n(integral.data(), count - fraction, out + size);
+                    size += count - fraction;
+                }
+                else
+                {
+                    out[size++] = u8'0';
+                }
+                if (fraction > 0)
+                {
+                    out[size++] = u8'.';
+                    const std::size_t written{std::min(count, fraction)};
+                    std::fill_n(out + size, fraction - written, u8'0');
+                    size += fraction - written;
+                    std::copy_n(integral.data() + count - written, written, out + size);
+                    size += written;
+                }
+                if (significant)
+                {
+                    // like %g, without trailing zeros (nor a trailing decimal point)
+                    while (fraction > 0 && out[size - 1] == u8'0')
+                    {
+                        --size;
+                    }
+                    if (out[size - 1] == u8'.')
+                    {
+                        --size;
+                    }
+                }
+                return size;
+            }
+        };
+
+        /// @brief the default output format (the format of serialize(...)): a space after each opening bracket and
+        /// before each closing bracket, ", " between elements, and " : " between keys and values
+        ///
+        /// a format is a policy of a JSONWriter: it decides whether members are sorted (sort_keys), how numbers are
+        /// written (number(...)), and the punctuation between the tokens of arrays and objects (open, separator,
+        /// colon, and close). Every decision is made at compile time, so e.g. JSONCompactFormat compiles down to bare
+        /// puts
+        struct JSONDefaultFormat
+        {
+            /// @brief members are written in the iteration order of the object
+            static constexpr bool sort_keys{false};
+
+            /// @brief the size of the longest number written by number(...)
+            static constexpr std::size_t max_number_size{64};
+
+            /// @brief writes a number in its shortest round-trip form: integers below 2^64 are written in full (by
+            /// JSONIntegerFormatter), and numbers which are doubles (i.e. nearly all of them) in the shortest form of
+            /// the double, which is shorter and much faster to find than that of the wider long double
+            /// @throws std::exception if the number is NaN or infinite
+            template <typename Sink> static void number(Sink &sink, JSONValue::NumberType value)
+            {
+                std::array<char8_t, max_number_size> utf8;
+                sink.write(utf8.data(), format_number(value, utf8.data()));
+            }
+
+            /// @brief writes a float in the shortest form of the float (e.g. 0.1f as 0.1 rather than the
+            /// 0.10000000149011612 of the double it widens to), which is how packed float arrays are written
+            /// @throws std::exception if the number is NaN or infinite
+            template <typename Sink> static void number(Sink &sink, float value)
+            {
+                std::array<char8_t, max_number_size> utf8;
+                sink.write(utf8.data(), format_number(value, utf8.data()));
+            }
+
+            /// @brief number(...) into a buffer (so runs of numbers can be formatted straight into a JSONBlockSink)
+            /// @param value the number
+            /// @param out the buffer (at least max_number_size units)
+            /// @return the number of units written
+            /// @throws std::exception if the number is NaN or infinite
+            static std::size_t format_number(JSONValue::NumberType value, char8_t *out)
+            {
+                if (!std::isfinite(value))
+                {
+                    throw std::exception{"[ben::json::JSONDefaultFormat] NaN and infinity can not be serialized"};
+                }
+                if (JSONIntegerFormatter::formattable(value))
+                {
+                    const std::uint64_t magnitude{static_cast<std::uint64_t>(std::fabs(value))};
+                    return JSONIntegerFormatter::format(magnitude, std::signbit(value), out);
+                }
+
+                // std::to_chars writes chars, which may alias the UTF-8 code units (so they are not copied)
+                char *const                chars{reinterpret_cast<char *>(out)};
+                const double               narrow{static_cast<double>(value)};
+                const std::to_chars_result res{
+                    static_cast<JSONValue::NumberType>(narrow) == value
+                        ? std::to_chars(chars, chars + max_number_size, narrow)
+                        : std::to_chars(chars, chars + max_number_size, value)};
+                if (res.ec != std::errc{})
+                {
+                    throw std::exception{std::make_error_code(res.ec).message().c_str()};
+                }
+                return static_cast<std::size_t>(res.ptr - chars);
+            }
+
+            /// @brief number(...) of a float into a buffer
+            /// @throws std::exception if the number is NaN or infinite
+            static std::size_t format_number(float value, char8_t *out)
+            {
+                if (!std::isfinite(value) || JSONIntegerFormatter::formattable(value))
+                {
+                    return format_number(static_cast<JSONValue::NumberType>(value), out);
+                }
+
+                char *const                chars{reinterpret_cast<char *>(out)};
+                const std::to_chars_result res{std::to_chars(chars, chars + max_number_size, value)};
+                if (res.ec != std::errc{})
+                {
+                    throw std::exception{std::make_error_code(res.ec).message().c_str()};
+                }
+                return static_cast<std::size_t>(res.ptr - chars);
+            }
+
+            template <typename Sink> static void open(Sink &sink, char8_t bracket, std::size_t) { sink.put(bracket); }
+
+            template <typename Sink> static void separator(Sink &sink, bool first, std::size_t)
+            {
+                if (!first)
+                {
+                    sink.put(u8',');
+                }
+                sink.put(u8' ');
+            }
+
+            template <typename Sink> static void colon(Sink &sink) { sink.write(u8" : ", 3); }
+
+            template <typename Sink> static void close(Sink &sink, char8_t bracket, bool, std::size_t)
+            {
+                sink.put(u8' ');
+                sink.put(bracket);
+            }
+        };
+
+        /// @brief the compact output format: no whitespace at all
+        struct JSONCompactFormat : JSONDefaultFormat
+        {
+            template <typename Sink> static void separator(Sink &sink, bool first, std::size_t)
+            {
+                if (!first)
+                {
+                    sink.put(u8',');
+                }
+            }
+
+            template <typename Sink> static void colon(Sink &sink) { sink.put(u8':'); }
+
+            template <typename Sink> static void close(Sink &sink, char8_t bracket, bool, std::size_t)
+            {
+                sink.put(bracket);
+            }
+        };
+
+        /// @brief the pretty output format: one element (or member) per line, indented by nesting depth, with ": "
+        /// between keys and values (empty arrays and objects are written as [] and {})
+        ///
+        /// the newline and the indentation are written from a precomputed buffer (a newline followed by spaces) which
+        /// only grows when a deeper level is reached, so every line break is a single write
+        class JSONPrettyFormat : public JSONDefaultFormat
+        {
+          public:
+            /// @brief creates a pretty format
+            /// @param indent_width the number of spaces per nesting level
+            /// @param crlf true to break lines with "\r\n" instead of "\n"
+            explicit JSONPrettyFormat(std::size_t indent_width = 4, bool crlf = false) :
+                width{indent_width}, newline_size{crlf ? std::size_t{2} : std::size_t{1}}
+            {
+                line.assign(crlf ? u8"\r\n" : u8"\n");
+                line.append(width * 8, u8' ');
+            };
+
+            template <typename Sink> void separator(Sink &sink, bool first, std::size_t depth)
+            {
+                if (!first)
+                {
+                    sink.put(u8',');
+                }
+                indent(sink, depth + 1);
+            }
+
+            template <typename Sink> static void colon(Sink &sink) { sink.write(u8": ", 2); }
+
+            template <typename Sink> void close(Sink &sink, char8_t bracket, bool empty, std::size_t depth)
+            {
+                if (!empty)
+                {
+                    indent(sink, depth);
+                }
+                sink.put(bracket);
+            }
+
+          private:
+            std::size_t           width;        ///< the number of spaces per nesting level
+            std::size_t           newline_size; ///< the size of the newline at the front of line
+            JSONValue::StringType line{};       ///< a newline followed by (at least) the deepest indentation so far
+
+            /// @brief breaks the line and indents the next one
+            template <typename Sink> void indent(Sink &sink, std::size_t depth)
+            {
+                const std::size_t size{newline_size + width * depth};
+                if (size > line.size())
+                {
+                    line.append(std::max(size, line.size() * 2) - line.size(), u8' ');
+                }
+                sink.write(line.data(), size);
+            }
+        };
+
+        /// @brief writes JSONValues to a sink in a format
+        ///
+        /// the format is a compile-time policy (see JSONDefaultFormat, JSONCompactFormat, JSONPrettyFormat, and
+        /// JSONCanonicalFormat), so the writer itself makes no formatting decisions at runtime. When the format sorts
+        /// keys, the members of an object are sorted through an array of pointers which is shared by every nesting
+        /// level (so neither keys nor values are copied, and the array is only allocated once per writer)
+        ///
+        /// @tparam Format the output format
+        /// @tparam Sink the type receiving the output (see JSONStringSink)
+        template <typename Format, typename Sink> class JSONWriter
+        {
+          public:
+            /// @brief creates a writer
+            /// @param sink the sink receiving the output
+            /// @param format the format (formats may have state, e.g. an indentation buffer)
+            /// @param utf8 what to do with strings which are not valid UTF-8
+            /// @param ascii_only true to escape every character which is not ASCII (so the output is 7-bit clean)
+            /// @param non_finite what to do with numbers which are NaN or infinite
+            /// @param precision how numbers which are not integers are rounded
+            explicit JSONWriter(
+                Sink &sink, Format format = Format{}, JSONUtf8Mode utf8 = JSONUtf8Mode::reject,
+                bool ascii_only = false, JSONNonFiniteMode non_finite = JSONNonFiniteMode::error,
+                JSONPrecision precision = {}) :
+                sink{sink}, format{std::move(format)}, utf8{utf8}, ascii_only{ascii_only}, non_finite{non_finite},
+                precision{precision} { };
+
+            /// @brief writes a value
+            /// @param value the value to write
+            /// @param depth the nesting depth of the value
+            /// @throws std::exception if the value (or one of its children) can not be written
+            void write(const JSONValue &value, std::size_t depth = 0)
+            {
+                switch (value.type)
+                {
+                case JSONValue::JSONValueType::literal:
+                    write_literal(std::get<JSONValue::LiteralType>(value.value));
+                    break;
+                case JSONValue::JSONValueType::number:
+                    write_number(std::get<JSONValue::NumberType>(value.value));
+                    break;
+                case JSONValue::JSONValueType::string:
+                    write_string(std::get<JSONValue::StringType>(value.value));
+                    break;
+                case JSONValue::JSONValueType::array:
+                    write_array(std::get<JSONValue::ArrayType>(value.value), depth);
+                    break;
+                case JSONValue::JSONValueType::object:
+                    write_object(std::get<JSONValue::ObjectType>(value.value), depth);
+                    break;
+                case JSONValue::JSONValueType::undefined:
+                default:
+                    throw std::exception{"JSONValue::type was 'undefined' -- it can not be serialized!"};
+                }
+            }
+
+            /// @brief writes a number (as null if it is NaN or infinite and the writer allows that), rounded to the
+            /// precision of the writer unless it is an integer
+            /// @throws std::exception if the number is NaN or infinite (and the writer rejects them)
+            void write_number(JSONValue::NumberType number) { write_number(number, precision); }
+
+            /// @brief writes a number rounded to a precision (instead of the precision of the writer)
+            /// @throws std::exception if the number is NaN or infinite (the non-finite mode of the writer still
+            /// applies)
+            void write_number(JSONValue::NumberType number, JSONPrecision rounding)
+            {
+                put_number(sink, number, rounding);
+            }
+
+            /// @brief writes packed numbers (e.g. the data of a std::vector<float> or std::vector<std::int64_t>) as an
+            /// array, without building a JSONValue for each of them; the numbers and their separators are formatted
+            /// into blocks (see JSONBlockSink), and floats are written in the shortest form of the float
+            /// @tparam Number an arithmetic type (other than bool)
+            template <typename Number> void write_numbers(std::span<const Number> numbers, std::size_t depth = 0)
+            {
+                static_assert(
+                    std::is_arithmetic_v<Number> && !std::is_same_v<Number, bool>,
+                    "write_numbers(...) writes arithmetic types");
+
+                format.open(sink, u8'[', depth);
+                JSONBlockSink<Sink> block{sink};
+                for (std::size_t i = 0; i < numbers.size(); ++i)
+                {
+                    format.separator(block, i == 0, depth);
+                    put_batched(block, numbers[i]);
+                }
+                block.flush();
+                format.close(sink, u8']', numbers.empty(), depth);
+            }
+
+            /// @brief writes a literal
+            void write_literal(JSONValue::LiteralType literal)
+            {
+                switch (literal)
+                {
+                case JSONValue::LiteralType::null_v:
+                    sink.write(u8"null", 4);
+                    break;
+                case JSONValue::LiteralType::true_v:
+                    sink.write(u8"true", 4);
+                    break;
+                case JSONValue::LiteralType::false_v:
+                    sink.write(u8"false", 5);
+                    break;
+                default:
+                    throw std::exception{"JSONLiteral had invalid value -- was it empty initialized by accident?"};
+                }
+            }
+
+            /// @brief writes a string (quoted and escaped); runs of characters which need no escaping are written
+            /// at once
+            /// @throws std::exception if the string is not valid UTF-8 (and the writer rejects invalid UTF-8)
+            /// @see JSONStringScanner
+            void write_string(std::u8string_view string)
+            {
+                sink.put(u8'\"');
+                std::size_t run{0};
+                if (ascii_only)
+                {
+                    write_ascii_runs(string, run);
+                    sink.write(string.data() + run, string.size() - run);
+                    sink.put(u8'\"');
+                    return;
+                }
+
+                const std::size_t valid{
+                    utf8 == JSONUtf8Mode::trust ? write_runs<false>(string, run) : write_runs<true>(string, run)};
+                if (valid < string.size())
+                {
+                    write_invalid(string, valid, run);
+                }
+                sink.write(string.data() + run, string.size() - run);
+                sink.put(u8'\"');
+            }
+
+            /// @brief writes a string of UTF-8 code units held as chars (validated like a std::u8string)
+            void write_string(std::string_view string)
+            {
+                // char8_t has the representation of unsigned char, so the chars are viewed rather than copied
+                write_string(std::u8string_view{reinterpret_cast<const char8_t *>(string.data()), string.size()});
+            }
+
+            /// @brief writes a UTF-16 string, transcoded to UTF-8 as it is escaped (see write_wide_string(...))
+            void write_string(std::u16string_view string) { write_wide_string(string); }
+
+            /// @brief writes a UTF-32 string, transcoded to UTF-8 as it is escaped (see write_wide_string(...))
+            void write_string(std::u32string_view string) { write_wide_string(string); }
+
+            /// @brief writes a UTF-16 (or UTF-32, depending on the size of wchar_t) string, transcoded to UTF-8 as it
+            /// is escaped (see write_wide_string(...))
+            void write_string(std::wstring_view string) { write_wide_string(string); }
+
+            /// @brief writes an array (undefined elements are skipped)
+            void write_array(const JSONValue::ArrayType &array, std::size_t depth = 0)
+            {
+                format.open(sink, u8'[', depth);
+                bool first{true};
+                for (std::size_t i = 0; i < array.size(); ++i)
+                {
+                    const JSONValue &element{array[i]};
+                    if (element.type == JSONValue::JSONValueType::number && i + 1 < array.size() &&
+                        array[i + 1].type == JSONValue::JSONValueType::number)
+                    {
+                        i     = write_number_run(array, i, first, depth) - 1;
+                        first = false;
+                    }
+                    else if (element.type != JSONValue::JSONValueType::undefined)
+                    {
+                        format.separator(sink, first, depth);
+                        write(element, depth + 1);
+                        first = false;
+                    }
+                }
+                format.close(sink, u8']', first, depth);
+            }
+
+            /// @brief writes an object (undefined members are skipped)
+            void write_object(const JSONValue::ObjectType &object, std::size_t depth = 0)
+            {
+                format.open(sink, u8'{', depth);
+                bool first{true};
+                if constexpr (Format::sort_keys)
+                {
+                    const std::size_t base{members.size()};
+                    for (const auto &member : object)
+                    {
+                        if (member.second.type != JSONValue::JSONValueType::undefined)
+                        {
+                            members.push_back(&member);
+                        }
+                    }
+                    std::sort(
+                        members.begin() + static_cast<std::ptrdiff_t>(base), members.end(),
+                        [](const Member *lhs, const Member *rhs) { return Format::less(lhs->first, rhs->first); });
+
+                    // nested objects push onto (and may reallocate) the same array, so members are visited by index
+                    const std::size_t end{members.size()};
+                    for (std::size_t i = base; i < end; ++i)
+                    {
+                        write_member(*members[i], first, depth);
+                        first = false;
+                    }
+                    members.resize(base);
+                }
+                else
+                {
+                    for (const auto &member : object)
+                    {
+                        if (member.second.type != JSONValue::JSONValueType::undefined)
+                        {
+                            write_member(member, first, depth);
+                            first = false;
+                        }
+                    }
+                }
+                format.close(sink, u8'}', first, depth);
+            }
+
+          private:
+            using Member = JSONValue::ObjectType::value_type;
+
+            Sink                       &sink;       ///< the sink receiving the output
+            Format                      format;     ///< the output format
+            JSONUtf8Mode                utf8;       ///< what to do with strings which are not valid UTF-8
+            bool                        ascii_only; ///< true to escape every character which is not ASCII
+            JSONNonFiniteMode           non_finite; ///< what to do with numbers which are NaN or infinite
+            JSONPrecision               precision;  ///< how numbers which are not integers are rounded
+            std::vector<const Member *> members{};  ///< the (sorted) members of the objects being written (a stack)
+
+            /// @brief writes the runs of a string between the units which must be escaped, block by block
+            /// @tparam validate false to skip the UTF-8 validation
+            /// @param string the string
+            /// @param run the start of the current run (updated as runs are written)
+            /// @return the size of the string, or the position from which it must be checked unit by unit since it is
+            /// not valid UTF-8 (no unit from there on has been written)
+            template <bool validate> std::size_t write_runs(std::u8string_view string, std::size_t &run)
+            {
+                constexpr std::size_t block_size{JSONStringScanner::block_size};
+
+                JSONStringScanner               scanner{};
+                std::array<char8_t, block_size> last{}; // the last (partial) block, padded with zeros
+                for (std::size_t i = 0; i < string.size(); i += block_size)
+                {
+                    const std::size_t size{std::min(block_size, string.size() - i)};
+                    const char8_t    *block{string.data() + i};
+                    if (size < block_size)
+                    {
+                        std::copy_n(block, size, last.data());
+                        block = last.data();
+                    }
+
+                    JSONStringScanner::Mask escapes{scanner.template scan<validate>(block)};
+                    if (validate && scanner.failed())
+                    {
+                        return JSONStringScanner::sequence_start(string, i);
+                    }
+                    if (size < block_size)
+                    {
+                        escapes &= (JSONStringScanner::Mask{1} << size) - 1; // the padding is not part of the string
+                    }
+
+                    for (; escapes != 0; escapes &= escapes - 1)
+                    {
+                        const std::size_t at{i + static_cast<std::size_t>(std::countr_zero(escapes))};
+                        sink.write(string.data() + run, at - run);
+                        write_escape(string[at]);
+                        run = at + 1;
+                    }
+                }
+                if (validate && scanner.incomplete())
+                {
+                    return JSONStringScanner::sequence_start(string, string.size());
+                }
+                return string.size();
+            }
+
+            /// @brief writes the runs of ASCII characters of a string between the units which must be escaped, block by
+            /// block, and escapes every other character as \uXXXX (or a surrogate pair \uXXXX\uXXXX past U+FFFF)
+            ///
+            /// each sequence is decoded (and so validated) as it is escaped, so the blocks are not validated up front;
+            /// invalid sequences are replaced by \ufffd unless the writer rejects invalid UTF-8
+            /// @param string the string
+            /// @param run the start of the current run (updated as runs are written)
+            /// @throws std::exception if the string is not valid UTF-8 (and the writer rejects invalid UTF-8)
+            void write_ascii_runs(std::u8string_view string, std::size_t &run)
+            {
+                constexpr std::size_t block_size{JSONStringScanner::block_size};
+
+                JSONStringScanner               scanner{};
+                std::array<char8_t, block_size> last{}; // the last (partial) block, padded with zeros
+                for (std::size_t i = 0; i < string.size(); i += block_size)
+                {
+                    const std::size_t size{std::min(block_size, string.size() - i)};
+                    const char8_t    *block{string.data() + i};
+                    if (size < block_size)
+                    {
+                        std::copy_n(block, size, last.data());
+                        block = last.data();
+                    }
+
+                    JSONStringScanner::Mask escapes{scanner.template scan<false, true>(block)};
+                    if (size < block_size)
+                    {
+                        escapes &= (JSONStringScanner::Mask{1} << size) - 1; // the padding is not part of the string
+                    }
+
+                    for (; escapes != 0; escapes &= escapes - 1)
+                    {
+                        // the continuation bytes of a sequence which has been escaped already are skipped
+                        const std::size_t at{i + static_cast<std::size_t>(std::countr_zero(escapes))};
+                        if (at < run)
+                        {
+                            continue;
+                        }
+
+                        sink.write(string.data() + run, at - run);
+                        if (string[at] < 0x80)
+                        {
+                            write_escape(string[at]);
+                            run = at + 1;
+                            continue;
+                        }
+
+                        bool              valid{false};
+                        const std::size_t sequence{JSONStringScanner::sequence_size(string, at, valid)};
+                        if (!valid)
+                        {
+                            if (utf8 == JSONUtf8Mode::reject)
+                            {
+                                throw std::exception{"[ben::json::JSONWriter] a string is not valid UTF-8"};
+                            }
+                            write_unicode_escape(0xfffd);
+                        }
+                        else
+                        {
+                            char32_t code_point{static_cast<char32_t>(string[at] & (0x7f >> sequence))};
+                            for (std::size_t j = 1; j < sequence; ++j)
+                            {
+                                code_point = (code_point << 6) | (string[at + j] & 0x3f);
+                            }
+                            write_unicode_escapes(code_point);
+                        }
+                        run = at + sequence;
+                    }
+                }
+            }
+
+            /// @brief writes a UTF-16 or UTF-32 string (quoted and escaped), transcoding it to UTF-8 in the same pass
+            ///
+            /// blocks of ASCII are narrowed at once and then scanned for escapes like UTF-8 strings; the other blocks
+            /// are transcoded one code point at a time. Unpaired surrogates (and UTF-32 code units past U+10FFFF) can
+            /// not be written as UTF-8, so they are replaced by U+FFFD unless the writer rejects invalid strings
+            /// @throws std::exception if the string is not valid (and the writer rejects invalid strings)
+            template <typename Unit> void write_wide_string(std::basic_string_view<Unit> string)
+            {
+                constexpr std::size_t block_size{JSONTranscoder::block_size};
+                static_assert(block_size == JSONStringScanner::block_size, "blocks are narrowed, then scanned");
+
+                sink.put(u8'\"');
+                JSONStringScanner               scanner{};
+                std::array<char8_t, block_size> ascii{};
+                for (std::size_t at = 0; at < string.size();)
+                {
+                    const std::size_t size{std::min(block_size, string.size() - at)};
+                    if (JSONTranscoder::narrow(string.data() + at, size, ascii.data()))
+                    {
+                        JSONStringScanner::Mask escapes{scanner.template scan<false>(ascii.data())};
+                        if (size < block_size)
+                        {
+                            escapes &= (JSONStringScanner::Mask{1} << size) - 1; // the rest is left from before
+                        }
+
+                        std::size_t run{0};
+                        for (; escapes != 0; escapes &= escapes - 1)
+                        {
+                            const std::size_t i{static_cast<std::size_t>(std::countr_zero(escapes))};
+                            sink.write(ascii.data() + run, i - run);
+                            write_escape(ascii[i]);
+                            run = i + 1;
+                        }
+                        sink.write(ascii.data() + run, size - run);
+                        at += size;
+                        continue;
+                    }
+
+                    // a surrogate pair may end past the block, in which case the next block starts after it
+                    const std::size_t end{at + size};
+                    while (at < end)
+                    {
+                        bool           valid{true};
+                        const char32_t code_point{JSONTranscoder::decode(string, at, valid)};
+                        if (!valid && utf8 == JSONUtf8Mode::reject)
+                        {
+                            throw std::exception{"[ben::json::JSONWriter] a string is not valid UTF-16/UTF-32"};
+                        }
+                        write_code_point(code_point);
+                    }
+                }
+                sink.put(u8'\"');
+            }
+
+            /// @brief writes a code point as UTF-8 (or escaped, if it must be or the writer is ASCII-only)
+            void write_code_point(char32_t code_point)
+            {
+                if (code_point < 0x80)
+                {
+                    const char8_t unit{static_cast<char8_t>(code_point)};
+                    if (JSONStringScanner::must_escape(unit))
+                    {
+                        write_escape(unit);
+                    }
+                    else
+                    {
+                        sink.put(unit);
+                    }
+                }
+                else if (ascii_only)
+                {
+                    write_unicode_escapes(code_point);
+                }
+                else
+                {
+                    std::array<char8_t, 4> encoded{};
+                    sink.write(encoded.data(), JSONTranscoder::encode(code_point, encoded.data()));
+                }
+            }
+
+            /// @brief writes the rest of a string which is not valid UTF-8 unit by unit, rejecting or replacing each
+            /// invalid sequence
+            /// @throws std::exception if the writer rejects invalid UTF-8
+            void write_invalid(std::u8string_view string, std::size_t at, std::size_t &run)
+            {
+                while (at < string.size())
+                {
+                    const char8_t unit{string[at]};
+                    if (unit < 0x80)
+                    {
+                        if (JSONStringScanner::must_escape(unit))
+                        {
+                            sink.write(string.data() + run, at - run);
+                            write_escape(unit);
+                            run = at + 1;
+                        }
+                        ++at;
+                        continue;
+                    }
+
+                    bool              valid{false};
+                    const std::size_t size{JSONStringScanner::sequence_size(string, at, valid)};
+                    if (!valid)
+                    {
+                        if (utf8 == JSONUtf8Mode::reject)
+                        {
+                            throw std::exception{"[ben::json::JSONWriter] a string is not valid UTF-8"};
+                        }
+                        sink.write(string.data() + run, at - run);
+                        sink.write(u8"\uFFFD", 3);
+                        run = at + size;
+                    }
+                    at += size;
+                }
+            }
+
+            /// @brief writes the escape sequence of a unit
+            void write_escape(char8_t unit)
+            {
+                std::array<char8_t, 2> escape{u8'\\', u8'\0'};
+                switch (unit)
+                {
+                case u8'\"':
+                case u8'\\':
+                    escape[1] = unit;
+                    break;
+                case u8'\b':
+                    escape[1] = u8'b';
+                    break;
+                case u8'\f':
+                    escape[1] = u8'f';
+                    break;
+                case u8'\n':
+                    escape[1] = u8'n';
+                    break;
+                case u8'\r':
+                    escape[1] = u8'r';
+                    break;
+                case u8'\t':
+                    escape[1] = u8't';
+                    break;
+                default:
+                    write_unicode_escape(unit);
+                    return;
+                }
+                sink.write(escape.data(), escape.size());
+            }
+
+            /// @brief writes a code point as \uXXXX (or as a surrogate pair \uXXXX\uXXXX past U+FFFF)
+            void write_unicode_escapes(char32_t code_point)
+            {
+                if (code_point >= 0x10000)
+                {
+                    code_point -= 0x10000;
+                    write_unicode_escape(static_cast<char16_t>(0xd800 + (code_point >> 10)));
+                    write_unicode_escape(static_cast<char16_t>(0xdc00 + (code_point & 0x3ff)));
+                    return;
+                }
+                write_unicode_escape(static_cast<char16_t>(code_point));
+            }
+
+            /// @brief writes a UTF-16 code unit as \uXXXX
+            void write_unicode_escape(char16_t unit)
+            {
+                constexpr std::u8string_view digits{u8"0123456789abcdef"};
+
+                const std::array<char8_t, 6> escape{
+                    u8'\\', u8'u', digits[unit >> 12], digits[(unit >> 8) & 0xf], digits[(unit >> 4) & 0xf],
+                    digits[unit & 0xf]};
+                sink.write(escape.data(), escape.size());
+            }
+
+            /// @brief write_number(...) to another sink (e.g. the block of a run of numbers)
+            template <typename Target>
+            void put_number(Target &target, JSONValue::NumberType number, JSONPrecision rounding)
+            {
+                if (!std::isfinite(number) && non_finite == JSONNonFiniteMode::null)
+                {
+                    target.write(u8"null", 4);
+                    return;
+                }
+                if (rounding.rounding == JSONRounding::shortest || !std::isfinite(number) ||
+                    number == std::trunc(number))
+                {
+                    format.number(target, number);
+                    return;
+                }
+                JSONRoundingFormatter::write(target, number, rounding);
+            }
+
+            /// @brief writes a number of a run into its block: formatted in place when the format writes numbers like
+            /// JSONDefaultFormat (and the number is not rounded), otherwise like write_number(...)
+            template <typename Number> void put_batched(JSONBlockSink<Sink> &block, Number number)
+            {
+                if constexpr (std::is_base_of_v<JSONDefaultFormat, Format> && std::is_integral_v<Number>)
+                {
+                    const bool          negative{number < 0};
+                    const std::uint64_t magnitude{
+                        negative ? 0 - static_cast<std::uint64_t>(number) : static_cast<std::uint64_t>(number)};
+                    block.commit(JSONIntegerFormatter::format(
+                        magnitude, negative, block.reserve(JSONIntegerFormatter::max_size)));
+                    return;
+                }
+                else if constexpr (std::is_base_of_v<JSONDefaultFormat, Format>)
+                {
+                    if (std::isfinite(number) &&
+                        (precision.rounding == JSONRounding::shortest || number == std::trunc(number)))
+                    {
+                        // floats keep the shortest form of the float, everything else is formatted as a NumberType
+                        using Formatted =
+                            std::conditional_t<std::is_same_v<Number, float>, float, JSONValue::NumberType>;
+                        char8_t *const out{block.reserve(Format::max_number_size)};
+                        block.commit(Format::format_number(static_cast<Formatted>(number), out));
+                        return;
+                    }
+                }
+                put_number(block, static_cast<JSONValue::NumberType>(number), precision);
+            }
+
+            /// @brief writes the run of numbers of an array which starts at an index into blocks (rather than one or
+            /// two sink writes per number)
+            /// @return the index past the run
+            std::size_t write_number_run(
+                const JSONValue::ArrayType &array, std::size_t at, bool first, std::size_t depth)
+            {
+                JSONBlockSink<Sink> block{sink};
+                for (; at < array.size() && array[at].type == JSONValue::JSONValueType::number; ++at)
+                {
+                    format.separator(block, first, depth);
+                    first = false;
+                    put_batched(block, std::get<JSONValue::NumberType>(array[at].value));
+                }
+                block.flush();
+                return at;
+            }
+
+            void write_member(const Member &member, bool first, std::size_t depth)
+            {
+                format.separator(sink, first, depth);
+                write_string(member.first);
+                format.colon(sink);
+                write(member.second, depth + 1);
+            }
+        };
+
+        //--Templates---------------------------------------------------------------------------------------------------
+
+        /// @brief templated struct which contains information associated with the JSON serialization of a type
+        ///
+        /// for all types T, the struct contains the following information:
+        ///     - JSONSerializationInfo<T>::SerializationFnType; an alias for a pointer to a function accepting a const
+        ///     T& as the single argument which returns a const std::u8string
+        ///     - JSONSerializationInfo<T>::serializable; a static constexpr bool which is true if type T is JSON
+        ///     serializable and false otherwise
+        ///     - JSONSerializationInfo<T>::serializer; a static constexpr function pointer of type
+        ///     JSONSerializationInfo<T>::SerializationFnType (depends on T) which points to the serialization
+        ///     implementation for type T if it exists or nullptr if it does not exist
+        ///     - JSONSerializationInfo<T>::serializer_impl(const T&); a static member function declaration for the
+        ///     implementation of the serialization of type T. If specialized via the helper macro, the
+        ///     JSONSerializationInfo<T>::serializer function pointer is set to the implementation method instead of
+        ///     nullptr
+        ///
+        /// @tparam T the type to get the JSON serialization information of
+        template <typename T> struct JSONSerializationInfo
+        {
+            /// @brief an alias for a pointer to a function matching the type of the serialization implementation for
+            /// this type
+            using SerializationFnType = const std::string (*)(const T &);
+
+            /// @brief a constexpr boolean which is true if type T is JSON serializable and false otherwise
+            static constexpr bool serializable{false};
+
+            /// @brief the default serializer_impl for a generic type returns an empty string; implementations must be
+            /// provided for specializations
+            /// @param val the value of type T to serialize
+            /// @return an empty string (constexpr)
+            static constexpr std::u8string serializer_impl(const T &val) { return std::string{""}; };
+
+            /// @brief a constexpr function pointer to the SerializationFnType for type T which points to the
+            /// serialization implementation or nullptr if the type is not JSON serializable
+            static constexpr SerializationFnType serializer{nullptr};
+        };
+
+        /// @brief helper template which converts to a constexpr bool which is true if
+        /// JSONSerializationInfo<T>::serializable is declared and true, false otherwise
+        /// @tparam T the type to test for JSON serialization capability
+        template <typename T> constexpr bool is_json_serializable_v = JSONSerializationInfo<T>::serializable;
+
+        /// @brief helper template which converts to a constexpr JSONSerializationInfo<T>::SerializationFnType which is
+        /// nullptr if T is not JSON serializable, otherwise if T _is_ JSON serializable the value is the address of the
+        /// serialization implementation for type T
+        /// @tparam T the type to get the JSON serialization implementation function pointer for
+        template <typename T>
+        constexpr JSONSerializationInfo<T>::SerializationFnType json_serializer_v =
+            JSONSerializationInfo<T>::serializer;
+
+        /// @brief helper template which converts to a constexpr bool which is true if type T is not JSON serializable
+        /// directly but a JSONValue can be constructed from T and false otherwise
+        template <typename T>
+        constexpr bool converts_to_json_value_v =
+            (!is_json_serializable_v<T> && !std::is_same_v<JSONValue, T> && std::is_constructible_v<JSONValue, T>);
+
+        /// @brief templated serialization function which is enabled via the second template parameter which depends on
+        /// the type being JSON serializable
+        /// @tparam T the type (which is JSON serializable else the instantiation for T isn't compiled) to serialize
+        /// @tparam serializer the second template parameter which is of type
+        /// JSONSerializationInfo<T>::SerializationFnType which defaults to the json serialization implementation for
+        /// type T
+        /// @param val the value to serialize (passed by const ref)
+        /// @return const u8string containing the result of the serialization implementation for the value of type T
+        /// @note marked noexcept, which is not to say the serialization implementations themselves are not allowed to
+        /// throw; if the implementation throws, the exception (or whatever is thrown) is caught and an empty string is
+        /// returned as the result of serialization
+        template <
+            typename T,
+            std::enable_if_t<is_json_serializable_v<T>, typename JSONSerializationInfo<T>::SerializationFnType>
+                serializer = json_serializer_v<T>>
+        const std::u8string serialize(const T &val) noexcept
+        {
+            std::u8string serialized{u8""};
+
+            try
+            {
+                serialized.append(serializer(val));
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "[ben::json::serialize] Error: " << e.what() << " Returning empty string.\n";
+            }
+            catch (...)
+            {
+                std::cout << "[ben::json::serialize] Error: An unknown error has occured. Returning empty string.\n";
+            }
+
+            return serialized;
+        }
+
+        //--JSONSerializationInfo<JSONValue> Forward Declaration--------------------------------------------------------
+
+        // It is necessary to forward declare the JSONSerializationInfo<JSONValue>::serializer_impl(const JSONValue &)
+        // member function which must exist by the time a JSONValue::JSONArray or JSONValue::JSONObject serialization
+        // definition is provided AND before the conversion serialization template is instantiated (since the conversion
+        // template uses the JSONValue serializer). So, JSONSerializationInfo<JSONValue> is specialized here by hand
+        // rather than with the macro.  Serialization implementation definition provided below other / JSONValue variant
+        // type serialization implementation macro calls.
+
+        bJSON_DECLARE_SERIALIZABLE(JSONValue);
+
+        //--JSON Value ("default") Types Registration-------------------------------------------------------------------
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::LiteralType)
+        {
+            std::u8string serialized{u8""};
+            switch (val)
+            {
+            case JSONValue::LiteralType::null_v:
+                serialized.append(u8"null");
+                break;
+            case JSONValue::LiteralType::true_v:
+                serialized.append(u8"true");
+                break;
+            case JSONValue::LiteralType::false_v:
+                serialized.append(u8"false");
+                break;
+            default:
+                throw std::exception{"JSONLiteral had invalid value -- was it empty initialized by accident?"};
+                break;
+            }
+            return serialized;
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::NumberType)
+        {
+            // written straight into the string (integers by JSONIntegerFormatter, others by std::to_chars)
+            std::u8string  serialized{u8""};
+            JSONStringSink sink{serialized};
+            JSONDefaultFormat::number(sink, val);
+            return serialized;
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::StringType)
+        {
+            // escapes the control characters (as per the JSON specification) and rejects invalid UTF-8
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write_string(val);
+            return serialized;
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::ArrayType)
+        {
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write_array(val);
+            return serialized;
+        };
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONValue::ObjectType)
+        {
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write_object(val);
+            return serialized;
+        }
+
+        inline bJSON_DEFINE_SERIALIZATION(JSONValue)
+        {
+            // the whole tree is written into one string (nested arrays and objects do not build temporaries)
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write(val);
+            return serialized;
+        }
+
+        //--String Types Registration----------------------------------------------------------------------------------
+
+        // other strings are written directly (rather than first being converted to a JSONValue::StringType); UTF-16
+        // and UTF-32 strings are transcoded to UTF-8 as they are escaped
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(std::string_view)
+        {
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write_string(val);
+            return serialized;
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(std::u16string_view)
+        {
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write_string(val);
+            return serialized;
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(std::u32string_view)
+        {
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write_string(val);
+            return serialized;
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(std::wstring_view)
+        {
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write_string(val);
+            return serialized;
+        }
+
+        //--Rounded Numbers---------------------------------------------------------------------------------------------
+
+        /// @brief a number which is serialized rounded to a precision of its own, e.g. for one field of a type whose
+        /// serialization implementation writes it with fewer digits than the others:
+        ///
+        /// serialized.append(serialize(JSONRoundedNumber{val.latitude, {JSONRounding::decimals, 6}}));
+        struct JSONRoundedNumber
+        {
+            JSONValue::NumberType value{0};    ///< the number
+            JSONPrecision         precision{}; ///< the precision it is written with
+        };
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONRoundedNumber)
+        {
+            std::u8string                                 serialized{u8""};
+            JSONStringSink                                sink{serialized};
+            JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+            writer.write_number(val.value, val.precision);
+            return serialized;
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(std::string)
+        {
+            return JSONSerializationInfo<std::string_view>::serializer_impl(val);
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(std::u16string)
+        {
+            return JSONSerializationInfo<std::u16string_view>::serializer_impl(val);
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(std::u32string)
+        {
+            return JSONSerializationInfo<std::u32string_view>::serializer_impl(val);
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(std::wstring)
+        {
+            return JSONSerializationInfo<std::wstring_view>::serializer_impl(val);
+        }
+
+        //--Time Types Registration-------------------------------------------------------------------------------------
+
+        /// @brief formats and parses ISO-8601 (RFC 3339) UTC timestamps, e.g. "2024-02-29T13:45:30.250Z", and
+        /// durations in seconds, e.g. "PT90.5S"
+        ///
+        /// dates are converted to and from days since 1970-01-01 with H. Hinnant's civil calendar algorithms, which
+        /// count years from March (so the leap day is the last day of a year and month lengths follow one formula),
+        /// and the fields are written into a fixed template from the digit-pair table of JSONIntegerFormatter, so a
+        /// timestamp is formatted with a handful of divisions and a single write
+        struct JSONTimeFormatter
+        {
+            static constexpr std::size_t max_size{48}; ///< the size of the longest (quoted) timestamp or duration
+
+            static constexpr std::int64_t min_seconds{-62'167'219'200}; ///< 0000-01-01T00:00:00Z in epoch seconds
+            static constexpr std::int64_t max_seconds{253'402'300'799}; ///< 9999-12-31T23:59:59Z in epoch seconds
+
+            /// @brief the number of fraction digits which shows every tick of a duration (0, 3, 6, or 9)
+            template <typename Duration> static constexpr std::size_t digits_of{
+                std::chrono::treat_as_floating_point_v<typename Duration::rep> ? 9
+                : Duration::period::den == 1                                     ? 0
+                : Duration::period::den <= 1'000     ? 3
+                : Duration::period::den <= 1'000'000 ? 6
+                                                     : 9};
+
+            /// @brief writes a quoted timestamp
+            /// @param seconds the seconds since 1970-01-01T00:00:00Z
+            /// @param nanoseconds the fraction of the second (below 10^9)
+            /// @param digits the number of fraction digits to write (at most 9; the fraction is truncated)
+            /// @param out the buffer (at least max_size units)
+            /// @return the number of units written
+            /// @throws std::exception if the year is not in [0, 9999]
+            static std::size_t format(std::int64_t seconds, std::uint32_t nanoseconds, std::size_t digits, char8_t *out)
+            {
+                // the range is checked before any arithmetic, which could overflow for seconds far outside of it
+                if (seconds < min_seconds || seconds > max_seconds)
+                {
+                    throw std::exception{"[ben::json::JSONTimeFormatter] the year is out of the range of ISO-8601"};
+                }
+                const std::int64_t days{(seconds >= 0 ? seconds : seconds - 86'399) / 86'400};
+                const auto         time{static_cast<std::uint32_t>(seconds - days * 86'400)};
+
+                std::int64_t year{0};
+                unsigned     month{0};
+                unsigned     day{0};
+                civil_from_days(days, year, month, day);
+
+                constexpr std::u8string_view pattern{u8"\"0000-00-00T00:00:00"};
+                std::copy_n(pattern.data(), pattern.size(), out);
+                put_pair(out + 1, static_cast<unsigned>(year / 100));
+                put_pair(out + 3, static_cast<unsigned>(year % 100));
+                put_pair(out + 6, month);
+                put_pair(out + 9, day);
+                put_pair(out + 12, time / 3'600);
+                put_pair(out + 15, time / 60 % 60);
+                put_pair(out + 18, time % 60);
+
+                std::size_t size{pattern.size() + put_fraction(out + pattern.size(), nanoseconds, digits)};
+                out[size++] = u8'Z';
+                out[size++] = u8'\"';
+                return size;
+            }
+
+            /// @brief writes a quoted duration in seconds, e.g. "PT1.500S" or "-PT30S"
+            /// @param seconds the whole seconds of the magnitude of the duration
+            /// @param nanoseconds the fraction of a second of the magnitude (below 10^9)
+            /// @param negative true if the duration is negative
+            /// @param digits the number of fraction digits to write (at most 9; the fraction is truncated)
+            /// @param out the buffer (at least max_size units)
+            /// @return the number of units written
+            static std::size_t format_duration(
+                std::uint64_t seconds, std::uint32_t nanoseconds, bool negative, std::size_t digits,
+                char8_t *out) noexcept
+            {
+                std::size_t size{0};
+                out[size++] = u8'\"';
+                if (negative && (seconds != 0 || nanoseconds != 0))
+                {
+                    out[size++] = u8'-';
+                }
+                out[size++] = u8'P';
+                out[size++] = u8'T';
+                size += JSONIntegerFormatter::format(seconds, false, out + size);
+                size += put_fraction(out + size, nanoseconds, digits);
+                out[size++] = u8'S';
+                out[size++] = u8'\"';
+                return size;
+            }
+
+            /// @brief parses an RFC 3339 timestamp (the content of the string, without quotes): a date, 'T', a time
+            /// with an optional fraction of a second (of any length, truncated to nanoseconds), and 'Z' or an offset
+            /// such as +05:30 (a leap second is read as the first second of the next minute)
+            /// @param text the timestamp
+            /// @param seconds receives the seconds since 1970-01-01T00:00:00Z
+            /// @param nanoseconds receives the fraction of the second
+            /// @return false if the text is not a timestamp (in which case the outputs are unspecified)
+            static bool parse(std::u8string_view text, std::int64_t &seconds, std::uint32_t &nanoseconds) noexcept
+            {
+                unsigned year_high{0}, year_low{0}, month{0}, day{0}, hour{0}, minute{0}, second{0};
+                if (text.size() < 20 || !get_pair(text, 0, year_high) || !get_pair(text, 2, year_low) ||
+                    text[4] != u8'-' || !get_pair(text, 5, month) || text[7] != u8'-' || !get_pair(text, 8, day) ||
+                    (text[10] != u8'T' && text[10] != u8't' && text[10] != u8' ') || !get_pair(text, 11, hour) ||
+                    text[13] != u8':' || !get_pair(text, 14, minute) || text[16] != u8':' ||
+                    !get_pair(text, 17, second))
+                {
+                    return false;
+                }
+
+                const std::int64_t year{year_high * 100 + year_low};
+                if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month) || hour > 23 ||
+                    minute > 59 || second > 60)
+                {
+                    return false;
+                }
+
+                std::size_t at{19};
+                nanoseconds = 0;
+                if (text[at] == u8'.')
+                {
+                    const std::size_t start{++at};
+                    std::uint32_t     scale{100'000'000};
+                    for (; at < text.size() && text[at] >= u8'0' && text[at] <= u8'9'; ++at, scale /= 10)
+                    {
+                        nanoseconds += static_cast<std::uint32_t>(text[at] - u8'0') * scale;
+                    }
+                    if (at == start || at == text.size())
+                    {
+                        return false;
+                    }
+                }
+
+                std::int64_t offset{0};
+                if (text[at] == u8'Z' || text[at] == u8'z')
+                {
+                    ++at;
+                }
+                else if (text[at] == u8'+' || text[at] == u8'-')
+                {
+                    unsigned offset_hours{0}, offset_minutes{0};
+                    if (text.size() - at < 6 || !get_pair(text, at + 1, offset_hours) || text[at + 3] != u8':' ||
+                        !get_pair(text, at + 4, offset_minutes) || offset_hours > 23 || offset_minutes > 59)
+                    {
+                        return false;
+                    }
+                    offset = static_cast<std::int64_t>(offset_hours * 60 + offset_minutes);
+                    offset = text[at] == u8'-' ? -offset : offset;
+                    at += 6;
+                }
+                else
+                {
+                    return false;
+                }
+
+                seconds = days_from_civil(year, month, day) * 86'400 + hour * 3'600 + minute * 60 + second;
+                seconds -= offset * 60;
+                return at == text.size();
+            }
+
+            /// @brief parses a duration written by format_duration(...) (the content of the string, without quotes)
+            /// @param text the duration, e.g. "PT1.5S" or "-PT30S"
+            /// @param seconds receives the whole seconds of the magnitude of the duration
+            /// @param nanoseconds receives the fraction of a second of the magnitude
+            /// @param negative receives true if the duration is negative
+            /// @return false if the text is not such a duration
+            static bool parse_duration(
+                std::u8string_view text, std::uint64_t &seconds, std::uint32_t &nanoseconds, bool &negative) noexcept
+            {
+                negative = !text.empty() && text[0] == u8'-';
+                text.remove_prefix(negative ? 1 : 0);
+                if (text.size() < 4 || text[0] != u8'P' || text[1] != u8'T' || text.back() != u8'S')
+                {
+                    return false;
+                }
+                text = text.substr(2, text.size() - 3);
+
+                const char *const            chars{reinterpret_cast<const char *>(text.data())};
+                const std::from_chars_result res{std::from_chars(chars, chars + text.size(), seconds)};
+                if (res.ec != std::errc{} || res.ptr == chars)
+                {
+                    return false;
+                }
+
+                nanoseconds = 0;
+                std::size_t at{static_cast<std::size_t>(res.ptr - chars)};
+                if (at < text.size() && text[at] == u8'.')
+                {
+                    const std::size_t start{++at};
+                    std::uint32_t     scale{100'000'000};
+                    for (; at < text.size() && text[at] >= u8'0' && text[at] <= u8'9'; ++at, scale /= 10)
+                    {
+                        nanoseconds += static_cast<std::uint32_t>(text[at] - u8'0') * scale;
+                    }
+                    if (at == start)
+                    {
+                        return false;
+                    }
+                }
+                return at == text.size();
+            }
+
+            /// @brief the days since 1970-01-01 of a date (in the proleptic Gregorian calendar)
+            static std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day) noexcept
+            {
+                year -= month <= 2 ? 1 : 0;
+                const std::int64_t era{(year >= 0 ? year : year - 399) / 400};
+                const auto         year_of_era{static_cast<unsigned>(year - era * 400)};
+                const unsigned     day_of_year{(153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1};
+                const unsigned     day_of_era{year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year};
+                return era * 146'097 + static_cast<std::int64_t>(day_of_era) - 719'468;
+            }
+
+            /// @brief the date of a number of days since 1970-01-01 (in the proleptic Gregorian calendar)
+            static void civil_from_days(std::int64_t days, std::int64_t &year, unsigned &month, unsigned &day) noexcept
+            {
+                days += 719'468;
+                const std::int64_t era{(days >= 0 ? days : days - 146'096) / 146'097};
+                const auto         day_of_era{static_cast<unsigned>(days - era * 146'097)};
+                const unsigned     year_of_era{
+                    (day_of_era - day_of_era / 1'460 + day_of_era / 36'524 - day_of_era / 146'096) / 365};
+                const unsigned day_of_year{day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100)};
+                const unsigned shifted_month{(5 * day_of_year + 2) / 153}; // from March
+                day   = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+                month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+                year  = static_cast<std::int64_t>(year_of_era) + era * 400 + (month <= 2 ? 1 : 0);
+            }
+
+          private:
+            static unsigned days_in_month(std::int64_t year, unsigned month) noexcept
+            {
+                if (month == 2)
+                {
+                    return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+                }
+                return month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31;
+            }
+
+            static void put_pair(char8_t *out, unsigned value) noexcept
+            {
+                out[0] = JSONIntegerFormatter::pairs[value * 2];
+                out[1] = JSONIntegerFormatter::pairs[value * 2 + 1];
+            }
+
+            /// @brief writes '.' and the first digits of a fraction of a second (nothing if digits is 0)
+            static std::size_t put_fraction(char8_t *out, std::uint32_t nanoseconds, std::size_t digits) noexcept
+            {
+                if (digits == 0)
+                {
+                    return 0;
+                }
+                std::array<char8_t, 10> fraction;
+                put_pair(fraction.data(), nanoseconds / 10'000'000);
+                put_pair(fraction.data() + 2, nanoseconds / 100'000 % 100);
+                put_pair(fraction.data() + 4, nanoseconds / 1'000 % 100);
+                put_pair(fraction.data() + 6, nanoseconds / 10 % 100);
+                fraction[8] = static_cast<char8_t>(u8'0' + nanoseconds % 10);
+
+                digits = std::min<std::size_t>(digits, 9);
+                out[0] = u8'.';
+                std::copy_n(fraction.data(), digits, out + 1);
+                return digits + 1;
+            }
+
+            static bool get_pair(std::u8string_view text, std::size_t at, unsigned &out) noexcept
+            {
+                const unsigned high{static_cast<unsigned>(text[at] - u8'0')};
+                const unsigned low{static_cast<unsigned>(text[at + 1] - u8'0')};
+                out = high * 10 + low;
+                return high < 10 && low < 10;
+            }
+        };
+
+        /// @brief how a JSONTimestamp is written
+        enum struct JSONTimeStyle
+        {
+            iso8601,            ///< a quoted RFC 3339 UTC timestamp, e.g. "2024-02-29T13:45:30.250Z"
+            epoch_seconds,      ///< the whole seconds since 1970-01-01T00:00:00Z (an integer)
+            epoch_milliseconds, ///< the whole milliseconds since 1970-01-01T00:00:00Z (an integer)
+            epoch_microseconds, ///< the whole microseconds since 1970-01-01T00:00:00Z (an integer)
+            epoch_nanoseconds,  ///< the nanoseconds since 1970-01-01T00:00:00Z (an integer)
+        };
+
+        /// @brief a time point which is serialized in a style (and precision) of its own, e.g. for one field of a
+        /// type's serialization implementation:
+        ///
+        /// serialized.append(serialize(JSONTimestamp{val.created, JSONTimeStyle::epoch_milliseconds}));
+        class JSONTimestamp
+        {
+          public:
+            /// @brief creates a timestamp
+            /// @param time the time point (of the system clock)
+            /// @param style how the time point is written
+            /// @param digits the number of fraction digits of iso8601 timestamps (at most 9; by default enough for
+            /// every tick of the time point's duration)
+            template <typename Duration>
+            JSONTimestamp(
+                std::chrono::sys_time<Duration> time, JSONTimeStyle style = JSONTimeStyle::iso8601,
+                std::size_t digits = JSONTimeFormatter::digits_of<Duration>) :
+                style{style}, digits{digits}
+            {
+                // truncated rather than floored, so that the whole seconds never exceed the time point in magnitude
+                // (converting them back to Duration can not overflow); negative fractions are borrowed from below
+                const auto whole{std::chrono::time_point_cast<std::chrono::seconds>(time)};
+                const auto fraction{std::chrono::duration_cast<std::chrono::nanoseconds>(time - whole)};
+                seconds     = whole.time_since_epoch().count() - (fraction.count() < 0 ? 1 : 0);
+                nanoseconds = static_cast<std::uint32_t>(fraction.count() < 0 ? fraction.count() + 1'000'000'000
+                                                                              : fraction.count());
+            };
+
+            /// @brief writes the timestamp into a buffer
+            /// @param out the buffer (at least JSONTimeFormatter::max_size units)
+            /// @return the number of units written
+            /// @throws std::exception if the timestamp can not be written in its style (e.g. a year after 9999)
+            std::size_t format(char8_t *out) const
+            {
+                std::int64_t scale{1};
+                switch (style)
+                {
+                case JSONTimeStyle::epoch_seconds:
+                    break;
+                case JSONTimeStyle::epoch_milliseconds:
+                    scale = 1'000;
+                    break;
+                case JSONTimeStyle::epoch_microseconds:
+                    scale = 1'000'000;
+                    break;
+                case JSONTimeStyle::epoch_nanoseconds:
+                    scale = 1'000'000'000;
+                    break;
+                case JSONTimeStyle::iso8601:
+                default:
+                    return JSONTimeFormatter::format(seconds, nanoseconds, digits, out);
+                }
+
+                if (seconds > std::numeric_limits<std::int64_t>::max() / scale - 1 ||
+                    seconds < std::numeric_limits<std::int64_t>::min() / scale + 1)
+                {
+                    throw std::exception{"[ben::json::JSONTimestamp] the time point is out of range of the epoch unit"};
+                }
+                const std::int64_t  ticks{seconds * scale + nanoseconds / (1'000'000'000 / scale)};
+                const std::uint64_t bits{static_cast<std::uint64_t>(ticks)};
+                return JSONIntegerFormatter::format(ticks < 0 ? 0 - bits : bits, ticks < 0, out);
+            }
+
+          private:
+            std::int64_t  seconds{0};     ///< the (floored) seconds since 1970-01-01T00:00:00Z
+            std::uint32_t nanoseconds{0}; ///< the fraction of the second
+            JSONTimeStyle style;          ///< how the time point is written
+            std::size_t   digits;         ///< the number of fraction digits of iso8601 timestamps
+        };
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONTimestamp)
+        {
+            std::array<char8_t, JSONTimeFormatter::max_size> utf8;
+            return std::u8string{utf8.data(), val.format(utf8.data())};
+        }
+
+        // time points of the system clock (e.g. std::chrono::system_clock::now()) are written as ISO-8601 UTC
+        // timestamps with enough fraction digits for their duration, and durations as ISO-8601 durations in seconds;
+        // both are templates, so JSONSerializationInfo is specialized by hand rather than with the macro
+
+        template <typename Duration> struct JSONSerializationInfo<std::chrono::sys_time<Duration>>
+        {
+            using SerializationFnType = const std::u8string (*)(const std::chrono::sys_time<Duration> &);
+            static constexpr bool serializable{true};
+
+            static const std::u8string serializer_impl(const std::chrono::sys_time<Duration> &val)
+            {
+                return JSONSerializationInfo<JSONTimestamp>::serializer_impl(JSONTimestamp{val});
+            }
+
+            static constexpr SerializationFnType serializer{&serializer_impl};
+        };
+
+        template <typename Rep, typename Period> struct JSONSerializationInfo<std::chrono::duration<Rep, Period>>
+        {
+            using Duration            = std::chrono::duration<Rep, Period>;
+            using SerializationFnType = const std::u8string (*)(const Duration &);
+            static constexpr bool serializable{true};
+
+            static const std::u8string serializer_impl(const Duration &val)
+            {
+                const bool    negative{val < Duration::zero()};
+                std::uint64_t seconds{0};
+                std::uint32_t nanoseconds{0};
+                if constexpr (std::chrono::treat_as_floating_point_v<Rep>)
+                {
+                    const Duration magnitude{negative ? -val : val};
+                    const auto     whole{std::chrono::floor<std::chrono::seconds>(magnitude)};
+                    seconds     = static_cast<std::uint64_t>(whole.count());
+                    nanoseconds = static_cast<std::uint32_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(magnitude - whole).count());
+                }
+                else
+                {
+                    // the magnitude is taken in the unsigned type of the ticks (negating Duration::min() overflows)
+                    using Unsigned  = std::make_unsigned_t<Rep>;
+                    using Magnitude = std::chrono::duration<Unsigned, Period>;
+                    const Unsigned  ticks{static_cast<Unsigned>(val.count())};
+                    const Magnitude magnitude{negative ? static_cast<Unsigned>(Unsigned{0} - ticks) : ticks};
+                    if constexpr (Period::den == 1 && Period::num > 1)
+                    {
+                        if (magnitude.count() > std::numeric_limits<std::uint64_t>::max() / Period::num)
+                        {
+                            throw std::exception{"[ben::json::JSONTimeFormatter] the duration is out of range"};
+                        }
+                    }
+                    const auto whole{std::chrono::duration_cast<std::chrono::duration<std::uint64_t>>(magnitude)};
+                    seconds     = whole.count();
+                    nanoseconds = static_cast<std::uint32_t>(
+                        std::chrono::duration_cast<std::chrono::duration<std::uint64_t, std::nano>>(magnitude - whole)
+                            .count());
+                }
+
+                std::array<char8_t, JSONTimeFormatter::max_size> utf8;
+                const std::size_t size{JSONTimeFormatter::format_duration(
+                    seconds, nanoseconds, negative, JSONTimeFormatter::digits_of<Duration>, utf8.data())};
+                return std::u8string{utf8.data(), size};
+            }
+
+            static constexpr SerializationFnType serializer{&serializer_impl};
+        };
+
+        /// @brief parses an RFC 3339 timestamp (see JSONTimeFormatter::parse(...)) into a time point
+        /// @param text the timestamp (the content of a JSON string, without quotes)
+        /// @param out receives the time point, floored to its duration (left as it was if the text is not a
+        /// timestamp)
+        /// @return false if the text is not a timestamp
+        template <typename Duration>
+        bool parse_timestamp(std::u8string_view text, std::chrono::sys_time<Duration> &out) noexcept
+        {
+            std::int64_t  seconds{0};
+            std::uint32_t nanoseconds{0};
+            if (!JSONTimeFormatter::parse(text, seconds, nanoseconds))
+            {
+                return false;
+            }
+            out = std::chrono::sys_time<Duration>{
+                std::chrono::floor<Duration>(std::chrono::seconds{seconds}) +
+                std::chrono::floor<Duration>(std::chrono::nanoseconds{nanoseconds})};
+            return true;
+        }
+
+        /// @brief parses an ISO-8601 duration in seconds (as written by the duration serializers, e.g. "PT1.5S")
+        /// @param text the duration (the content of a JSON string, without quotes)
+        /// @param out receives the duration, truncated to its period (left as it was if the text is not a duration)
+        /// @return false if the text is not a duration in seconds
+        template <typename Rep, typename Period>
+        bool parse_duration(std::u8string_view text, std::chrono::duration<Rep, Period> &out) noexcept
+        {
+            using Duration = std::chrono::duration<Rep, Period>;
+
+            std::uint64_t seconds{0};
+            std::uint32_t nanoseconds{0};
+            bool          negative{false};
+            if (!JSONTimeFormatter::parse_duration(text, seconds, nanoseconds, negative))
+            {
+                return false;
+            }
+            const Duration magnitude{
+                std::chrono::duration_cast<Duration>(std::chrono::seconds{static_cast<std::int64_t>(seconds)}) +
+                std::chrono::duration_cast<Duration>(std::chrono::nanoseconds{nanoseconds})};
+            out = negative ? -magnitude : magnitude;
+            return true;
+        }
+
+        //--Binary Types Registration-----------------------------------------------------------------------------------
+
+        /// @brief encodes and decodes base64 (RFC 4648, with padding), the usual form of binary data in JSON
+        ///
+        /// the alphabet needs no escaping, so encoded data is written into the output without being scanned. With
+        /// SSE4.1 (see bJSON_SIMD_SSE4; AVX2 builds use the same kernels), 12 bytes are encoded into 16 characters at
+        /// a time: the bytes are shuffled into place, the 6-bit indices are split out with two multiplications, and
+        /// the characters are found with a shuffle from a table of offsets (W. Muła's algorithm). Decoding reverses
+        /// it, 16 characters at a time, and validates the characters with two more table shuffles; other builds and
+        /// the ends of the data use a 256-entry table
+        struct JSONBase64
+        {
+            /// @brief the size of the encoding of a number of bytes
+            static constexpr std::size_t encoded_size(std::size_t size) noexcept { return (size + 2) / 3 * 4; }
+
+            /// @brief encodes bytes
+            /// @param in the bytes
+            /// @param size the number of bytes
+            /// @param out the buffer (at least encoded_size(size) units)
+            static void encode(const std::uint8_t *in, std::size_t size, char8_t *out) noexcept
+            {
+                std::size_t i{0};
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+                // the kernel reads 16 bytes (of which it encodes 12)
+                for (; i + 16 <= size; i += 12, out += 16)
+                {
+                    _mm_storeu_si128(
+                        reinterpret_cast<__m128i *>(out),
+                        encode_block(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i))));
+                }
+#endif
+                for (; i + 3 <= size; i += 3, out += 4)
+                {
+                    const std::uint32_t bits{
+                        static_cast<std::uint32_t>(in[i]) << 16 | static_cast<std::uint32_t>(in[i + 1]) << 8 |
+                        in[i + 2]};
+                    out[0] = alphabet[bits >> 18];
+                    out[1] = alphabet[bits >> 12 & 0x3f];
+                    out[2] = alphabet[bits >> 6 & 0x3f];
+                    out[3] = alphabet[bits & 0x3f];
+                }
+                if (i < size)
+                {
+                    const std::uint32_t bits{
+                        static_cast<std::uint32_t>(in[i]) << 16 |
+                        (i + 1 < size ? static_cast<std::uint32_t>(in[i + 1]) << 8 : 0)};
+                    out[0] = alphabet[bits >> 18];
+                    out[1] = alphabet[bits >> 12 & 0x3f];
+                    out[2] = i + 1 < size ? alphabet[bits >> 6 & 0x3f] : u8'=';
+                    out[3] = u8'=';
+                }
+            }
+
+            /// @brief decodes base64 text
+            /// @param in the text (its size must be a multiple of 4, with '=' padding the last group)
+            /// @param size the size of the text
+            /// @param out the buffer (at least size / 4 * 3 bytes)
+            /// @return the number of bytes decoded, or std::string::npos if the text is not base64
+            static std::size_t decode(const char8_t *in, std::size_t size, std::uint8_t *out) noexcept
+            {
+                if (size % 4 != 0)
+                {
+                    return std::string::npos;
+                }
+
+                std::size_t i{0};
+                std::size_t written{0};
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+                // the kernel writes 16 bytes (of which 12 are decoded), so it stops 8 characters short of the end
+                for (; i + 24 <= size; i += 16, written += 12)
+                {
+                    bool          valid{true};
+                    const __m128i bytes{
+                        decode_block(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), valid)};
+                    if (!valid)
+                    {
+                        return std::string::npos;
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + written), bytes);
+                }
+#endif
+                // the 6-bit values of the characters of the alphabet (0xff for the other characters)
+                constexpr std::array<std::uint8_t, 256> values{[] {
+                    std::array<std::uint8_t, 256> table{};
+                    table.fill(0xff);
+                    for (std::size_t i = 0; i < alphabet.size(); ++i)
+                    {
+                        table[alphabet[i]] = static_cast<std::uint8_t>(i);
+                    }
+                    return table;
+                }()};
+                for (; i < size; i += 4)
+                {
+                    const bool          last{i + 4 == size};
+                    const std::size_t   padding{last ? (in[i + 3] == u8'=' ? (in[i + 2] == u8'=' ? 2u : 1u) : 0u) : 0u};
+                    const std::uint32_t a{values[in[i]]};
+                    const std::uint32_t b{values[in[i + 1]]};
+                    const std::uint32_t c{padding > 1 ? 0u : values[in[i + 2]]};
+                    const std::uint32_t d{padding > 0 ? 0u : values[in[i + 3]]};
+                    if ((a | b | c | d) > 0x3f)
+                    {
+                        return std::string::npos;
+                    }
+
+                    const std::uint32_t bits{a << 18 | b << 12 | c << 6 | d};
+                    out[written++] = static_cast<std::uint8_t>(bits >> 16);
+                    if (padding < 2)
+                    {
+                        out[written++] = static_cast<std::uint8_t>(bits >> 8);
+                    }
+                    if (padding < 1)
+                    {
+                        out[written++] = static_cast<std::uint8_t>(bits);
+                    }
+                    else if ((padding == 1 ? (bits & 0xff) : (bits & 0xffff)) != 0)
+                    {
+                        return std::string::npos; // the bits past the last byte must be 0 (so encodings are unique)
+                    }
+                }
+                return written;
+            }
+
+          private:
+            /// @brief the characters of the 6-bit values
+            static constexpr std::u8string_view alphabet{
+                u8"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+
+#if defined(bJSON_SIMD_AVX2) || defined(bJSON_SIMD_SSE4)
+            /// @brief encodes the first 12 of 16 bytes into 16 characters
+            static __m128i encode_block(__m128i in) noexcept
+            {
+                // each 32-bit lane holds 3 bytes (b1, b0, b2, b1 order), split into four 6-bit indices
+                in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+                const __m128i high{_mm_mulhi_epu16(
+                    _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040))};
+                const __m128i low{_mm_mullo_epi16(
+                    _mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010))};
+                const __m128i indices{_mm_or_si128(high, low)};
+
+                // the offset from each index to its character, by range: A-Z (0-25), a-z (26-51), 0-9 (52-61), '+'
+                // (62), and '/' (63)
+                __m128i ranges{_mm_subs_epu8(indices, _mm_set1_epi8(51))};
+                ranges = _mm_or_si128(
+                    ranges, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+                const __m128i offsets{_mm_setr_epi8(
+                    'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0)};
+                return _mm_add_epi8(_mm_shuffle_epi8(offsets, ranges), indices);
+            }
+
+            /// @brief decodes 16 characters into 12 bytes (the last 4 bytes of the result are 0)
+            /// @param valid set to false if a character is not in the alphabet
+            static __m128i decode_block(__m128i in, bool &valid) noexcept
+            {
+                // a character is valid if the bit of its high nibble is set in the mask of its low nibble
+                const __m128i high_nibbles{_mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f))};
+                const __m128i low_nibbles{_mm_and_si128(in, _mm_set1_epi8(0x0f))};
+                const __m128i masks{_mm_shuffle_epi8(
+                    _mm_setr_epi8(
+                        static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                        static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                        static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                        static_cast<char>(0xf8), static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54),
+                    low_nibbles)};
+                const __m128i bits{_mm_shuffle_epi8(
+                    _mm_setr_epi8(
+                        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0),
+                    high_nibbles)};
+                valid = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(masks, bits), _mm_setzero_si128())) == 0;
+
+                // the offset from each character to its value, by high nibble ('/' shares the nibble of '+')
+                const __m128i shifts{_mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0)};
+                const __m128i offsets{_mm_blendv_epi8(
+                    _mm_shuffle_epi8(shifts, high_nibbles), _mm_set1_epi8(16), _mm_cmpeq_epi8(in, _mm_set1_epi8('/')))};
+                const __m128i values{_mm_add_epi8(in, offsets)};
+
+                // 4 values of 6 bits -> 3 bytes, per 32-bit lane
+                const __m128i pairs{_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140))};
+                const __m128i lanes{_mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000))};
+                return _mm_shuffle_epi8(lanes, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            }
+#endif
+        };
+
+        /// @brief binary data (e.g. an image or a digest) which is serialized as a base64 string; the bytes are
+        /// viewed rather than copied, and encoded straight into the serialized string:
+        ///
+        /// serialized.append(serialize(JSONBlob{val.thumbnail}));
+        class JSONBlob
+        {
+          public:
+            /// @brief creates a blob
+            /// @param data the bytes (which must outlive the blob)
+            /// @param size the number of bytes
+            JSONBlob(const void *data, std::size_t size) noexcept :
+                bytes{static_cast<const std::uint8_t *>(data)}, count{size} { };
+
+            /// @brief creates a blob of a contiguous container of single bytes (e.g. std::vector<std::uint8_t>,
+            /// std::string, or std::span<const std::byte>)
+            template <
+                typename Bytes,
+                std::enable_if_t<sizeof(*std::data(std::declval<const Bytes &>())) == 1, bool> enabled = true>
+            JSONBlob(const Bytes &data) noexcept : JSONBlob(std::data(data), std::size(data)) { };
+
+            /// @brief the bytes
+            const std::uint8_t *data() const noexcept { return bytes; }
+
+            /// @brief the number of bytes
+            std::size_t size() const noexcept { return count; }
+
+          private:
+            const std::uint8_t *bytes; ///< the bytes
+            std::size_t         count; ///< the number of bytes
+        };
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONBlob)
+        {
+            std::u8string serialized(JSONBase64::encoded_size(val.size()) + 2, u8'\"');
+            JSONBase64::encode(val.data(), val.size(), serialized.data() + 1);
+            return serialized;
+        }
+
+        /// @brief decodes base64 text (e.g. a serialized JSONBlob) into bytes
+        /// @param text the text (the content of a JSON string, without quotes)
+        /// @param out receives the bytes (a resizable container of single bytes, e.g. std::vector<std::uint8_t> or
+        /// std::string; left as it was if the text is not base64)
+        /// @return false if the text is not (padded) base64
+        template <typename Bytes> bool decode_base64(std::u8string_view text, Bytes &out)
+        {
+            Bytes decoded{};
+            decoded.resize(text.size() / 4 * 3);
+            const std::size_t size{JSONBase64::decode(
+                text.data(), text.size(), reinterpret_cast<std::uint8_t *>(std::data(decoded)))};
+            if (size == std::string::npos)
+            {
+                return false;
+            }
+            decoded.resize(size);
+            out = std::move(decoded);
+            return true;
+        }
+
+        //--Enum Types Registration-------------------------------------------------------------------------------------
+
+        /// @brief the enumerators of an enum registered with bJSON_ENUM(...), which specializes this template with:
+        ///     - JSONEnumNames<T>::values; a constexpr std::array of the enumerators
+        ///     - JSONEnumNames<T>::list; the names of the enumerators, as written in the macro ("a, b, c")
+        /// @tparam T the enum
+        template <typename T> struct JSONEnumNames;
+
+        /// @brief helper template which converts to a constexpr bool which is true if T was registered with
+        /// bJSON_ENUM(...)
+        template <typename T, typename = void> constexpr bool is_json_enum_v = false;
+        template <typename T> constexpr bool is_json_enum_v<T, std::void_t<decltype(JSONEnumNames<T>::values)>> = true;
+
+        /// @brief builds the tables of JSONEnumTable<T> at compile time
+        struct JSONEnumBuilder
+        {
+            /// @brief the maximum number of displacements tried for a bucket of the perfect hash
+            static constexpr std::uint32_t max_seed{1u << 16};
+
+            /// @brief a seeded FNV-1a hash of a name (mixed so that its low bits can be masked)
+            static constexpr std::uint32_t hash(std::u8string_view name, std::uint32_t seed) noexcept
+            {
+                std::uint32_t hash{2166136261u ^ seed * 0x9e3779b9u};
+                for (const char8_t unit : name)
+                {
+                    hash = (hash ^ unit) * 16777619u;
+                }
+                return hash ^ hash >> 15;
+            }
+
+            /// @brief splits the names in a macro's argument list ("a, b, c")
+            template <std::size_t N> static constexpr std::array<std::string_view, N> split(std::string_view list)
+            {
+                std::array<std::string_view, N> names{};
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    const std::size_t comma{std::min(list.find(','), list.size())};
+                    std::string_view  name{list.substr(0, comma)};
+                    while (!name.empty() && (name.front() == ' ' || name.front() == '\t'))
+                    {
+                        name.remove_prefix(1);
+                    }
+                    while (!name.empty() && (name.back() == ' ' || name.back() == '\t'))
+                    {
+                        name.remove_suffix(1);
+                    }
+                    names[i] = name;
+                    list.remove_prefix(std::min(comma + 1, list.size()));
+                }
+                return names;
+            }
+
+            /// @brief the number of slots of a perfect hash of a number of names (a power of two)
+            static constexpr std::size_t slot_count(std::size_t count) noexcept { return std::bit_ceil(count); }
+        };
+
+        /// @brief the constexpr tables of an enum registered with bJSON_ENUM(...)
+        ///
+        /// the names are stored pre-quoted and back to back (enumerator names never need escaping), so serializing a
+        /// value is an index into the table and one copy: the index is the value's distance from the first enumerator
+        /// when the enumerators are contiguous (and found by binary search when they are not). Names are read back
+        /// through a perfect hash built by "hash and displace": the names are bucketed by one hash, and each bucket
+        /// gets the seed of a second hash which places its names in free slots, so a lookup is two hashes and one
+        /// comparison
+        ///
+        /// @tparam T the enum
+        template <typename T> struct JSONEnumTable
+        {
+          private:
+            using Names      = JSONEnumNames<T>;
+            using Underlying = std::underlying_type_t<T>;
+
+            /// @brief the number of enumerators
+            static constexpr std::size_t count{Names::values.size()};
+
+            /// @brief the number of slots of the perfect hash
+            static constexpr std::size_t slot_count{JSONEnumBuilder::slot_count(count)};
+
+            /// @brief the (unquoted) names of the enumerators
+            static constexpr std::array<std::string_view, count> names{JSONEnumBuilder::split<count>(Names::list)};
+
+            /// @brief true if the values of the enumerators are those of the first one plus their index
+            static constexpr bool contiguous{[] {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (static_cast<Underlying>(Names::values[i]) !=
+                        static_cast<Underlying>(static_cast<Underlying>(Names::values[0]) + i))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }()};
+
+            /// @brief the offsets of the quoted names in the text (and the size of the text, last)
+            static constexpr std::array<std::uint32_t, count + 1> offsets{[] {
+                std::array<std::uint32_t, count + 1> offsets{};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    offsets[i + 1] = static_cast<std::uint32_t>(offsets[i] + names[i].size() + 2);
+                }
+                return offsets;
+            }()};
+
+            /// @brief the quoted names, back to back
+            static constexpr std::array<char8_t, offsets[count]> text{[] {
+                std::array<char8_t, offsets[count]> text{};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    std::size_t at{offsets[i]};
+                    text[at++] = u8'\"';
+                    for (const char unit : names[i])
+                    {
+                        text[at++] = static_cast<char8_t>(unit);
+                    }
+                    text[at] = u8'\"';
+                }
+                return text;
+            }()};
+
+            /// @brief the (value, index) pairs of the enumerators, sorted by value (for non-contiguous enumerators)
+            static constexpr std::array<std::pair<Underlying, std::size_t>, count> sorted{[] {
+                std::array<std::pair<Underlying, std::size_t>, count> sorted{};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    sorted[i] = {static_cast<Underlying>(Names::values[i]), i};
+                }
+                std::sort(sorted.begin(), sorted.end()); // (aliases are found by their first index)
+                return sorted;
+            }()};
+
+            /// @brief the perfect hash: a seed per bucket, then the index of the name in each slot (count if empty)
+            struct PerfectHash
+            {
+                std::array<std::uint32_t, count>      seeds{};
+                std::array<std::uint32_t, slot_count> slots{};
+                bool                                  valid{true};
+            };
+
+            static constexpr PerfectHash perfect_hash{[] {
+                PerfectHash hash{};
+                hash.slots.fill(static_cast<std::uint32_t>(count));
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t j = i + 1; j < count; ++j)
+                    {
+                        if (names[i] == names[j])
+                        {
+                            hash.valid = false;
+                            return hash;
+                        }
+                    }
+                }
+
+                // the names in the text (as UTF-8, like the text they are looked up by)
+                const auto key{[](std::size_t i) {
+                    return std::u8string_view{text.data() + offsets[i] + 1, names[i].size()};
+                }};
+
+                // buckets are placed largest first, while the most slots are free
+                std::array<std::uint32_t, count> buckets{};
+                std::array<std::uint32_t, count> sizes{};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    buckets[i] = static_cast<std::uint32_t>(JSONEnumBuilder::hash(key(i), 0) % count);
+                    ++sizes[buckets[i]];
+                }
+                std::array<std::uint32_t, count> order{};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    order[i] = static_cast<std::uint32_t>(i);
+                }
+                std::sort(order.begin(), order.end(), [&](std::uint32_t lhs, std::uint32_t rhs) {
+                    return sizes[lhs] != sizes[rhs] ? sizes[lhs] > sizes[rhs] : lhs < rhs;
+                });
+
+                for (const std::uint32_t bucket : order)
+                {
+                    if (sizes[bucket] == 0)
+                    {
+                        break;
+                    }
+                    bool placed{false};
+                    for (std::uint32_t seed = 1; seed < JSONEnumBuilder::max_seed && !placed; ++seed)
+                    {
+                        auto slots{hash.slots};
+                        placed = true;
+                        for (std::size_t i = 0; i < count && placed; ++i)
+                        {
+                            if (buckets[i] == bucket)
+                            {
+                                auto &slot{slots[JSONEnumBuilder::hash(key(i), seed) & (slots.size() - 1)]};
+                                placed = slot == count;
+                                slot   = static_cast<std::uint32_t>(i);
+                            }
+                        }
+                        if (placed)
+                        {
+                            hash.seeds[bucket] = seed;
+                            hash.slots         = slots;
+                        }
+                    }
+                    hash.valid = hash.valid && placed;
+                }
+                return hash;
+            }()};
+
+          public:
+            /// @brief false if a name is listed twice (or, in theory, if no perfect hash was found)
+            static constexpr bool valid{perfect_hash.valid};
+
+            /// @brief the index of an enumerator in the list
+            /// @return the index, or the number of enumerators if the value is not one of them
+            static constexpr std::size_t index(T value) noexcept
+            {
+                const Underlying bits{static_cast<Underlying>(value)};
+                if constexpr (contiguous)
+                {
+                    // unsigned, so values before the first enumerator wrap past the end
+                    const auto offset{static_cast<std::make_unsigned_t<Underlying>>(
+                        static_cast<std::make_unsigned_t<Underlying>>(bits) -
+                        static_cast<std::make_unsigned_t<Underlying>>(Names::values[0]))};
+                    return offset < count ? offset : count;
+                }
+                else
+                {
+                    const auto found{std::lower_bound(
+                        sorted.begin(), sorted.end(), bits,
+                        [](const auto &pair, Underlying bits) { return pair.first < bits; })};
+                    return found != sorted.end() && found->first == bits ? found->second : count;
+                }
+            }
+
+            /// @brief the name of the enumerator at an index of the list (unquoted)
+            static constexpr std::u8string_view name(std::size_t index) noexcept
+            {
+                return {text.data() + offsets[index] + 1, offsets[index + 1] - offsets[index] - 2};
+            }
+
+            /// @brief the name of a value, quoted (empty if the value is not an enumerator)
+            static constexpr std::u8string_view quoted(T value) noexcept
+            {
+                const std::size_t at{index(value)};
+                return at == count ? std::u8string_view{}
+                                   : std::u8string_view{text.data() + offsets[at], offsets[at + 1] - offsets[at]};
+            }
+
+            /// @brief serializes a value as its quoted name
+            /// @throws std::exception if the value is not an enumerator
+            static std::u8string serialize(T value)
+            {
+                std::u8string out{};
+                write(out, value);
+                return out;
+            }
+
+            /// @brief appends the quoted name of a value (copied straight from the table)
+            /// @throws std::exception if the value is not an enumerator
+            static void write(std::u8string &out, T value)
+            {
+                const std::u8string_view name{quoted(value)};
+                if (name.empty())
+                {
+                    throw std::exception{"[ben::json::JSONEnumTable] the value is not a registered enumerator"};
+                }
+                out.append(name);
+            }
+
+            /// @brief finds the enumerator of a name
+            /// @param text the name (the content of a JSON string, without quotes)
+            /// @param out receives the enumerator (left as it was if the name is not one)
+            /// @return false if the text is not the name of an enumerator
+            static constexpr bool parse(std::u8string_view text, T &out) noexcept
+            {
+                const std::size_t   bucket{JSONEnumBuilder::hash(text, 0) % count};
+                const std::uint32_t at{
+                    perfect_hash.slots[JSONEnumBuilder::hash(text, perfect_hash.seeds[bucket]) & (slot_count - 1)]};
+                if (at == count || name(at) != text)
+                {
+                    return false;
+                }
+                out = Names::values[at];
+                return true;
+            }
+        };
+
+        /// @brief reads the name of an enumerator (of an enum registered with bJSON_ENUM(...)) back into its value
+        /// @param text the name (the content of a JSON string, without quotes)
+        /// @param out receives the enumerator (left as it was if the text is not the name of one)
+        /// @return false if the text is not the name of an enumerator
+        template <typename T> constexpr bool parse_enum(std::u8string_view text, T &out) noexcept
+        {
+            return JSONEnumTable<T>::parse(text, out);
+        }
+
+        //--Aggregate Types Registration--------------------------------------------------------------------------------
+
+        /// @brief the members of an aggregate registered with bJSON_AGGREGATE(...), which specializes this template
+        /// with JSONAggregateNames<T>::list; the names of the members, as written in the macro ("a, b, c")
+        /// @tparam T the aggregate
+        template <typename T> struct JSONAggregateNames;
+
+        template <typename T> struct JSONAggregateTable;
+
+        /// @brief helper template which converts to a constexpr bool which is true if T was registered with
+        /// bJSON_AGGREGATE(...)
+        template <typename T, typename = void> constexpr bool is_json_aggregate_v = false;
+        template <typename T>
+        constexpr bool is_json_aggregate_v<T, std::void_t<decltype(JSONAggregateNames<T>::list)>> = true;
+
+        /// @brief decomposes aggregates at compile time: the number of members is found by trying to initialize the
+        /// aggregate with more and more values (of a type which converts to anything), and the members are bound
+        /// with structured bindings of that size (up to max_members)
+        struct JSONAggregateBuilder
+        {
+            /// @brief the largest number of members an aggregate can be decomposed into
+            static constexpr std::size_t max_members{32};
+
+            /// @brief a value which converts to the type of any member (only used in unevaluated contexts)
+            struct AnyMember
+            {
+                template <typename Member> operator Member() const noexcept;
+            };
+
+            /// @brief true if T can be initialized with as many values as Indices has
+            template <typename T, typename Indices, typename = void> struct initializable : std::false_type
+            {
+            };
+
+            template <typename T, std::size_t... Indices>
+            struct initializable<
+                T, std::index_sequence<Indices...>, std::void_t<decltype(T{(void(Indices), AnyMember{})...})>> :
+                std::true_type
+            {
+            };
+
+            /// @brief the number of members of an aggregate (of an aggregate with no base classes, whose members are
+            /// not C arrays)
+            template <typename T, std::size_t Count = 0> static constexpr std::size_t member_count() noexcept
+            {
+                if constexpr (Count < max_members + 1 && initializable<T, std::make_index_sequence<Count + 1>>::value)
+                {
+                    return member_count<T, Count + 1>();
+                }
+                else
+                {
+                    return Count;
+                }
+            }
+
+            /// @brief the number of names in a macro's argument list ("a, b, c")
+            static constexpr std::size_t name_count(std::string_view list) noexcept
+            {
+                if (list.find_first_not_of(" \t") == std::string_view::npos)
+                {
+                    return 0;
+                }
+                return static_cast<std::size_t>(std::count(list.begin(), list.end(), ',')) + 1;
+            }
+
+            /// @brief calls a visitor with (const references to) every member of an aggregate, in order
+            /// @tparam Count the number of members of the aggregate
+            template <std::size_t Count, typename T, typename Visitor>
+            static constexpr void decompose(const T &value, Visitor &&visitor)
+            {
+                static_assert(
+                    Count <= max_members, "[ben::json::JSONAggregateBuilder] the aggregate has too many members");
+                if constexpr (Count == 0)
+                {
+                    visitor();
+                }
+                else if constexpr (Count == 1)
+                {
+                    const auto &[f0] = value;
+                    visitor(f0);
+                }
+                else if constexpr (Count == 2)
+                {
+                    const auto &[f0, f1] = value;
+                    visitor(f0, f1);
+                }
+                else if constexpr (Count == 3)
+                {
+                    const auto &[f0, f1, f2] = value;
+                    visitor(f0, f1, f2);
+                }
+                else if constexpr (Count == 4)
+                {
+                    const auto &[f0, f1, f2, f3] = value;
+                    visitor(f0, f1, f2, f3);
+                }
+                else if constexpr (Count == 5)
+                {
+                    const auto &[f0, f1, f2, f3, f4] = value;
+                    visitor(f0, f1, f2, f3, f4);
+                }
+                else if constexpr (Count == 6)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5] = value;
+                    visitor(f0, f1, f2, f3, f4, f5);
+                }
+                else if constexpr (Count == 7)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6);
+                }
+                else if constexpr (Count == 8)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7);
+                }
+                else if constexpr (Count == 9)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+                }
+                else if constexpr (Count == 10)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+                }
+                else if constexpr (Count == 11)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+                }
+                else if constexpr (Count == 12)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+                }
+                else if constexpr (Count == 13)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+                }
+                else if constexpr (Count == 14)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+                }
+                else if constexpr (Count == 15)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+                }
+                else if constexpr (Count == 16)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+                }
+                else if constexpr (Count == 17)
+                {
+                    const auto &[f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16);
+                }
+                else if constexpr (Count == 18)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17);
+                }
+                else if constexpr (Count == 19)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18);
+                }
+                else if constexpr (Count == 20)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19] = value;
+                    visitor(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19);
+                }
+                else if constexpr (Count == 21)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20);
+                }
+                else if constexpr (Count == 22)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21);
+                }
+                else if constexpr (Count == 23)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22);
+                }
+                else if constexpr (Count == 24)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23);
+                }
+                else if constexpr (Count == 25)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23, f24] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24);
+                }
+                else if constexpr (Count == 26)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23, f24, f25] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25);
+                }
+                else if constexpr (Count == 27)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23, f24, f25, f26] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26);
+                }
+                else if constexpr (Count == 28)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23, f24, f25, f26, f27] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27);
+                }
+                else if constexpr (Count == 29)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23, f24, f25, f26, f27, f28] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27, f28);
+                }
+                else if constexpr (Count == 30)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27, f28, f29);
+                }
+                else if constexpr (Count == 31)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27, f28, f29, f30);
+                }
+                else if constexpr (Count == 32)
+                {
+                    const auto &[
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18,
+                        f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31] = value;
+                    visitor(
+                        f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31);
+                }
+            }
+        };
+
+        /// @brief writes the members of registered aggregates straight into one string: numbers, booleans, strings,
+        /// blobs, registered enums, and registered aggregates are written in place, and other serializable members
+        /// through their serialization implementations (which may throw, failing the serialization of the whole
+        /// aggregate)
+        struct JSONMemberWriter
+        {
+            template <typename Member> static void write(std::u8string &out, const Member &member)
+            {
+                if constexpr (std::is_same_v<Member, bool>)
+                {
+                    member ? out.append(u8"true", 4) : out.append(u8"false", 5);
+                }
+                else if constexpr (std::is_integral_v<Member>)
+                {
+                    std::array<char8_t, JSONIntegerFormatter::max_size> utf8;
+                    const bool                                          negative{member < 0};
+                    const std::uint64_t                                 magnitude{
+                        negative ? 0 - static_cast<std::uint64_t>(member) : static_cast<std::uint64_t>(member)};
+                    out.append(utf8.data(), JSONIntegerFormatter::format(magnitude, negative, utf8.data()));
+                }
+                else if constexpr (std::is_floating_point_v<Member>)
+                {
+                    using Formatted = std::conditional_t<std::is_same_v<Member, float>, float, JSONValue::NumberType>;
+                    std::array<char8_t, JSONDefaultFormat::max_number_size> utf8;
+                    out.append(
+                        utf8.data(), JSONDefaultFormat::format_number(static_cast<Formatted>(member), utf8.data()));
+                }
+                else if constexpr (
+                    std::is_same_v<Member, JSONValue::StringType> || std::is_same_v<Member, std::u8string_view>)
+                {
+                    JSONStringSink                                sink{out};
+                    JSONWriter<JSONDefaultFormat, JSONStringSink> writer{sink};
+                    writer.write_string(member);
+                }
+                else if constexpr (std::is_same_v<Member, JSONBlob>)
+                {
+                    const std::size_t at{out.size()};
+                    out.resize(at + JSONBase64::encoded_size(member.size()) + 2, u8'\"');
+                    JSONBase64::encode(member.data(), member.size(), out.data() + at + 1);
+                }
+                else if constexpr (is_json_enum_v<Member>)
+                {
+                    JSONEnumTable<Member>::write(out, member);
+                }
+                else if constexpr (is_json_aggregate_v<Member>)
+                {
+                    JSONAggregateTable<Member>::write(out, member);
+                }
+                else if constexpr (is_json_serializable_v<Member>)
+                {
+                    out.append(JSONSerializationInfo<Member>::serializer_impl(member));
+                }
+                else
+                {
+                    static_assert(
+                        converts_to_json_value_v<Member>,
+                        "[ben::json::JSONMemberWriter] a member of the aggregate is not JSON serializable");
+                    out.append(JSONSerializationInfo<JSONValue>::serializer_impl(JSONValue{member}));
+                }
+            }
+        };
+
+        /// @brief the constexpr tables and the writer of an aggregate registered with bJSON_AGGREGATE(...)
+        ///
+        /// every key is written as part of a constant fragment which also holds the punctuation around it (e.g. ',
+        /// "name" : '), and the members are bound with structured bindings and written by a fold over their indices,
+        /// so the writer of an aggregate is one inlined sequence of appends with no dispatch per member. The output
+        /// is in the format of JSONDefaultFormat, like the serialization of a JSONValue object
+        ///
+        /// @tparam T the aggregate
+        template <typename T> struct JSONAggregateTable
+        {
+          private:
+            using Names = JSONAggregateNames<T>;
+
+            /// @brief the number of members (as named in the macro)
+            static constexpr std::size_t count{JSONAggregateBuilder::name_count(Names::list)};
+
+            /// @brief the names of the members
+            static constexpr std::array<std::string_view, count> names{JSONEnumBuilder::split<count>(Names::list)};
+
+            /// @brief the offsets of the fragments in the text: one before each member, then the closing fragment
+            static constexpr std::array<std::uint32_t, count + 2> offsets{[] {
+                std::array<std::uint32_t, count + 2> offsets{};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    offsets[i + 1] = static_cast<std::uint32_t>(offsets[i] + names[i].size() + 7); // '{ "' and '" : '
+                }
+                offsets[count + 1] = offsets[count] + (count == 0 ? 3 : 2);
+                return offsets;
+            }()};
+
+            /// @brief the fragments, back to back
+            static constexpr std::array<char8_t, offsets[count + 1]> text{[] {
+                std::array<char8_t, offsets[count + 1]> text{};
+                std::size_t                             at{0};
+                const auto put{[&](std::string_view units) {
+                    for (const char unit : units)
+                    {
+                        text[at++] = static_cast<char8_t>(unit);
+                    }
+                }};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    put(i == 0 ? "{ \"" : ", \"");
+                    put(names[i]);
+                    put("\" : ");
+                }
+                put(count == 0 ? "{ }" : " }");
+                return text;
+            }()};
+
+            /// @brief the fragment at an index
+            static constexpr std::u8string_view fragment(std::size_t index) noexcept
+            {
+                return {text.data() + offsets[index], offsets[index + 1] - offsets[index]};
+            }
+
+            template <std::size_t... Indices, typename... Members>
+            static void write_members(std::u8string &out, std::index_sequence<Indices...>, const Members &...members)
+            {
+                ((out.append(fragment(Indices)), JSONMemberWriter::write(out, members)), ...);
+            }
+
+          public:
+            /// @brief true if the macro names every member of the aggregate
+            static constexpr bool valid{
+                std::is_aggregate_v<T> && JSONAggregateBuilder::member_count<T>() == count};
+
+            /// @brief writes an aggregate as an object
+            /// @param out the string to append to
+            /// @param value the aggregate
+            /// @throws std::exception if a member can not be serialized
+            static void write(std::u8string &out, const T &value)
+            {
+                // (an invalid list fails the macro's static_assert, so it is not decomposed as well)
+                if constexpr (valid)
+                {
+                    JSONAggregateBuilder::decompose<count>(value, [&out](const auto &...members) {
+                        write_members(out, std::index_sequence_for<decltype(members)...>{}, members...);
+                    });
+                    out.append(fragment(count));
+                }
+            }
+
+            /// @brief serializes an aggregate as an object
+            /// @throws std::exception if a member can not be serialized
+            static std::u8string serialize(const T &value)
+            {
+                std::u8string serialized{u8""};
+                serialized.reserve(text.size() + count * 8);
+                write(serialized, value);
+                return serialized;
+            }
+        };
+
+        //--Converts to JSONValue Type
+        // Template-------------------------------------------------------------------------
+
+        /// @brief templated serialization function which is enabled via the second template parameter which depends
+        /// on the type not being JSON serializable itself, but serializable via conversion to a JSONValue
+        /// @tparam T the type (which is NOT JSON serializable but CAN be used to construct a JSONValue) to
+        /// serialize
+        /// @tparam enabled the second template parameter which is of type bool and defaults to true, only present
+        /// when enable_if_t<> evaluates to true which happens when T is not directly serializable but can be
+        /// converted to a JSONValue
+        /// @param val the value to serialize (passed by forwarding reference)
+        /// @return (constexpr) const string containing the result of the serialization implementation for the value
+        /// of type T
+        /// @see ben::json::serialize<ben::json::JSONValue>(const ben::json::JSONValue & val)
+        template <typename T, std::enable_if_t<converts_to_json_value_v<T>, bool> enabled = true>
+        const std::u8string serialize(T &&val) noexcept
+        {
+            return serialize(JSONValue{std::forward<T>(val)});
+        }
+
+        //--JSON Hashing------------------------------------------------------------------------------------------------
+
+        /// @brief a 128-bit structural hash (two independently seeded 64-bit hashes)
+        struct JSONHash128
+        {
+            std::uint64_t low{0};  ///< the low 64 bits
+            std::uint64_t high{0}; ///< the high 64 bits
+
+            /// @brief hashes are compared member-wise
+            constexpr bool operator==(const JSONHash128 &) const noexcept = default;
+        };
+
+        /// @brief stable (i.e. not randomized per process) hashing primitives used for structural hashing of JSONValues
+        ///
+        /// an instance of JSONHasher is a streaming hasher over bytes: update(...) may be called any number of times
+        /// and the result only depends on the concatenation of the bytes, so hashing in pieces matches hashing at once
+        ///
+        /// the static hash_value(...) function hashes a JSONValue structurally:
+        ///     - +0 and -0 hash the same (they compare equal)
+        ///     - array elements are combined in order
+        ///     - object members are combined order-independently (so equal objects hash the same regardless of the
+        ///     iteration order of the underlying unordered_map), and undefined members are skipped
+        class JSONHasher
+        {
+          public:
+            /// @brief the seed used by ben::json::hash(...) (and the only seed whose hashes are cached in JSONValues)
+            static constexpr std::uint64_t default_seed{0x9e3779b97f4a7c15ull};
+
+            /// @brief the seed of the high 64 bits of ben::json::hash128(...)
+            static constexpr std::uint64_t high_seed{0xc2b2ae3d27d4eb4full};
+
+            //--JSONHasher Ctors----------------------------------------------------------------------------------------
+
+            /// @brief starts a new streaming hash
+            /// @param seed the seed of the hash
+            explicit constexpr JSONHasher(std::uint64_t seed = default_seed) noexcept : state{seed} { };
+
+            //--JSONHasher Streaming------------------------------------------------------------------------------------
+
+            /// @brief hashes more bytes
+            /// @param data the bytes to hash
+            /// @param size the number of bytes to hash
+            void update(const void *data, std::size_t size) noexcept
+            {
+                const unsigned char *bytes{static_cast<const unsigned char *>(data)};
+                length += size;
+
+                // top up a partially filled word first...
+                while (pending_size != 0 && size != 0)
+                {
+                    pending |= static_cast<std::uint64_t>(*bytes++) << (8 * pending_size);
+                    --size;
+                    if (++pending_size == 8)
+                    {
+                        state        = mix(state ^ pending);
+                        pending      = 0;
+                        pending_size = 0;
+                    }
+                }
+
+                // ...then consume whole (little endian) words...
+                for (; size >= 8; size -= 8, bytes += 8)
+                {
+                    state = mix(state ^ load_word(bytes));
+                }
+
+                // ...and keep whatever is left for later
+                for (; size != 0; --size)
+                {
+                    pending |= static_cast<std::uint64_t>(*bytes++) << (8 * pending_size++);
+                }
+            }
+
+            /// @brief the hash of every byte passed to update(...) so far
+            /// @return the hash (never 0)
+            std::uint64_t finish() const noexcept
+            {
+                const std::uint64_t h{mix(state ^ pending ^ mix(length))};
+                return h ? h : 1;
+            }
+
+            //--JSONHasher Static Helpers-------------------------------------------------------------------------------
+
+            /// @brief loads 8 bytes as a little endian word, whatever the byte order of the host (so hashes are the
+            /// same everywhere, as the partial words kept by update(...) are)
+            static std::uint64_t load_word(const unsigned char *bytes) noexcept
+            {
+                std::uint64_t word{0};
+                if constexpr (std::endian::native == std::endian::little)
+                {
+                    std::memcpy(&word, bytes, 8);
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < 8; ++i)
+                    {
+                        word |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+                    }
+                }
+                return word;
+            }
+
+            /// @brief the splitmix64 finalizer
+            static constexpr std::uint64_t mix(std::uint64_t x) noexcept
+            {
+                x ^= x >> 30;
+                x *= 0xbf58476d1ce4e5b9ull;
+                x ^= x >> 27;
+                x *= 0x94d049bb133111ebull;
+                x ^= x >> 31;
+                return x;
+            }
+
+            /// @brief hashes a sequence of bytes at once
+            static std::uint64_t hash_bytes(const void *data, std::size_t size, std::uint64_t seed = default_seed)
+            {
+                JSONHasher hasher{seed};
+                hasher.update(data, size);
+                return hasher.finish();
+            }
+
+            /// @brief hashes a number such that numbers which compare equal hash the same
+            static std::uint64_t hash_number(JSONValue::NumberType number, std::uint64_t seed = default_seed) noexcept
+            {
+                if (number == 0)
+                {
+                    return mix(seed ^ 0x200); // +0 and -0 are equal
+                }
+                if (!std::isfinite(number))
+                {
+                    // frexp(...) returns these unchanged, and converting them to an integer is undefined
+                    return mix(seed ^ (std::isnan(number) ? 0x300 : number < 0 ? 0x401 : 0x400));
+                }
+
+                // the (at most 64 bit) mantissa and the exponent represent the value exactly for double and for
+                // extended precision long doubles
+                int                         exponent{0};
+                const JSONValue::NumberType mantissa{std::frexp(number < 0 ? -number : number, &exponent)};
+                const std::uint64_t         bits{static_cast<std::uint64_t>(std::ldexp(mantissa, 64))};
+                return mix(mix(bits ^ seed) ^ (static_cast<std::uint64_t>(exponent) << 1) ^ (number < 0 ? 1 : 0));
+            }
+
+            //--JSONHasher Structural Steps-----------------------------------------------------------------------------
+
+            // the steps hash_value(...) is made of, exposed so that values which are only seen as a stream of events
+            // (e.g. by the schema validator) hash exactly like the equivalent JSONValue
+
+            /// @brief hashes a literal
+            static constexpr std::uint64_t hash_literal(JSONValue::LiteralType literal, std::uint64_t seed) noexcept
+            {
+                return finalize(mix(seed ^ (0x100 + static_cast<std::uint64_t>(literal))));
+            }
+
+            /// @brief hashes a string
+            static std::uint64_t hash_string(std::u8string_view string, std::uint64_t seed)
+            {
+                return finalize(mix(hash_bytes(string.data(), string.size(), seed) ^ 0x300));
+            }
+
+            /// @brief the initial state of an array hash
+            static constexpr std::uint64_t array_begin(std::uint64_t seed) noexcept { return mix(seed ^ 0x400); }
+
+            /// @brief adds the hash of the next element to an array hash
+            static constexpr std::uint64_t array_next(std::uint64_t h, std::uint64_t element) noexcept
+            {
+                return mix(h * 31 + element);
+            }
+
+            /// @brief the final array hash
+            static constexpr std::uint64_t array_end(std::uint64_t h, std::uint64_t size) noexcept
+            {
+                return finalize(mix(h ^ size));
+            }
+
+            /// @brief adds a (defined) member to an (order-independent) object hash
+            /// @param sum the object hash so far (starts at 0)
+            /// @param key the hash of the key, i.e. hash_bytes(key.data(), key.size(), seed)
+            /// @param member the hash of the member value
+            static constexpr std::uint64_t object_next(std::uint64_t sum, std::uint64_t key, std::uint64_t member)
+            {
+                return sum + mix(key ^ (member * 0x9e3779b97f4a7c15ull));
+            }
+
+            /// @brief the final object hash
+            static constexpr std::uint64_t object_end(std::uint64_t sum, std::uint64_t count, std::uint64_t seed)
+            {
+                return finalize(mix(sum ^ mix(seed ^ 0x500 ^ count)));
+            }
+
+            /// @brief maps 0 (which marks "no cached hash") to 1
+            static constexpr std::uint64_t finalize(std::uint64_t h) noexcept { return h ? h : 1; }
+
+            /// @brief a memo for hash_value(...) which does not memoize anything
+            struct NoMemo
+            {
+                bool lookup(const JSONValue &, std::uint64_t &) const noexcept { return false; }
+                void store(const JSONValue &, std::uint64_t) const noexcept { }
+            };
+
+            /// @brief a memo for hash_value(...) which reads (and optionally writes) the hashes cached in JSONValues
+            struct NodeCacheMemo
+            {
+                bool write{false}; ///< true if computed hashes are stored in the JSONValues
+
+                bool lookup(const JSONValue &value, std::uint64_t &h) const noexcept
+                {
+                    h = value.hash_cache;
+                    return h != 0;
+                }
+
+                void store(const JSONValue &value, std::uint64_t h) const noexcept
+                {
+                    if (write)
+                    {
+                        value.hash_cache = h;
+                    }
+                }
+            };
+
+            /// @brief hashes a JSONValue structurally
+            /// @tparam Memo a type providing bool lookup(const JSONValue &, std::uint64_t &) and void store(const
+            /// JSONValue &, std::uint64_t) which is consulted for every node (e.g. to reuse cached hashes)
+            /// @param value the JSONValue to hash
+            /// @param seed the seed of the hash
+            /// @param memo the memo to consult/fill
+            /// @return the hash (never 0)
+            template <typename Memo>
+            static std::uint64_t hash_value(const JSONValue &value, std::uint64_t seed, Memo &memo)
+            {
+                std::uint64_t h{0};
+                if (memo.lookup(value, h))
+                {
+                    return h;
+                }
+
+                switch (value.type)
+                {
+                case JSONValue::JSONValueType::literal:
+                    h = hash_literal(std::get<JSONValue::LiteralType>(value.value), seed);
+                    break;
+                case JSONValue::JSONValueType::number:
+                    h = finalize(hash_number(std::get<JSONValue::NumberType>(value.value), seed));
+                    break;
+                case JSONValue::JSONValueType::string:
+                    h = hash_string(std::get<JSONValue::StringType>(value.value), seed);
+                    break;
+                case JSONValue::JSONValueType::array: {
+                    const auto &array{std::get<JSONValue::ArrayType>(value.value)};
+                    h = array_begin(seed);
+                    for (const auto &element : array)
+                    {
+                        h = array_next(h, hash_value(element, seed, memo));
+                    }
+                    h = array_end(h, array.size());
+                    break;
+                }
+                case JSONValue::JSONValueType::object: {
+                    std::uint64_t sum{0};
+                    std::uint64_t count{0};
+                    for (const auto &[key, member] : std::get<JSONValue::ObjectType>(value.value))
+                    {
+                        if (member.type != JSONValue::JSONValueType::undefined)
+                        {
+                            const std::uint64_t key_hash{hash_bytes(key.data(), key.size(), seed)};
+                            sum = object_next(sum, key_hash, hash_value(member, seed, memo));
+                            ++count;
+                        }
+                    }
+                    h = object_end(sum, count, seed);
+                    break;
+                }
+                case JSONValue::JSONValueType::undefined:
+                default:
+                    h = finalize(mix(seed));
+                    break;
+                }
+
+                memo.store(value, h);
+                return h;
+            }
+
+          private:
+            //--JSONHasher Member Variables-----------------------------------------------------------------------------
+
+            std::uint64_t state{default_seed}; ///< the hash of the whole words consumed so far
+            std::uint64_t length{0};           ///< the number of bytes consumed so far
+            std::uint64_t pending{0};          ///< the bytes of a partially filled word
+            std::size_t   pending_size{0};     ///< the number of bytes in pending
+        };
+
+        /// @brief computes the (64-bit) structural hash of a JSONValue
+        ///
+        /// hashes cached in the JSONValue (or any of its children) by cache_hash(...) are reused, but nothing is cached
+        ///
+        /// @param value the JSONValue to hash
+        /// @return the structural hash; JSONValues which compare equal have equal hashes
+        inline std::uint64_t hash(const JSONValue &value)
+        {
+            JSONHasher::NodeCacheMemo memo{.write = false};
+            return JSONHasher::hash_value(value, JSONHasher::default_seed, memo);
+        }
+
+        /// @brief computes the (64-bit) structural hash of a JSONValue and caches it in every node along the way
+        ///
+        /// subsequent calls to hash(...), cache_hash(...), and operator== reuse the cached hashes
+        ///
+        /// @param value the JSONValue to hash
+        /// @return the structural hash
+        /// @remark the cache lives in the (mutable) JSONValue::hash_cache members; caching the hash of a document which
+        /// is read by several threads at once is a data race, so cache hashes before sharing a document
+        inline std::uint64_t cache_hash(const JSONValue &value)
+        {
+            JSONHasher::NodeCacheMemo memo{.write = true};
+            return JSONHasher::hash_value(value, JSONHasher::default_seed, memo);
+        }
+
+        /// @brief drops the hash cached in a JSONValue
+        ///
+        /// must be called for a JSONValue which is mutated directly (and for each of its ancestors) once its hash has
+        /// been cached
+        ///
+        /// @param value the JSONValue whose cached hash is no longer valid
+        inline void invalidate_hash(const JSONValue &value) noexcept { value.hash_cache = 0; }
+
+        /// @brief computes the 128-bit structural hash of a JSONValue (cached hashes are not used)
+        /// @param value the JSONValue to hash
+        /// @return the structural hash
+        inline JSONHash128 hash128(const JSONValue &value)
+        {
+            JSONHasher::NoMemo memo{};
+            return JSONHash128{
+                .low  = JSONHasher::hash_value(value, JSONHasher::default_seed, memo),
+                .high = JSONHasher::hash_value(value, JSONHasher::high_seed, memo)};
+        }
+
+        //--JSON Equality-----------------------------------------------------------------------------------------------
+
+        /// @brief deep (structural) equality of two JSONValues
+        ///
+        /// short-circuits when both sides are the same JSONValue and when both sides have (different) cached hashes.
+        /// Numbers compare as numbers (so +0 == -0), and objects compare regardless of member order
+        ///
+        /// @param lhs the left hand side
+        /// @param rhs the right hand side
+        /// @return true if the JSONValues are structurally equal
+        inline bool operator==(const JSONValue &lhs, const JSONValue &rhs)
+        {
+            if (&lhs == &rhs)
+            {
+                return true;
+            }
+            if (lhs.type != rhs.type || (lhs.hash_cache && rhs.hash_cache && lhs.hash_cache != rhs.hash_cache))
+            {
+                return false;
+            }
+
+            switch (lhs.type)
+            {
+            case JSONValue::JSONValueType::literal:
+                return std::get<JSONValue::LiteralType>(lhs.value) == std::get<JSONValue::LiteralType>(rhs.value);
+            case JSONValue::JSONValueType::number:
+                return std::get<JSONValue::NumberType>(lhs.value) == std::get<JSONValue::NumberType>(rhs.value);
+            case JSONValue::JSONValueType::string:
+                return std::get<JSONValue::StringType>(lhs.value) == std::get<JSONValue::StringType>(rhs.value);
+            case JSONValue::JSONValueType::array:
+                return std::get<JSONValue::ArrayType>(lhs.value) == std::get<JSONValue::ArrayType>(rhs.value);
+            case JSONValue::JSONValueType::object: {
+                const auto &l{std::get<JSONValue::ObjectType>(lhs.value)};
+                const auto &r{std::get<JSONValue::ObjectType>(rhs.value)};
+                if (l.size() != r.size())
+                {
+                    return false;
+                }
+                for (const auto &[key, value] : l)
+                {
+                    const auto found{r.find(key)};
+                    if (found == r.end() || !(value == found->second))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case JSONValue::JSONValueType::undefined:
+            default:
+                return true;
+            }
+        }
+
+        //--JSONPath----------------------------------------------------------------------------------------------------
+
+        /// @brief a JSONPath expression which has been compiled (once) into a small bytecode program
+        ///
+        /// supports the following JSONPath syntax:
+        ///     - the root identifier '$'
+        ///     - child segments: .name, ['name'], ["name"] and [index] (negative indices count from the end)
+        ///     - wildcards: .* and [*]
+        ///     - recursive descent: ..name, ..* and ..[...]
+        ///     - array slices: [start:end:step] (each part optional)
+        ///     - filters: [?(...)] or [?...] made of comparisons (==, !=, <, <=, >, >=) and existence tests between
+        ///     singular queries (@.a.b, $['a'][0]) and literals (numbers, strings, true, false, null), combined with
+        ///     && and || (&& binds tighter than ||)
+        ///
+        /// the program is run by a small virtual machine over an explicit (caller-reusable) stack, so evaluation is not
+        /// recursive and does not allocate once the stack has grown to the size required by a document. Undefined
+        /// JSONValues are never selected (in line with the serializer skipping them)
+        ///
+        /// @remark compile() throws on malformed expressions; evaluation itself never throws
+        class JSONPath
+        {
+          public:
+            //--JSONPath Member Types-----------------------------------------------------------------------------------
+
+            /// @brief the operations a compiled JSONPath program is made of
+            enum struct OpCode : std::uint8_t
+            {
+                child,    ///< select the member of an object with the key keys[a]
+                index,    ///< select the element of an array at index a (negative indices count from the end)
+                wildcard, ///< select every element of an array/every member value of an object
+                slice,    ///< select the elements of an array from a to b (exclusive) with step c
+                descend,  ///< apply the next instruction to the current node and to all of its descendants
+                filter,   ///< select the children of the current node for which clauses [a, a + b) hold
+                match     ///< the current node is a result of the query
+            };
+
+            /// @brief a single bytecode instruction (the meaning of the operands depends on the OpCode)
+            struct Instruction
+            {
+                OpCode       op{OpCode::match}; ///< the operation to perform
+                std::int64_t a{0};              ///< first operand
+                std::int64_t b{0};              ///< second operand
+                std::int64_t c{0};              ///< third operand
+            };
+
+            /// @brief the comparisons a filter clause can perform
+            enum struct Comparison : std::uint8_t
+            {
+                exists,        ///< the left hand side query selects a node
+                not_exists,    ///< the left hand side query does not select a node
+                equal,         ///< ==
+                not_equal,     ///< !=
+                less,          ///< <
+                less_equal,    ///< <=
+                greater,       ///< >
+                greater_equal, ///< >=
+            };
+
+            /// @brief one step of a singular query used inside of a filter (either a key or an index)
+            struct Segment
+            {
+                bool         is_key{false}; ///< true if value is an index into the keys, false if it is an array index
+                std::int64_t value{0};      ///< the key index or the array index
+            };
+
+            /// @brief one side of a filter comparison
+            struct Operand
+            {
+                /// @brief what the operand refers to
+                enum struct Kind : std::uint8_t
+                {
+                    none,    ///< no operand (i.e. the right hand side of an existence test)
+                    current, ///< a singular query relative to the node being filtered (@)
+                    root,    ///< a singular query relative to the root of the document ($)
+                    literal  ///< a literal value
+                };
+
+                Kind          kind{Kind::none}; ///< what the operand refers to
+                std::uint32_t first{0};         ///< the first segment (queries) or the literal index (literals)
+                std::uint32_t count{0};         ///< the number of segments (queries)
+            };
+
+            /// @brief a single comparison of a filter expression
+            struct Clause
+            {
+                Operand    lhs{};                         ///< the left hand side of the comparison
+                Comparison comparison{Comparison::exists}; ///< the comparison to perform
+                Operand    rhs{};                         ///< the right hand side of the comparison
+                bool       or_next{false}; ///< true if this clause is followed by ||, false if followed by && (or last)
+            };
+
+            /// @brief a pending (node, instruction) pair on the evaluation stack
+            struct Frame
+            {
+                const JSONValue *node{nullptr}; ///< the node the instruction applies to
+                std::size_t      ip{0};         ///< the index of the instruction to apply
+            };
+
+            /// @brief the evaluation stack; callers running many queries can hold on to one to avoid reallocations
+            using Stack = std::vector<Frame>;
+
+            //--JSONPath Ctors------------------------------------------------------------------------------------------
+
+            /// @brief an empty JSONPath selects nothing
+            JSONPath() = default;
+
+            /// @brief compiles a JSONPath expression into a program
+            /// @param expression the JSONPath expression (must start with '$')
+            /// @return the compiled JSONPath
+            /// @throws std::exception if the expression is malformed
+            static JSONPath compile(std::u8string_view expression);
+
+            //--JSONPath Evaluation-------------------------------------------------------------------------------------
+
+            /// @brief runs the program over a document, calling on_match for every selected node
+            /// @tparam Fn a callable accepting a const JSONValue&; it may return bool, in which case returning false
+            /// stops the evaluation early
+            /// @param root the document to query
+            /// @param on_match the callable to invoke for every selected node
+            /// @param stack the evaluation stack to use (cleared before use, reused between calls)
+            /// @return the number of nodes passed to on_match
+            template <typename Fn> std::size_t evaluate(const JSONValue &root, Fn &&on_match, Stack &stack) const;
+
+            /// @brief runs the program over a document using a local evaluation stack
+            /// @see evaluate(const JSONValue &, Fn &&, Stack &)
+            template <typename Fn> std::size_t evaluate(const JSONValue &root, Fn &&on_match) const
+            {
+                Stack stack{};
+                return evaluate(root, std::forward<Fn>(on_match), stack);
+            }
+
+            /// @brief collects every node selected by the program
+            /// @param root the document to query
+            /// @return pointers to the selected nodes (which live in root)
+            std::vector<const JSONValue *> select(const JSONValue &root) const
+            {
+                std::vector<const JSONValue *> selected{};
+                evaluate(root, [&selected](const JSONValue &node) { selected.push_back(&node); });
+                return selected;
+            }
+
+            /// @brief finds the first node selected by the program (evaluation stops as soon as it is found)
+            /// @param root the document to query
+            /// @return a pointer to the selected node or nullptr if nothing was selected
+            const JSONValue *select_first(const JSONValue &root) const
+            {
+                const JSONValue *selected{nullptr};
+                evaluate(
+                    root,
+                    [&selected](const JSONValue &node)
+                    {
+                        selected = &node;
+                        return false;
+                    });
+                return selected;
+            }
+
+            /// @brief the compiled program (mostly useful for debugging/inspection)
+            const std::vector<Instruction> &program() const noexcept { return instructions; }
+
+          private:
+            //--JSONPath Member Variables-------------------------------------------------------------------------------
+
+            std::vector<Instruction>           instructions{}; ///< the program; always ends with OpCode::match
+            std::vector<JSONValue::StringType> keys{};         ///< member names referenced by the program
+            std::vector<Segment>               segments{};     ///< the segments of the filters' singular queries
+            std::vector<JSONValue>             literals{};     ///< the literals used by filters
+            std::vector<Clause>                clauses{};      ///< the clauses of every filter
+
+            //--JSONPath Helpers----------------------------------------------------------------------------------------
+
+            struct Compiler;
+
+            /// @brief resolves a filter operand against the node being filtered
+            /// @return the node/literal the operand refers to or nullptr if a query does not select anything
+            const JSONValue *resolve(const Operand &operand, const JSONValue &current, const JSONValue &root) const
+            {
+                const JSONValue *node{nullptr};
+                switch (operand.kind)
+                {
+                case Operand::Kind::literal:
+                    return &literals[operand.first];
+                case Operand::Kind::current:
+                    node = &current;
+                    break;
+                case Operand::Kind::root:
+                    node = &root;
+                    break;
+                case Operand::Kind::none:
+                default:
+                    return nullptr;
+                }
+
+                for (std::uint32_t i = operand.first; node && i < operand.first + operand.count; ++i)
+                {
+                    const Segment &segment{segments[i]};
+                    if (segment.is_key)
+                    {
+                        if (node->type != JSONValue::JSONValueType::object)
+                        {
+                            return nullptr;
+                        }
+                        const auto &object{std::get<JSONValue::ObjectType>(node->value)};
+                        const auto  found{object.find(keys[static_cast<std::size_t>(segment.value)])};
+                        node = found == object.end() ? nullptr : &found->second;
+                    }
+                    else
+                    {
+                        if (node->type != JSONValue::JSONValueType::array)
+                        {
+                            return nullptr;
+                        }
+                        const auto        &array{std::get<JSONValue::ArrayType>(node->value)};
+                        const std::int64_t size{static_cast<std::int64_t>(array.size())};
+                        const std::int64_t index{segment.value < 0 ? segment.value + size : segment.value};
+                        node = (index < 0 || index >= size) ? nullptr : &array[static_cast<std::size_t>(index)];
+                    }
+
+                    if (node && node->type == JSONValue::JSONValueType::undefined)
+                    {
+                        return nullptr;
+                    }
+                }
+                return node;
+            }
+
+            /// @brief compares two (possibly missing) values as per the filter comparison semantics
+            static bool compare(const JSONValue *lhs, Comparison comparison, const JSONValue *rhs)
+            {
+                using ValueType = JSONValue::JSONValueType;
+
+                switch (comparison)
+                {
+                case Comparison::exists:
+                    return lhs != nullptr;
+                case Comparison::not_exists:
+                    return lhs == nullptr;
+                case Comparison::not_equal:
+                    return !compare(lhs, Comparison::equal, rhs);
+                case Comparison::less_equal:
+                    return compare(lhs, Comparison::less, rhs) || compare(lhs, Comparison::equal, rhs);
+                case Comparison::greater:
+                    return compare(rhs, Comparison::less, lhs);
+                case Comparison::greater_equal:
+                    return compare(rhs, Comparison::less, lhs) || compare(lhs, Comparison::equal, rhs);
+                default:
+                    break;
+                }
+
+                // two missing values are equal, a missing value is not equal (or ordered) to anything else
+                if (!lhs || !rhs)
+                {
+                    return comparison == Comparison::equal && lhs == rhs;
+                }
+                if (lhs->type != rhs->type)
+                {
+                    return false;
+                }
+
+                if (comparison == Comparison::less)
+                {
+                    using NumberType = JSONValue::NumberType;
+                    using StringType = JSONValue::StringType;
+
+                    switch (lhs->type)
+                    {
+                    case ValueType::number:
+                        return std::get<NumberType>(lhs->value) < std::get<NumberType>(rhs->value);
+                    case ValueType::string:
+                        return std::get<StringType>(lhs->value) < std::get<StringType>(rhs->value);
+                    default:
+                        return false;
+                    }
+                }
+
+                return *lhs == *rhs;
+            }
+
+            /// @brief evaluates the filter clauses [first, first + count) for a candidate node
+            bool matches(
+                std::int64_t first, std::int64_t count, const JSONValue &candidate, const JSONValue &root) const
+            {
+                bool any{false};
+                bool all{true};
+                for (std::int64_t i = first; i < first + count; ++i)
+                {
+                    const Clause &clause{clauses[static_cast<std::size_t>(i)]};
+                    all = all && compare(resolve(clause.lhs, candidate, root), clause.comparison,
+                                         resolve(clause.rhs, candidate, root));
+                    if (clause.or_next || i + 1 == first + count)
+                    {
+                        any = any || all;
+                        all = true;
+                    }
+                }
+                return any;
+            }
+        };
+
+        /// @brief turns a JSONPath expression into a JSONPath program
+        ///
+        /// a straightforward recursive descent parser; it is only ever run once per expression so it favors clarity
+        /// over speed
+        struct JSONPath::Compiler
+        {
+            std::u8string_view text{}; ///< the expression being compiled
+            std::size_t        pos{0}; ///< the current position in the expression
+            JSONPath          &path;   ///< the JSONPath being built
+
+            /// @brief throws an exception describing the problem and where it occurred
+            [[noreturn]] void fail(const char *what) const
+            {
+                std::string message{"[ben::json::JSONPath::compile] "};
+                message.append(what);
+                message.append(" at offset ");
+                message.append(std::to_string(pos));
+                throw std::exception{message.c_str()};
+            }
+
+            bool at_end() const noexcept { return pos >= text.size(); }
+
+            char8_t peek(std::size_t ahead = 0) const noexcept
+            {
+                return pos + ahead < text.size() ? text[pos + ahead] : u8'\0';
+            }
+
+            void skip_whitespace() noexcept
+            {
+                while (!at_end() && (peek() == u8' ' || peek() == u8'\t' || peek() == u8'\n' || peek() == u8'\r'))
+                {
+                    ++pos;
+                }
+            }
+
+            bool consume(char8_t expected) noexcept
+            {
+                skip_whitespace();
+                if (peek() == expected)
+                {
+                    ++pos;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char8_t expected, const char *what)
+            {
+                if (!consume(expected))
+                {
+                    fail(what);
+                }
+            }
+
+            void emit(OpCode op, std::int64_t a = 0, std::int64_t b = 0, std::int64_t c = 0)
+            {
+                path.instructions.push_back(Instruction{.op = op, .a = a, .b = b, .c = c});
+            }
+
+            std::int64_t add_key(JSONValue::StringType &&key)
+            {
+                for (std::size_t i = 0; i < path.keys.size(); ++i)
+                {
+                    if (path.keys[i] == key)
+                    {
+                        return static_cast<std::int64_t>(i);
+                    }
+                }
+                path.keys.push_back(std::move(key));
+                return static_cast<std::int64_t>(path.keys.size() - 1);
+            }
+
+            static bool is_name_unit(char8_t unit) noexcept
+            {
+                return (unit >= u8'a' && unit <= u8'z') || (unit >= u8'A' && unit <= u8'Z') ||
+                       (unit >= u8'0' && unit <= u8'9') || unit == u8'_' || unit == u8'$' || unit == u8'-' ||
+                       unit >= 0x80;
+            }
+
+            JSONValue::StringType parse_name()
+            {
+                const std::size_t start{pos};
+                while (!at_end() && is_name_unit(peek()))
+                {
+                    ++pos;
+                }
+                if (start == pos)
+                {
+                    fail("expected a member name");
+                }
+                return JSONValue::StringType{text.substr(start, pos - start)};
+            }
+
+            JSONValue::StringType parse_quoted()
+            {
+                const char8_t quote{peek()};
+                ++pos;
+
+                JSONValue::StringType parsed{};
+                while (!at_end() && peek() != quote)
+                {
+                    char8_t unit{peek()};
+                    if (unit == u8'\\')
+                    {
+                        ++pos;
+                        switch (peek())
+                        {
+                        case u8'n':
+                            unit = u8'\n';
+                            break;
+                        case u8'r':
+                            unit = u8'\r';
+                            break;
+                        case u8't':
+                            unit = u8'\t';
+                            break;
+                        case u8'b':
+                            unit = u8'\b';
+                            break;
+                        case u8'f':
+                            unit = u8'\f';
+                            break;
+                        case u8'\\':
+                        case u8'/':
+                        case u8'\'':
+                        case u8'\"':
+                            unit = peek();
+                            break;
+                        default:
+                            fail("unsupported escape sequence in string");
+                        }
+                    }
+                    parsed.push_back(unit);
+                    ++pos;
+                }
+                if (at_end())
+                {
+                    fail("unterminated string");
+                }
+                ++pos;
+                return parsed;
+            }
+
+            bool try_parse_integer(std::int64_t &out)
+            {
+                skip_whitespace();
+                const std::size_t start{pos};
+                if (peek() == u8'-')
+                {
+                    ++pos;
+                }
+                while (!at_end() && peek() >= u8'0' && peek() <= u8'9')
+                {
+                    ++pos;
+                }
+                if (pos == start || (pos == start + 1 && text[start] == u8'-'))
+                {
+                    pos = start;
+                    return false;
+                }
+
+                std::array<char, 24> ascii{'\0'};
+                if (pos - start >= ascii.size())
+                {
+                    fail("integer is too large");
+                }
+                for (std::size_t i = start; i < pos; ++i)
+                {
+                    ascii[i - start] = static_cast<char>(text[i]);
+                }
+                if (std::from_chars(ascii.data(), ascii.data() + (pos - start), out).ec != std::errc{})
+                {
+                    fail("integer is out of range");
+                }
+                return true;
+            }
+
+            JSONValue parse_literal()
+            {
+                skip_whitespace();
+                if (peek() == u8'\'' || peek() == u8'\"')
+                {
+                    return JSONValue{parse_quoted()};
+                }
+                for (const auto &[word, literal] :
+                     {std::pair{std::u8string_view{u8"true"}, JSONValue::LiteralType::true_v},
+                      std::pair{std::u8string_view{u8"false"}, JSONValue::LiteralType::false_v},
+                      std::pair{std::u8string_view{u8"null"}, JSONValue::LiteralType::null_v}})
+                {
+                    if (text.substr(pos, word.size()) == word)
+                    {
+                        pos += word.size();
+                        return JSONValue{literal};
+                    }
+                }
+
+                const std::size_t start{pos};
+                while (!at_end() && ((peek() >= u8'0' && peek() <= u8'9') || peek() == u8'-' || peek() == u8'+' ||
+                                     peek() == u8'.' || peek() == u8'e' || peek() == u8'E'))
+                {
+                    ++pos;
+                }
+                std::array<char, 64> ascii{'\0'};
+                if (start == pos || pos - start >= ascii.size())
+                {
+                    fail("expected a literal");
+                }
+                for (std::size_t i = start; i < pos; ++i)
+                {
+                    ascii[i - start] = static_cast<char>(text[i]);
+                }
+                JSONValue::NumberType number{0};
+                const auto            res{std::from_chars(ascii.data(), ascii.data() + (pos - start), number)};
+                if (res.ec != std::errc{} || res.ptr != ascii.data() + (pos - start))
+                {
+                    fail("malformed number literal");
+                }
+                return JSONValue{number};
+            }
+
+            Operand parse_operand()
+            {
+                skip_whitespace();
+                if (peek() != u8'@' && peek() != u8'$')
+                {
+                    path.literals.push_back(parse_literal());
+                    return Operand{
+                        .kind = Operand::Kind::literal, .first = static_cast<std::uint32_t>(path.literals.size() - 1)};
+                }
+
+                Operand operand{
+                    .kind  = peek() == u8'@' ? Operand::Kind::current : Operand::Kind::root,
+                    .first = static_cast<std::uint32_t>(path.segments.size())};
+                ++pos;
+
+                while (true)
+                {
+                    if (peek() == u8'.' && is_name_unit(peek(1)))
+                    {
+                        ++pos;
+                        path.segments.push_back(Segment{.is_key = true, .value = add_key(parse_name())});
+                    }
+                    else if (peek() == u8'[')
+                    {
+                        ++pos;
+                        skip_whitespace();
+                        std::int64_t index{0};
+                        if (peek() == u8'\'' || peek() == u8'\"')
+                        {
+                            path.segments.push_back(Segment{.is_key = true, .value = add_key(parse_quoted())});
+                        }
+                        else if (try_parse_integer(index))
+                        {
+                            path.segments.push_back(Segment{.is_key = false, .value = index});
+                        }
+                        else
+                        {
+                            fail("filter queries may only contain names and indices");
+                        }
+                        expect(u8']', "expected ']'");
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+                operand.count = static_cast<std::uint32_t>(path.segments.size()) - operand.first;
+                return operand;
+            }
+
+            Clause parse_clause()
+            {
+                skip_whitespace();
+                Clause clause{};
+                if (consume(u8'!'))
+                {
+                    clause.lhs        = parse_operand();
+                    clause.comparison = Comparison::not_exists;
+                }
+                else
+                {
+                    clause.lhs = parse_operand();
+                    skip_whitespace();
+
+                    const char8_t first{peek()};
+                    const char8_t second{peek(1)};
+                    if (first == u8'=' && second == u8'=')
+                    {
+                        clause.comparison = Comparison::equal;
+                    }
+                    else if (first == u8'!' && second == u8'=')
+                    {
+                        clause.comparison = Comparison::not_equal;
+                    }
+                    else if (first == u8'<')
+                    {
+                        clause.comparison = second == u8'=' ? Comparison::less_equal : Comparison::less;
+                    }
+                    else if (first == u8'>')
+                    {
+                        clause.comparison = second == u8'=' ? Comparison::greater_equal : Comparison::greater;
+                    }
+                    else
+                    {
+                        clause.comparison = Comparison::exists;
+                    }
+
+                    if (clause.comparison != Comparison::exists)
+                    {
+                        pos += (second == u8'=') ? 2 : 1;
+                        clause.rhs = parse_operand();
+                    }
+                }
+
+                if (clause.lhs.kind == Operand::Kind::literal &&
+                    (clause.comparison == Comparison::exists || clause.comparison == Comparison::not_exists))
+                {
+                    fail("existence tests require a query");
+                }
+                return clause;
+            }
+
+            void parse_filter()
+            {
+                const bool        parenthesized{consume(u8'(')};
+                const std::size_t first{path.clauses.size()};
+                while (true)
+                {
+                    path.clauses.push_back(parse_clause());
+                    skip_whitespace();
+                    if (peek() == u8'&' && peek(1) == u8'&')
+                    {
+                        pos += 2;
+                    }
+                    else if (peek() == u8'|' && peek(1) == u8'|')
+                    {
+                        path.clauses.back().or_next = true;
+                        pos += 2;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+                if (parenthesized)
+                {
+                    expect(u8')', "expected ')'");
+                }
+                emit(OpCode::filter,
+                     static_cast<std::int64_t>(first),
+                     static_cast<std::int64_t>(path.clauses.size() - first));
+            }
+
+            void parse_bracket()
+            {
+                // the '[' has already been consumed
+                skip_whitespace();
+                if (consume(u8'*'))
+                {
+                    emit(OpCode::wildcard);
+                }
+                else if (peek() == u8'\'' || peek() == u8'\"')
+                {
+                    emit(OpCode::child, add_key(parse_quoted()));
+                }
+                else if (consume(u8'?'))
+                {
+                    parse_filter();
+                }
+                else
+                {
+                    constexpr std::int64_t unset{std::numeric_limits<std::int64_t>::min()};
+
+                    std::int64_t start{unset};
+                    std::int64_t end{unset};
+                    std::int64_t step{1};
+                    const bool   has_start{try_parse_integer(start)};
+                    if (!consume(u8':'))
+                    {
+                        if (!has_start)
+                        {
+                            fail("expected an index, a slice, a string, '*' or a filter");
+                        }
+                        emit(OpCode::index, start);
+                    }
+                    else
+                    {
+                        try_parse_integer(end);
+                        if (consume(u8':'))
+                        {
+                            try_parse_integer(step);
+                        }
+                        emit(OpCode::slice, start, end, step);
+                    }
+                }
+                expect(u8']', "expected ']'");
+            }
+
+            void compile()
+            {
+                skip_whitespace();
+                if (peek() != u8'$')
+                {
+                    fail("expected '$'");
+                }
+                ++pos;
+
+                while (true)
+                {
+                    skip_whitespace();
+                    if (at_end())
+                    {
+                        break;
+                    }
+
+                    if (peek() == u8'.' && peek(1) == u8'.')
+                    {
+                        pos += 2;
+                        emit(OpCode::descend);
+                        if (peek() == u8'*')
+                        {
+                            ++pos;
+                            emit(OpCode::wildcard);
+                        }
+                        else if (peek() == u8'[')
+                        {
+                            ++pos;
+                            parse_bracket();
+                        }
+                        else
+                        {
+                            emit(OpCode::child, add_key(parse_name()));
+                        }
+                    }
+                    else if (peek() == u8'.')
+                    {
+                        ++pos;
+                        if (peek() == u8'*')
+                        {
+                            ++pos;
+                            emit(OpCode::wildcard);
+                        }
+                        else
+                        {
+                            emit(OpCode::child, add_key(parse_name()));
+                        }
+                    }
+                    else if (peek() == u8'[')
+                    {
+                        ++pos;
+                        parse_bracket();
+                    }
+                    else
+                    {
+                        fail("unexpected character");
+                    }
+                }
+                emit(OpCode::match);
+            }
+        };
+
+        inline JSONPath JSONPath::compile(std::u8string_view expression)
+        {
+            JSONPath compiled{};
+            Compiler{.text = expression, .pos = 0, .path = compiled}.compile();
+            return compiled;
+        }
+
+        template <typename Fn> std::size_t JSONPath::evaluate(const JSONValue &root, Fn &&on_match, Stack &stack) const
+        {
+            using ValueType = JSONValue::JSONValueType;
+
+            std::size_t matched{0};
+            if (instructions.empty() || root.type == ValueType::undefined)
+            {
+                return matched;
+            }
+
+            stack.clear();
+            stack.push_back(Frame{.node = &root, .ip = 0});
+
+            // pushes a child for the given instruction, skipping undefined values
+            const auto push = [&stack](const JSONValue &node, std::size_t ip)
+            {
+                if (node.type != ValueType::undefined)
+                {
+                    stack.push_back(Frame{.node = &node, .ip = ip});
+                }
+            };
+
+            while (!stack.empty())
+            {
+                const Frame        frame{stack.back()};
+                const Instruction &instruction{instructions[frame.ip]};
+                const JSONValue   &node{*frame.node};
+                const std::size_t  next{frame.ip + 1};
+                stack.pop_back();
+
+                // frames are popped in LIFO order, so arrays are always pushed back to front to select elements in
+                // document order
+                switch (instruction.op)
+                {
+                case OpCode::match:
+                    ++matched;
+                    if constexpr (std::is_same_v<std::invoke_result_t<Fn, const JSONValue &>, bool>)
+                    {
+                        if (!on_match(node))
+                        {
+                            return matched;
+                        }
+                    }
+                    else
+                    {
+                        on_match(node);
+                    }
+                    break;
+
+                case OpCode::child:
+                    if (node.type == ValueType::object)
+                    {
+                        const auto &object{std::get<JSONValue::ObjectType>(node.value)};
+                        const auto  found{object.find(keys[static_cast<std::size_t>(instruction.a)])};
+                        if (found != object.end())
+                        {
+                            push(found->second, next);
+                        }
+                    }
+                    break;
+
+                case OpCode::index:
+                    if (node.type == ValueType::array)
+                    {
+                        const auto        &array{std::get<JSONValue::ArrayType>(node.value)};
+                        const std::int64_t size{static_cast<std::int64_t>(array.size())};
+                        const std::int64_t index{instruction.a < 0 ? instruction.a + size : instruction.a};
+                        if (index >= 0 && index < size)
+                        {
+                            push(array[static_cast<std::size_t>(index)], next);
+                        }
+                    }
+                    break;
+
+                case OpCode::slice:
+                    if (node.type == ValueType::array && instruction.c != 0)
+                    {
+                        constexpr std::int64_t unset{std::numeric_limits<std::int64_t>::min()};
+
+                        const auto        &array{std::get<JSONValue::ArrayType>(node.value)};
+                        const std::int64_t size{static_cast<std::int64_t>(array.size())};
+                        const std::int64_t step{instruction.c};
+                        const std::int64_t start{instruction.a < 0 ? instruction.a + size : instruction.a};
+                        const std::int64_t end{instruction.b < 0 ? instruction.b + size : instruction.b};
+
+                        if (step > 0)
+                        {
+                            const std::int64_t lower{
+                                std::clamp(instruction.a == unset ? 0 : start, std::int64_t{0}, size)};
+                            const std::int64_t upper{
+                                std::clamp(instruction.b == unset ? size : end, std::int64_t{0}, size)};
+                            const std::int64_t count{lower < upper ? (upper - lower - 1) / step + 1 : 0};
+                            for (std::int64_t i = lower + (count - 1) * step; count > 0 && i >= lower; i -= step)
+                            {
+                                push(array[static_cast<std::size_t>(i)], next);
+                            }
+                        }
+                        else
+                        {
+                            const std::int64_t upper{
+                                std::clamp(instruction.a == unset ? size - 1 : start, std::int64_t{-1}, size - 1)};
+                            const std::int64_t lower{
+                                std::clamp(instruction.b == unset ? -1 : end, std::int64_t{-1}, size - 1)};
+                            const std::int64_t count{lower < upper ? (upper - lower - 1) / -step + 1 : 0};
+                            for (std::int64_t i = upper + (count - 1) * step; count > 0 && i <= upper; i -= step)
+                            {
+                                push(array[static_cast<std::size_t>(i)], next);
+                            }
+                        }
+                    }
+                    break;
+
+                case OpCode::wildcard:
+                case OpCode::filter:
+                case OpCode::descend: {
+                    // descend re-applies itself to every child and then hands the current node to the next instruction
+                    // (pushed last so that it runs first, keeping the results in pre-order)
+                    const std::size_t child_ip{instruction.op == OpCode::descend ? frame.ip : next};
+                    const auto        visit = [&](const JSONValue &child)
+                    {
+                        if (instruction.op != OpCode::filter || matches(instruction.a, instruction.b, child, root))
+                        {
+                            push(child, child_ip);
+                        }
+                    };
+
+                    if (node.type == ValueType::array)
+                    {
+                        const auto &array{std::get<JSONValue::ArrayType>(node.value)};
+                        for (auto it = array.rbegin(); it != array.rend(); ++it)
+                        {
+                            visit(*it);
+                        }
+                    }
+                    else if (node.type == ValueType::object)
+                    {
+                        for (const auto &[key, member] : std::get<JSONValue::ObjectType>(node.value))
+                        {
+                            visit(member);
+                        }
+                    }
+
+                    if (instruction.op == OpCode::descend)
+                    {
+                        push(node, next);
+                    }
+                    break;
+                }
+
+                default:
+                    break;
+                }
+            }
+            return matched;
+        }
+
+        //--JSON Pointer------------------------------------------------------------------------------------------------
+
+        /// @brief a JSON Pointer (RFC 6901) which has been split into (unescaped) tokens up front
+        ///
+        /// array indices are parsed once when the pointer is compiled, so resolving a pointer is just a sequence of
+        /// object lookups and array indexing operations
+        class JSONPointer
+        {
+          public:
+            //--JSONPointer Member Types--------------------------------------------------------------------------------
+
+            /// @brief a single reference token of the pointer
+            struct Token
+            {
+                /// @brief the index value of tokens which can not be used as an array index
+                static constexpr std::int64_t not_an_index{-1};
+
+                /// @brief the index value of the "-" token (i.e. one past the last element of an array)
+                static constexpr std::int64_t past_the_end{-2};
+
+                JSONValue::StringType key{};               ///< the unescaped token (used for object members)
+                std::int64_t          index{not_an_index}; ///< the array index the token represents (if any)
+            };
+
+            //--JSONPointer Ctors---------------------------------------------------------------------------------------
+
+            /// @brief an empty JSONPointer refers to the whole document
+            JSONPointer() = default;
+
+            /// @brief compiles a JSON Pointer string
+            /// @param pointer the JSON Pointer (either empty or starting with '/')
+            /// @return the compiled JSONPointer
+            /// @throws std::exception if the pointer is malformed
+            static JSONPointer compile(std::u8string_view pointer)
+            {
+                JSONPointer compiled{};
+                compiled.text = pointer;
+                if (pointer.empty())
+                {
+                    return compiled;
+                }
+                if (pointer.front() != u8'/')
+                {
+                    throw std::exception{"[ben::json::JSONPointer::compile] pointers must be empty or start with '/'"};
+                }
+
+                for (std::size_t pos = 1; pos <= pointer.size();)
+                {
+                    std::size_t end{pointer.find(u8'/', pos)};
+                    end = end == std::u8string_view::npos ? pointer.size() : end;
+
+                    Token token{};
+                    for (std::size_t i = pos; i < end; ++i)
+                    {
+                        if (pointer[i] != u8'~')
+                        {
+                            token.key.push_back(pointer[i]);
+                            continue;
+                        }
+                        if (i + 1 == end || (pointer[i + 1] != u8'0' && pointer[i + 1] != u8'1'))
+                        {
+                            throw std::exception{"[ben::json::JSONPointer::compile] '~' must precede '0' or '1'"};
+                        }
+                        token.key.push_back(pointer[++i] == u8'0' ? u8'~' : u8'/');
+                    }
+                    token.index = parse_index(token.key);
+
+                    compiled.tokens.push_back(std::move(token));
+                    pos = end + 1;
+                }
+                return compiled;
+            }
+
+            //--JSONPointer Accessors-----------------------------------------------------------------------------------
+
+            /// @brief the reference tokens of the pointer
+            const std::vector<Token> &get_tokens() const noexcept { return tokens; }
+
+            /// @brief the (escaped) string representation of the pointer
+            const JSONValue::StringType &get_text() const noexcept { return text; }
+
+            /// @brief resolves the pointer against a document
+            ///
+            /// the referenced value can be mutated through the result, so the hashes cached (by
+            /// ben::json::cache_hash(...)) in every value along the way, including the referenced value itself, are
+            /// invalidated (resolve a const document to leave them alone)
+            ///
+            /// @param root the document
+            /// @param depth the number of tokens to resolve (defaults to all of them)
+            /// @return a pointer to the referenced value or nullptr if the value does not exist
+            JSONValue *resolve(JSONValue &root, std::size_t depth = std::numeric_limits<std::size_t>::max()) const
+            {
+                return walk(root, std::min(depth, tokens.size()), true);
+            }
+
+            /// @brief resolves the pointer against a document without mutating it (cached hashes are kept)
+            /// @param root the document
+            /// @param depth the number of tokens to resolve (defaults to all of them)
+            /// @return a pointer to the referenced value or nullptr if the value does not exist
+            const JSONValue *resolve(
+                const JSONValue &root, std::size_t depth = std::numeric_limits<std::size_t>::max()) const
+            {
+                return walk(root, std::min(depth, tokens.size()));
+            }
+
+            /// @brief resolves the pointer against a document which is about to be mutated at that location (the same
+            /// as resolving a non-const document)
+            ///
+            /// @copydetails resolve(JSONValue &, std::size_t) const
+            JSONValue *resolve_for_mutation(
+                JSONValue &root, std::size_t depth = std::numeric_limits<std::size_t>::max()) const
+            {
+                return walk(root, std::min(depth, tokens.size()), true);
+            }
+
+          private:
+            //--JSONPointer Member Variables----------------------------------------------------------------------------
+
+            std::vector<Token>    tokens{}; ///< the unescaped reference tokens
+            JSONValue::StringType text{};   ///< the original (escaped) pointer
+
+            //--JSONPointer Helpers-------------------------------------------------------------------------------------
+
+            /// @brief parses an array index as per RFC 6901 (no leading zeros, "-" refers past the end)
+            static std::int64_t parse_index(const JSONValue::StringType &key) noexcept
+            {
+                if (key == u8"-")
+                {
+                    return Token::past_the_end;
+                }
+                if (key.empty() || key.size() > 18 || (key.size() > 1 && key.front() == u8'0'))
+                {
+                    return Token::not_an_index;
+                }
+
+                std::int64_t index{0};
+                for (const auto unit : key)
+                {
+                    if (unit < u8'0' || unit > u8'9')
+                    {
+                        return Token::not_an_index;
+                    }
+                    index = index * 10 + (unit - u8'0');
+                }
+                return index;
+            }
+
+            template <typename V> V *walk(V &root, std::size_t depth, bool invalidate = false) const
+            {
+                V *node{&root};
+                for (std::size_t i = 0; node && i < depth; ++i)
+                {
+                    if (invalidate)
+                    {
+                        invalidate_hash(*node);
+                    }
+
+                    const Token &token{tokens[i]};
+                    if (node->type == JSONValue::JSONValueType::object)
+                    {
+                        auto      &object{std::get<JSONValue::ObjectType>(node->value)};
+                        const auto found{object.find(token.key)};
+                        node = found == object.end() ? nullptr : &found->second;
+                    }
+                    else if (node->type == JSONValue::JSONValueType::array)
+                    {
+                        auto &array{std::get<JSONValue::ArrayType>(node->value)};
+                        node = (token.index < 0 || static_cast<std::size_t>(token.index) >= array.size())
+                                   ? nullptr
+                                   : &array[static_cast<std::size_t>(token.index)];
+                    }
+                    else
+                    {
+                        node = nullptr;
+                    }
+                }
+                if (invalidate && node)
+                {
+                    invalidate_hash(*node);
+                }
+                return node;
+            }
+        };
+
+        //--JSON Patch--------------------------------------------------------------------------------------------------
+
+        /// @brief the outcome of applying a JSONPatch
+        struct JSONPatchResult
+        {
+            /// @brief true if every operation was applied
+            bool applied{true};
+
+            /// @brief the index of the operation which could not be applied (if any)
+            std::size_t failed_operation{std::numeric_limits<std::size_t>::max()};
+
+            /// @brief why the operation could not be applied (a static string)
+            const char *reason{""};
+
+            /// @brief converts to true if the patch was applied
+            explicit operator bool() const noexcept { return applied; }
+        };
+
+        /// @brief a JSON Patch (RFC 6902) whose pointers have been compiled up front
+        ///
+        /// patches are applied to a document in place. Every mutation records its inverse in an undo log (old values
+        /// are moved into the log rather than copied), so when an operation fails the operations which were already
+        /// applied are undone and the document is left exactly as it was; the whole patch is atomic without ever
+        /// copying the document
+        class JSONPatch
+        {
+          public:
+            //--JSONPatch Member Types----------------------------------------------------------------------------------
+
+            /// @brief the six JSON Patch operations
+            enum struct OpType : std::uint8_t
+            {
+                add,     ///< adds a value to an object or inserts it into an array
+                remove,  ///< removes a value
+                replace, ///< replaces a value
+                move,    ///< removes a value and adds it at another location
+                copy,    ///< copies a value to another location
+                test     ///< tests that a value is equal to the given value
+            };
+
+            /// @brief a single (compiled) patch operation
+            struct Operation
+            {
+                OpType      op{OpType::test}; ///< the operation to perform
+                JSONPointer path{};           ///< the target location
+                JSONPointer from{};           ///< the source location (move and copy only)
+                JSONValue   value{};          ///< the value to add/replace/test with (add, replace, and test only)
+            };
+
+            //--JSONPatch Ctors-----------------------------------------------------------------------------------------
+
+            /// @brief an empty JSONPatch does nothing when applied
+            JSONPatch() = default;
+
+            /// @brief compiles a JSON Patch document (an array of operation objects) into a JSONPatch
+            /// @param patch the JSON Patch document
+            /// @return the compiled JSONPatch
+            /// @throws std::exception if the patch document is malformed
+            static JSONPatch compile(const JSONValue &patch);
+
+            //--JSONPatch Builders--------------------------------------------------------------------------------------
+
+            /// @brief appends an "add" operation
+            JSONPatch &add(std::u8string_view path, JSONValue value)
+            {
+                return push(OpType::add, path, {}, std::move(value));
+            }
+
+            /// @brief appends a "remove" operation
+            JSONPatch &remove(std::u8string_view path) { return push(OpType::remove, path, {}, {}); }
+
+            /// @brief appends a "replace" operation
+            JSONPatch &replace(std::u8string_view path, JSONValue value)
+            {
+                return push(OpType::replace, path, {}, std::move(value));
+            }
+
+            /// @brief appends a "move" operation
+            JSONPatch &move(std::u8string_view from, std::u8string_view path)
+            {
+                return push(OpType::move, path, from, {});
+            }
+
+            /// @brief appends a "copy" operation
+            JSONPatch &copy(std::u8string_view from, std::u8string_view path)
+            {
+                return push(OpType::copy, path, from, {});
+            }
+
+            /// @brief appends a "test" operation
+            JSONPatch &test(std::u8string_view path, JSONValue value)
+            {
+                return push(OpType::test, path, {}, std::move(value));
+            }
+
+            //--JSONPatch Accessors-------------------------------------------------------------------------------------
+
+            /// @brief the operations of the patch
+            const std::vector<Operation> &get_operations() const noexcept { return operations; }
+
+            /// @brief the JSON Patch document representation of the patch (serialize it to send it elsewhere)
+            JSONValue to_json_value() const;
+
+            //--JSONPatch Application-----------------------------------------------------------------------------------
+
+            /// @brief applies the patch to a document in place
+            /// @param document the document to patch
+            /// @return the result of the application; if it was not applied the document has been left untouched
+            JSONPatchResult apply(JSONValue &document) const;
+
+          private:
+            //--JSONPatch Member Variables------------------------------------------------------------------------------
+
+            std::vector<Operation> operations{}; ///< the operations, applied in order
+
+            //--JSONPatch Helpers---------------------------------------------------------------------------------------
+
+            /// @brief an entry of the undo log; undoing entries in reverse order restores the document
+            struct UndoEntry
+            {
+                /// @brief what has to be done to undo a mutation
+                enum struct Action : std::uint8_t
+                {
+                    remove, ///< remove the value at path (it is kept as the "carried" value)
+                    insert, ///< insert the stored (or carried) value at path
+                    replace ///< replace the value at path with the stored value (the old value is kept as "carried")
+                };
+
+                Action             action{Action::remove}; ///< the inverse mutation
+                const JSONPointer *path{nullptr};          ///< where to apply the inverse mutation
+                std::size_t        index{0};               ///< the resolved array index (array parents only)
+                bool               carried{false};         ///< true if insert should use the carried value
+                JSONValue          value{};                ///< the value to insert/replace with
+            };
+
+            using UndoLog = std::vector<UndoEntry>;
+
+            JSONPatch &push(OpType op, std::u8string_view path, std::u8string_view from, JSONValue &&value)
+            {
+                operations.push_back(Operation{
+                    .op    = op,
+                    .path  = JSONPointer::compile(path),
+                    .from  = JSONPointer::compile(from),
+                    .value = std::move(value)});
+                return *this;
+            }
+
+            /// @brief the parent container of the value a pointer refers to
+            static JSONValue *parent_of(JSONValue &document, const JSONPointer &path)
+            {
+                return path.resolve_for_mutation(document, path.get_tokens().size() - 1);
+            }
+
+            /// @brief adds (or inserts) a value at a location, logging the inverse mutation
+            /// @return nullptr on success, otherwise the reason for failure
+            static const char *add_at(JSONValue &document, const JSONPointer &path, JSONValue &&value, UndoLog &log)
+            {
+                if (path.get_tokens().empty())
+                {
+                    log.push_back(UndoEntry{
+                        .action = UndoEntry::Action::replace, .path = &path, .value = std::move(document)});
+                    document = std::move(value);
+                    return nullptr;
+                }
+
+                JSONValue *const          parent{parent_of(document, path)};
+                const JSONPointer::Token &token{path.get_tokens().back()};
+                if (!parent)
+                {
+                    return "the parent of the target location does not exist";
+                }
+
+                if (parent->type == JSONValue::JSONValueType::object)
+                {
+                    auto &object{std::get<JSONValue::ObjectType>(parent->value)};
+                    auto  found{object.find(token.key)};
+                    if (found != object.end())
+                    {
+                        log.push_back(UndoEntry{
+                            .action = UndoEntry::Action::replace, .path = &path, .value = std::move(found->second)});
+                        found->second = std::move(value);
+                    }
+                    else
+                    {
+                        object.emplace(token.key, std::move(value));
+                        log.push_back(UndoEntry{.action = UndoEntry::Action::remove, .path = &path});
+                    }
+                    return nullptr;
+                }
+
+                if (parent->type == JSONValue::JSONValueType::array)
+                {
+                    auto             &array{std::get<JSONValue::ArrayType>(parent->value)};
+                    const std::size_t index{
+                        token.index == JSONPointer::Token::past_the_end ? array.size()
+                                                                        : static_cast<std::size_t>(token.index)};
+                    if (token.index == JSONPointer::Token::not_an_index || index > array.size())
+                    {
+                        return "the array index is invalid or out of range";
+                    }
+                    array.insert(array.begin() + static_cast<std::ptrdiff_t>(index), std::move(value));
+                    log.push_back(UndoEntry{.action = UndoEntry::Action::remove, .path = &path, .index = index});
+                    return nullptr;
+                }
+
+                return "the parent of the target location is not an object or an array";
+            }
+
+            /// @brief removes the value at a location, logging the inverse mutation
+            /// @param carry if not nullptr, receives the removed value and the undo entry expects the value to be
+            /// carried back to it (used by move, which hands the removed value on); otherwise the removed value is
+            /// moved into the undo log
+            /// @return nullptr on success, otherwise the reason for failure
+            static const char *remove_at(JSONValue &document, const JSONPointer &path, UndoLog &log, JSONValue *carry)
+            {
+                if (path.get_tokens().empty())
+                {
+                    return "the whole document can not be removed";
+                }
+
+                JSONValue *const          parent{parent_of(document, path)};
+                const JSONPointer::Token &token{path.get_tokens().back()};
+                UndoEntry entry{.action = UndoEntry::Action::insert, .path = &path, .carried = carry != nullptr};
+                JSONValue &removed{carry ? *carry : entry.value};
+
+                if (parent && parent->type == JSONValue::JSONValueType::object)
+                {
+                    auto &object{std::get<JSONValue::ObjectType>(parent->value)};
+                    auto  found{object.find(token.key)};
+                    if (found == object.end())
+                    {
+                        return "the target location does not exist";
+                    }
+                    removed = std::move(found->second);
+                    object.erase(found);
+                }
+                else if (parent && parent->type == JSONValue::JSONValueType::array)
+                {
+                    auto &array{std::get<JSONValue::ArrayType>(parent->value)};
+                    if (token.index < 0 || static_cast<std::size_t>(token.index) >= array.size())
+                    {
+                        return "the target location does not exist";
+                    }
+                    entry.index = static_cast<std::size_t>(token.index);
+                    removed     = std::move(array[entry.index]);
+                    array.erase(array.begin() + token.index);
+                }
+                else
+                {
+                    return "the target location does not exist";
+                }
+
+                log.push_back(std::move(entry));
+                return nullptr;
+            }
+
+            /// @brief undoes every entry of the log (in reverse order)
+            static void undo(JSONValue &document, UndoLog &log) noexcept
+            {
+                JSONValue carry{};
+                for (auto it = log.rbegin(); it != log.rend(); ++it)
+                {
+                    UndoEntry &entry{*it};
+                    if (entry.action == UndoEntry::Action::replace)
+                    {
+                        // the replaced-out value is carried, since it may be a moved value which a following insert
+                        // has to put back (a move onto an existing member or onto the root)
+                        JSONValue &target{
+                            entry.path->get_tokens().empty() ? document : *entry.path->resolve_for_mutation(document)};
+                        carry  = std::move(target);
+                        target = std::move(entry.value);
+                        continue;
+                    }
+
+                    // the log is replayed against exactly the states it was recorded in, so the parents exist
+                    JSONValue *const          parent{parent_of(document, *entry.path)};
+                    const JSONPointer::Token &token{entry.path->get_tokens().back()};
+                    if (entry.action == UndoEntry::Action::remove)
+                    {
+                        if (parent->type == JSONValue::JSONValueType::object)
+                        {
+                            auto &object{std::get<JSONValue::ObjectType>(parent->value)};
+                            auto  found{object.find(token.key)};
+                            carry = std::move(found->second);
+                            object.erase(found);
+                        }
+                        else
+                        {
+                            auto &array{std::get<JSONValue::ArrayType>(parent->value)};
+                            carry = std::move(array[entry.index]);
+                            array.erase(array.begin() + static_cast<std::ptrdiff_t>(entry.index));
+                        }
+                    }
+                    else
+                    {
+                        JSONValue &value{entry.carried ? carry : entry.value};
+                        if (parent->type == JSONValue::JSONValueType::object)
+                        {
+                            std::get<JSONValue::ObjectType>(parent->value).emplace(token.key, std::move(value));
+                        }
+                        else
+                        {
+                            auto &array{std::get<JSONValue::ArrayType>(parent->value)};
+                            array.insert(array.begin() + static_cast<std::ptrdiff_t>(entry.index), std::move(value));
+                        }
+                    }
+                }
+                log.clear();
+            }
+
+            /// @brief true if the tokens of prefix are a proper prefix of the tokens of path
+            static bool is_proper_prefix(const JSONPointer &prefix, const JSONPointer &path) noexcept
+            {
+                const auto &p{prefix.get_tokens()};
+                const auto &t{path.get_tokens()};
+                const auto  same = [](const auto &a, const auto &b) { return a.key == b.key; };
+                return p.size() < t.size() && std::equal(p.begin(), p.end(), t.begin(), same);
+            }
+        };
+
+        inline JSONPatch JSONPatch::compile(const JSONValue &patch)
+        {
+            using ValueType = JSONValue::JSONValueType;
+
+            if (patch.type != ValueType::array)
+            {
+                throw std::exception{"[ben::json::JSONPatch::compile] a JSON Patch document must be an array"};
+            }
+
+            // returns the string member of an operation object or nullptr if it is not present/not a string
+            const auto string_member = [](const JSONValue::ObjectType &object, const char8_t *key)
+            {
+                const auto found{object.find(key)};
+                return (found == object.end() || found->second.type != ValueType::string)
+                           ? nullptr
+                           : &std::get<JSONValue::StringType>(found->second.value);
+            };
+
+            static constexpr std::array<std::pair<std::u8string_view, OpType>, 6> names{{
+                {u8"add", OpType::add},
+                {u8"remove", OpType::remove},
+                {u8"replace", OpType::replace},
+                {u8"move", OpType::move},
+                {u8"copy", OpType::copy},
+                {u8"test", OpType::test},
+            }};
+
+            JSONPatch compiled{};
+            for (const auto &element : std::get<JSONValue::ArrayType>(patch.value))
+            {
+                if (element.type != ValueType::object)
+                {
+                    throw std::exception{"[ben::json::JSONPatch::compile] operations must be objects"};
+                }
+                const auto &object{std::get<JSONValue::ObjectType>(element.value)};
+
+                const JSONValue::StringType *const op{string_member(object, u8"op")};
+                const JSONValue::StringType *const path{string_member(object, u8"path")};
+                if (!op || !path)
+                {
+                    throw std::exception{"[ben::json::JSONPatch::compile] operations require \"op\" and \"path\""};
+                }
+
+                const auto name{std::find_if(
+                    names.begin(), names.end(), [op](const auto &candidate) { return candidate.first == *op; })};
+                if (name == names.end())
+                {
+                    throw std::exception{"[ben::json::JSONPatch::compile] unknown operation"};
+                }
+
+                Operation operation{.op = name->second, .path = JSONPointer::compile(*path)};
+                if (operation.op == OpType::move || operation.op == OpType::copy)
+                {
+                    const JSONValue::StringType *const from{string_member(object, u8"from")};
+                    if (!from)
+                    {
+                        throw std::exception{"[ben::json::JSONPatch::compile] move and copy require \"from\""};
+                    }
+                    operation.from = JSONPointer::compile(*from);
+                }
+                else if (operation.op != OpType::remove)
+                {
+                    const auto value{object.find(u8"value")};
+                    if (value == object.end() || value->second.type == ValueType::undefined)
+                    {
+                        throw std::exception{"[ben::json::JSONPatch::compile] add/replace/test require \"value\""};
+                    }
+                    operation.value = value->second;
+                }
+                compiled.operations.push_back(std::move(operation));
+            }
+            return compiled;
+        }
+
+        inline JSONValue JSONPatch::to_json_value() const
+        {
+            static constexpr std::array<const char8_t *, 6> names{
+                u8"add", u8"remove", u8"replace", u8"move", u8"copy", u8"test"};
+
+            JSONValue::ArrayType patch{};
+            patch.reserve(operations.size());
+            for (const auto &operation : operations)
+            {
+                JSONValue::ObjectType object{
+                    {u8"op", JSONValue{names[static_cast<std::size_t>(operation.op)]}},
+                    {u8"path", JSONValue{operation.path.get_text()}}
+                };
+                if (operation.op == OpType::move || operation.op == OpType::copy)
+                {
+                    object.emplace(u8"from", JSONValue{operation.from.get_text()});
+                }
+                else if (operation.op != OpType::remove)
+                {
+                    object.emplace(u8"value", operation.value);
+                }
+                patch.emplace_back(std::move(object));
+            }
+            return JSONValue{std::move(patch)};
+        }
+
+        inline JSONPatchResult JSONPatch::apply(JSONValue &document) const
+        {
+            UndoLog log{};
+            log.reserve(operations.size() * 2);
+
+            for (std::size_t i = 0; i < operations.size(); ++i)
+            {
+                const Operation &operation{operations[i]};
+                const char      *failure{nullptr};
+
+                switch (operation.op)
+                {
+                case OpType::add:
+                    failure = add_at(document, operation.path, JSONValue{operation.value}, log);
+                    break;
+
+                case OpType::remove:
+                    failure = remove_at(document, operation.path, log, nullptr);
+                    break;
+
+                case OpType::replace: {
+                    JSONValue *const target{operation.path.resolve_for_mutation(document)};
+                    if (!target)
+                    {
+                        failure = "the target location does not exist";
+                        break;
+                    }
+                    log.push_back(UndoEntry{
+                        .action = UndoEntry::Action::replace, .path = &operation.path, .value = std::move(*target)});
+                    *target = operation.value;
+                    break;
+                }
+
+                case OpType::move: {
+                    if (is_proper_prefix(operation.from, operation.path))
+                    {
+                        failure = "a value can not be moved into one of its children";
+                        break;
+                    }
+                    JSONValue moved{};
+                    failure = remove_at(document, operation.from, log, &moved);
+                    if (!failure)
+                    {
+                        failure = add_at(document, operation.path, std::move(moved), log);
+                        if (failure)
+                        {
+                            // the removal expects its value to be carried back by a following removal; there is none,
+                            // so store it in the entry itself
+                            log.back().carried = false;
+                            log.back().value   = std::move(moved);
+                        }
+                    }
+                    break;
+                }
+
+                case OpType::copy: {
+                    const JSONValue *const source{operation.from.resolve(std::as_const(document))};
+                    failure = source ? add_at(document, operation.path, JSONValue{*source}, log)
+                                     : "the source location does not exist";
+                    break;
+                }
+
+                case OpType::test: {
+                    const JSONValue *const target{operation.path.resolve(std::as_const(document))};
+                    failure = (target && *target == operation.value) ? nullptr : "test failed";
+                    break;
+                }
+
+                default:
+                    failure = "unknown operation";
+                    break;
+                }
+
+                if (failure)
+                {
+                    undo(document, log);
+                    return JSONPatchResult{.applied = false, .failed_operation = i, .reason = failure};
+                }
+            }
+            return JSONPatchResult{};
+        }
+
+        //--JSON Diff---------------------------------------------------------------------------------------------------
+
+        /// @brief generates the JSONPatch used by ben::json::diff(...)
+        ///
+        /// every node of both documents is hashed at most once (bottom-up, memoized by address, reusing hashes cached
+        /// by ben::json::cache_hash(...)); subtrees with different hashes differ, and subtrees with equal hashes are
+        /// confirmed to be equal with operator== (so only unchanged parts pay for a full comparison, and a hash
+        /// collision can not hide an edit). Objects are diffed member by member; arrays have their common
+        /// prefix/suffix trimmed and the remaining elements are matched with an LCS over element classes (elements
+        /// which are equal share a class, so each element is compared once rather than once per LCS cell), falling
+        /// back to index-by-index matching when the LCS table would be too large
+        class JSONDiffer
+        {
+          public:
+            /// @brief the largest LCS table (in cells) used to match array elements
+            static constexpr std::size_t max_lcs_cells{std::size_t{1} << 22};
+
+            /// @brief diffs two documents
+            /// @param from the source document
+            /// @param to the target document
+            /// @return a JSONPatch which turns from into to
+            static JSONPatch diff(const JSONValue &from, const JSONValue &to)
+            {
+                JSONDiffer differ{};
+                differ.visit(from, to);
+                return std::move(differ.patch);
+            }
+
+          private:
+            //--JSONDiffer Member Variables-----------------------------------------------------------------------------
+
+            JSONPatch                                            patch{};  ///< the patch being generated
+            JSONValue::StringType                                path{};   ///< the pointer to the current node
+            std::unordered_map<const JSONValue *, std::uint64_t> hashes{}; ///< memoized subtree hashes
+
+            //--JSONDiffer Hashing--------------------------------------------------------------------------------------
+
+            /// @brief the memo used to hash subtrees: hashes cached in the documents are reused, everything else is
+            /// memoized by address (the documents are never written to)
+            struct Memo
+            {
+                std::unordered_map<const JSONValue *, std::uint64_t> &hashes; ///< the memoized hashes
+
+                bool lookup(const JSONValue &value, std::uint64_t &h) const
+                {
+                    if (value.hash_cache)
+                    {
+                        h = value.hash_cache;
+                        return true;
+                    }
+                    const auto found{hashes.find(&value)};
+                    if (found == hashes.end())
+                    {
+                        return false;
+                    }
+                    h = found->second;
+                    return true;
+                }
+
+                void store(const JSONValue &value, std::uint64_t h) const { hashes.emplace(&value, h); }
+            };
+
+            /// @brief hashes a subtree (memoized)
+            /// @see JSONHasher::hash_value(const JSONValue &, std::uint64_t, Memo &)
+            std::uint64_t hash(const JSONValue &value)
+            {
+                Memo memo{hashes};
+                return JSONHasher::hash_value(value, JSONHasher::default_seed, memo);
+            }
+
+            /// @brief true if two subtrees are equal (the hashes rule out most differences without a comparison)
+            bool same(const JSONValue &lhs, const JSONValue &rhs) { return hash(lhs) == hash(rhs) && lhs == rhs; }
+
+            //--JSONDiffer Patch Generation-----------------------------------------------------------------------------
+
+            /// @brief appends an (escaped) reference token to the current path
+            /// @return the size of the path before the token was appended (to restore it afterwards)
+            std::size_t push_token(std::u8string_view token)
+            {
+                const std::size_t size{path.size()};
+                path.push_back(u8'/');
+                for (const auto unit : token)
+                {
+                    if (unit == u8'~')
+                    {
+                        path.append(u8"~0");
+                    }
+                    else if (unit == u8'/')
+                    {
+                        path.append(u8"~1");
+                    }
+                    else
+                    {
+                        path.push_back(unit);
+                    }
+                }
+                return size;
+            }
+
+            std::size_t push_index(std::size_t index)
+            {
+                std::array<char, 24> ascii{'\0'};
+                const auto           res{std::to_chars(ascii.data(), ascii.data() + ascii.size(), index)};
+
+                const std::size_t size{path.size()};
+                path.push_back(u8'/');
+                for (const char *c = ascii.data(); c != res.ptr; ++c)
+                {
+                    path.push_back(static_cast<char8_t>(*c));
+                }
+                return size;
+            }
+
+            void visit(const JSONValue &from, const JSONValue &to)
+            {
+                if (same(from, to))
+                {
+                    return;
+                }
+
+                if (from.type != to.type || from.type == JSONValue::JSONValueType::literal ||
+                    from.type == JSONValue::JSONValueType::number || from.type == JSONValue::JSONValueType::string)
+                {
+                    patch.replace(path, to);
+                    return;
+                }
+
+                using ObjectType = JSONValue::ObjectType;
+                using ArrayType  = JSONValue::ArrayType;
+
+                if (from.type == JSONValue::JSONValueType::object)
+                {
+                    visit_object(std::get<ObjectType>(from.value), std::get<ObjectType>(to.value));
+                }
+                else if (from.type == JSONValue::JSONValueType::array)
+                {
+                    visit_array(std::get<ArrayType>(from.value), std::get<ArrayType>(to.value));
+                }
+            }
+
+            void visit_object(const JSONValue::ObjectType &from, const JSONValue::ObjectType &to)
+            {
+                // undefined members are not serialized, so they are treated as if they were not there at all
+                const auto defined = [](const JSONValue::ObjectType &object, const JSONValue::StringType &key)
+                {
+                    const auto found{object.find(key)};
+                    return (found == object.end() || found->second.type == JSONValue::JSONValueType::undefined)
+                               ? nullptr
+                               : &found->second;
+                };
+
+                for (const auto &[key, value] : from)
+                {
+                    if (value.type != JSONValue::JSONValueType::undefined && !defined(to, key))
+                    {
+                        const std::size_t size{push_token(key)};
+                        patch.remove(path);
+                        path.resize(size);
+                    }
+                }
+
+                for (const auto &[key, value] : to)
+                {
+                    if (value.type == JSONValue::JSONValueType::undefined)
+                    {
+                        continue;
+                    }
+
+                    const std::size_t      size{push_token(key)};
+                    const JSONValue *const previous{defined(from, key)};
+                    if (previous)
+                    {
+                        visit(*previous, value);
+                    }
+                    else
+                    {
+                        patch.add(path, value);
+                    }
+                    path.resize(size);
+                }
+            }
+
+            void visit_array(const JSONValue::ArrayType &from, const JSONValue::ArrayType &to)
+            {
+                // trim the common prefix and suffix
+                std::size_t prefix{0};
+                while (prefix < from.size() && prefix < to.size() && same(from[prefix], to[prefix]))
+                {
+                    ++prefix;
+                }
+                std::size_t suffix{0};
+                while (suffix < from.size() - prefix && suffix < to.size() - prefix &&
+                       same(from[from.size() - 1 - suffix], to[to.size() - 1 - suffix]))
+                {
+                    ++suffix;
+                }
+
+                const std::size_t n{from.size() - prefix - suffix};
+                const std::size_t m{to.size() - prefix - suffix};
+
+                // edits are emitted front to back, so 'index' is the position in the array as it is being patched
+                std::size_t index{prefix};
+                const auto  replace_at = [&](std::size_t i, std::size_t j)
+                {
+                    const std::size_t size{push_index(index++)};
+                    visit(from[prefix + i], to[prefix + j]);
+                    path.resize(size);
+                };
+                const auto remove_at = [&]()
+                {
+                    const std::size_t size{push_index(index)};
+                    patch.remove(path);
+                    path.resize(size);
+                };
+                const auto add_at = [&](std::size_t j)
+                {
+                    const std::size_t size{push_index(index++)};
+                    patch.add(path, to[prefix + j]);
+                    path.resize(size);
+                };
+
+                if (n == 0 || m == 0 || (n + 1) * (m + 1) > max_lcs_cells)
+                {
+                    // match elements by position
+                    const std::size_t common{std::min(n, m)};
+                    for (std::size_t i = 0; i < common; ++i)
+                    {
+                        replace_at(i, i);
+                    }
+                    for (std::size_t i = common; i < n; ++i)
+                    {
+                        remove_at();
+                    }
+                    for (std::size_t j = common; j < m; ++j)
+                    {
+                        add_at(j);
+                    }
+                    return;
+                }
+
+                // elements are partitioned into classes of equal values: an element is compared (with operator==) only
+                // to the first element of each class with the same hash, i.e. usually once
+                std::unordered_multimap<std::uint64_t, std::pair<const JSONValue *, std::uint32_t>> representatives{};
+                const auto class_of = [&](const JSONValue &element)
+                {
+                    const std::uint64_t h{hash(element)};
+                    const auto [first, last]{representatives.equal_range(h)};
+                    for (auto it = first; it != last; ++it)
+                    {
+                        if (*it->second.first == element)
+                        {
+                            return it->second.second;
+                        }
+                    }
+                    const std::uint32_t id{static_cast<std::uint32_t>(representatives.size())};
+                    representatives.emplace(h, std::pair{&element, id});
+                    return id;
+                };
+                std::vector<std::uint32_t> from_classes(n);
+                std::vector<std::uint32_t> to_classes(m);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    from_classes[i] = class_of(from[prefix + i]);
+                }
+                for (std::size_t j = 0; j < m; ++j)
+                {
+                    to_classes[j] = class_of(to[prefix + j]);
+                }
+
+                // lcs[i * width + j] is the length of the LCS of from[i..n) and to[j..m)
+                const std::size_t          width{m + 1};
+                std::vector<std::uint32_t> lcs((n + 1) * width, 0);
+                for (std::size_t i = n; i-- > 0;)
+                {
+                    for (std::size_t j = m; j-- > 0;)
+                    {
+                        lcs[i * width + j] = from_classes[i] == to_classes[j]
+                                                 ? lcs[(i + 1) * width + j + 1] + 1
+                                                 : std::max(lcs[(i + 1) * width + j], lcs[i * width + j + 1]);
+                    }
+                }
+
+                std::size_t i{0};
+                std::size_t j{0};
+                while (i < n && j < m)
+                {
+                    if (from_classes[i] == to_classes[j])
+                    {
+                        ++i;
+                        ++j;
+                        ++index;
+                    }
+                    else if (lcs[i * width + j] == lcs[(i + 1) * width + j + 1])
+                    {
+                        // neither element is part of the LCS: the element was modified, so diff it in place
+                        replace_at(i++, j++);
+                    }
+                    else if (lcs[(i + 1) * width + j] >= lcs[i * width + j + 1])
+                    {
+                        remove_at();
+                        ++i;
+                    }
+                    else
+                    {
+                        add_at(j++);
+                    }
+                }
+                for (; i < n; ++i)
+                {
+                    remove_at();
+                }
+                for (; j < m; ++j)
+                {
+                    add_at(j);
+                }
+            }
+        };
+
+        /// @brief generates a (minimal-ish) JSON Patch which turns one document into another
+        /// @param from the source document
+        /// @param to the target document
+        /// @return a JSONPatch which, applied to from, results in a document equal to to
+        /// @see JSONDiffer
+        inline JSONPatch diff(const JSONValue &from, const JSONValue &to) { return JSONDiffer::diff(from, to); }
+
+        //--JSON Deduplication------------------------------------------------------------------------------------------
+
+        /// @brief the memory used by a document before and after deduplication
+        struct JSONDedupeReport
+        {
+            std::size_t nodes_before{0}; ///< the number of (defined) JSONValues in the original document
+            std::size_t nodes_after{0};  ///< the number of unique nodes in the deduplicated document
+            std::size_t bytes_before{0}; ///< the (estimated) bytes used by the original document
+            std::size_t bytes_after{0};  ///< the bytes used by the deduplicated document
+        };
+
+        /// @brief an immutable JSON document in which equal subtrees are stored once and shared (i.e. hash-consed)
+        ///
+        /// every node is a small fixed size record in a flat table, children refer to nodes by index, and strings
+        /// (values and keys) are interned in a single buffer, so a subtree which is repeated many times (the same
+        /// address block, the same metadata, ...) costs one node plus one index per occurrence
+        ///
+        /// dedupe(...) builds the table bottom-up: the children of a node are already canonical when the node itself is
+        /// interned, so two nodes are equal exactly when their types, payloads, and child indices are equal and
+        /// interning never compares more than one level. Object members are stored sorted by key (so equal objects are
+        /// shared regardless of member order), and undefined values are dropped since they are never serialized
+        ///
+        /// when serialized, a node which is referenced more than once is formatted the first time it is reached and
+        /// copied from the output thereafter
+        class JSONSharedDocument
+        {
+          public:
+            //--JSONSharedDocument Member Types-------------------------------------------------------------------------
+
+            /// @brief the index of a node in the node table
+            using NodeId = std::uint32_t;
+
+            /// @brief a node of the document
+            struct Node
+            {
+                JSONValue::JSONValueType type{JSONValue::JSONValueType::undefined}; ///< the type of the node
+                std::uint32_t            first{0}; ///< the literal, the index of the number/string, or the index of
+                                                   ///< the first child/member
+                std::uint32_t            count{0}; ///< the number of children/members
+                std::uint32_t            uses{0};  ///< the number of references to the node (from parents or as root)
+            };
+
+            /// @brief a member of an object node
+            struct Member
+            {
+                std::uint32_t key{0};   ///< the index of the (interned) key
+                NodeId        value{0}; ///< the value
+            };
+
+            //--JSONSharedDocument Ctors--------------------------------------------------------------------------------
+
+            /// @brief deduplicates a document
+            /// @param document the document to deduplicate
+            /// @return the deduplicated document
+            /// @throws std::exception if the document is too large to be indexed with 32-bit indices
+            static JSONSharedDocument dedupe(const JSONValue &document);
+
+            //--JSONSharedDocument Accessors----------------------------------------------------------------------------
+
+            /// @brief the root node of the document
+            NodeId get_root() const noexcept { return root; }
+
+            /// @brief the node table
+            const std::vector<Node> &get_nodes() const noexcept { return nodes; }
+
+            /// @brief the children of all array nodes (a node refers to [first, first + count))
+            const std::vector<NodeId> &get_children() const noexcept { return children; }
+
+            /// @brief the members of all object nodes (a node refers to [first, first + count)), sorted by key
+            const std::vector<Member> &get_members() const noexcept { return members; }
+
+            /// @brief an interned string (the value of a string node or a key)
+            std::u8string_view get_string(std::uint32_t index) const noexcept
+            {
+                return std::u8string_view{text}.substr(strings[index].offset, strings[index].size);
+            }
+
+            /// @brief an interned number (the value of a number node)
+            JSONValue::NumberType get_number(std::uint32_t index) const noexcept { return numbers[index]; }
+
+            /// @brief the memory used by the document before and after deduplication
+            const JSONDedupeReport &get_report() const noexcept { return report; }
+
+            //--JSONSharedDocument Conversion---------------------------------------------------------------------------
+
+            /// @brief expands the document (or a subtree of it) back into a JSONValue
+            /// @param id the node to expand (defaults to the root)
+            /// @return a JSONValue equal to the deduplicated value
+            JSONValue expand(NodeId id) const
+            {
+                const Node &node{nodes[id]};
+                switch (node.type)
+                {
+                case JSONValue::JSONValueType::literal:
+                    return JSONValue{static_cast<JSONValue::LiteralType>(node.first)};
+                case JSONValue::JSONValueType::number:
+                    return JSONValue{numbers[node.first]};
+                case JSONValue::JSONValueType::string:
+                    return JSONValue{JSONValue::StringType{get_string(node.first)}};
+                case JSONValue::JSONValueType::array: {
+                    JSONValue::ArrayType array{};
+                    array.reserve(node.count);
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        array.push_back(expand(children[i]));
+                    }
+                    return JSONValue{std::move(array)};
+                }
+                case JSONValue::JSONValueType::object: {
+                    JSONValue::ObjectType object{};
+                    object.reserve(node.count);
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        object.emplace(JSONValue::StringType{get_string(members[i].key)}, expand(members[i].value));
+                    }
+                    return JSONValue{std::move(object)};
+                }
+                case JSONValue::JSONValueType::undefined:
+                default:
+                    return JSONValue{};
+                }
+            }
+
+            /// @copydoc expand(NodeId) const
+            JSONValue expand() const { return expand(root); }
+
+            /// @brief serializes the document (in the same format as serialize(const JSONValue &)), appending to out
+            /// @param out the string to append to
+            /// @throws std::exception if the document is undefined
+            void write(JSONValue::StringType &out) const
+            {
+                if (nodes[root].type == JSONValue::JSONValueType::undefined)
+                {
+                    throw std::exception{"JSONSharedDocument was 'undefined' -- it can not be serialized!"};
+                }
+
+                std::vector<Formatted> formatted_nodes(nodes.size());
+                std::vector<Formatted> formatted_strings(strings.size());
+                write(root, out, formatted_nodes, formatted_strings);
+            }
+
+          private:
+            //--JSONSharedDocument Private Member Types-----------------------------------------------------------------
+
+            /// @brief the location of an interned string in the text buffer
+            struct StringSpan
+            {
+                std::uint32_t offset{0}; ///< the offset of the string
+                std::uint32_t size{0};   ///< the size of the string
+            };
+
+            /// @brief the location of something already formatted in the output
+            struct Formatted
+            {
+                std::size_t offset{0};                         ///< the offset of the formatted text
+                std::size_t size{JSONValue::StringType::npos}; ///< the size (npos if not formatted yet)
+            };
+
+            struct Builder;
+
+            //--JSONSharedDocument Member Variables---------------------------------------------------------------------
+
+            std::vector<Node>                  nodes{1};   ///< the node table (node 0 is the undefined node)
+            std::vector<NodeId>                children{}; ///< the children of array nodes
+            std::vector<Member>                members{};  ///< the members of object nodes
+            std::vector<JSONValue::NumberType> numbers{};  ///< the interned numbers
+            std::vector<StringSpan>            strings{};  ///< the interned strings
+            JSONValue::StringType              text{};     ///< the text of the interned strings
+            NodeId                             root{0};    ///< the root node
+            JSONDedupeReport                   report{};   ///< the memory report
+
+            //--JSONSharedDocument Helpers------------------------------------------------------------------------------
+
+            void write_string(std::uint32_t index, JSONValue::StringType &out, std::vector<Formatted> &formatted) const
+            {
+                if (formatted[index].size != JSONValue::StringType::npos)
+                {
+                    out.append(out, formatted[index].offset, formatted[index].size);
+                    return;
+                }
+
+                const std::size_t offset{out.size()};
+                JSONStringSink    sink{out};
+                JSONWriter<JSONDefaultFormat, JSONStringSink>{sink}.write_string(get_string(index));
+                formatted[index] = Formatted{.offset = offset, .size = out.size() - offset};
+            }
+
+            void write(
+                NodeId id, JSONValue::StringType &out, std::vector<Formatted> &formatted_nodes,
+                std::vector<Formatted> &formatted_strings) const
+            {
+                const Node &node{nodes[id]};
+                if (node.uses > 1 && formatted_nodes[id].size != JSONValue::StringType::npos)
+                {
+                    out.append(out, formatted_nodes[id].offset, formatted_nodes[id].size);
+                    return;
+                }
+
+                const std::size_t offset{out.size()};
+                switch (node.type)
+                {
+                case JSONValue::JSONValueType::literal:
+                    out.append(serialize(static_cast<JSONValue::LiteralType>(node.first)));
+                    break;
+                case JSONValue::JSONValueType::number: {
+                    JSONStringSink sink{out};
+                    JSONDefaultFormat::number(sink, numbers[node.first]);
+                    break;
+                }
+                case JSONValue::JSONValueType::string:
+                    write_string(node.first, out, formatted_strings);
+                    break;
+                case JSONValue::JSONValueType::array:
+                    out.push_back(u8'[');
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        out.append(i == node.first ? u8" " : u8", ");
+                        write(children[i], out, formatted_nodes, formatted_strings);
+                    }
+                    out.append(u8" ]");
+                    break;
+                case JSONValue::JSONValueType::object:
+                    out.push_back(u8'{');
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                    {
+                        out.append(i == node.first ? u8" " : u8", ");
+                        write_string(members[i].key, out, formatted_strings);
+                        out.append(u8" : ");
+                        write(members[i].value, out, formatted_nodes, formatted_strings);
+                    }
+                    out.append(u8" }");
+                    break;
+                case JSONValue::JSONValueType::undefined:
+                default:
+                    break;
+                }
+
+                if (node.uses > 1)
+                {
+                    formatted_nodes[id] = Formatted{.offset = offset, .size = out.size() - offset};
+                }
+            }
+        };
+
+        /// @brief interns the nodes of a document into a JSONSharedDocument
+        struct JSONSharedDocument::Builder
+        {
+            JSONSharedDocument &document; ///< the document being built
+
+            std::unordered_multimap<std::uint64_t, NodeId>        node_table{};   ///< nodes by shallow hash
+            std::unordered_multimap<std::uint64_t, std::uint32_t> string_table{}; ///< strings by hash
+            std::vector<NodeId>                                   child_stack{};  ///< children being collected
+            std::vector<Member>                                   member_stack{}; ///< members being collected
+
+            /// @brief the heap bytes used by a string (0 if the string is stored inline)
+            static std::size_t heap_bytes(const JSONValue::StringType &string) noexcept
+            {
+                return string.capacity() > JSONValue::StringType{}.capacity() ? string.capacity() + 1 : 0;
+            }
+
+            /// @brief casts a size to a 32-bit index
+            static std::uint32_t index(std::size_t size)
+            {
+                if (size > std::numeric_limits<std::uint32_t>::max())
+                {
+                    throw std::exception{"[ben::json::JSONSharedDocument::dedupe] the document is too large"};
+                }
+                return static_cast<std::uint32_t>(size);
+            }
+
+            std::uint32_t intern_string(const JSONValue::StringType &string)
+            {
+                const std::uint64_t h{JSONHasher::hash_bytes(string.data(), string.size())};
+                for (auto [it, end] = string_table.equal_range(h); it != end; ++it)
+                {
+                    if (document.get_string(it->second) == string)
+                    {
+                        return it->second;
+                    }
+                }
+
+                const std::uint32_t interned{index(document.strings.size())};
+                document.strings.push_back(
+                    StringSpan{.offset = index(document.text.size()), .size = index(string.size())});
+                document.text.append(string);
+                string_table.emplace(h, interned);
+                return interned;
+            }
+
+            /// @brief finds a node which is equal to a candidate, adding the candidate if there is none
+            /// @param node the candidate (for arrays/objects first is the offset into child_stack/member_stack)
+            /// @param h the shallow hash of the candidate
+            /// @param same a predicate deciding whether an existing node (of the same type) equals the candidate
+            template <typename Same> NodeId intern_node(Node node, std::uint64_t h, Same same)
+            {
+                for (auto [it, end] = node_table.equal_range(h); it != end; ++it)
+                {
+                    const Node &existing{document.nodes[it->second]};
+                    if (existing.type == node.type && existing.count == node.count && same(existing))
+                    {
+                        return it->second;
+                    }
+                }
+
+                // the children of a new node gain a reference (those of an existing node already have it)
+                if (node.type == JSONValue::JSONValueType::array)
+                {
+                    const std::size_t offset{node.first};
+                    node.first = index(document.children.size());
+                    for (std::size_t i = offset; i < offset + node.count; ++i)
+                    {
+                        document.children.push_back(child_stack[i]);
+                        ++document.nodes[child_stack[i]].uses;
+                    }
+                }
+                else if (node.type == JSONValue::JSONValueType::object)
+                {
+                    const std::size_t offset{node.first};
+                    node.first = index(document.members.size());
+                    for (std::size_t i = offset; i < offset + node.count; ++i)
+                    {
+                        document.members.push_back(member_stack[i]);
+                        ++document.nodes[member_stack[i].value].uses;
+                    }
+                }
+
+                const NodeId id{index(document.nodes.size())};
+                document.nodes.push_back(node);
+                node_table.emplace(h, id);
+                return id;
+            }
+
+            NodeId intern(const JSONValue &value)
+            {
+                ++document.report.nodes_before;
+
+                switch (value.type)
+                {
+                case JSONValue::JSONValueType::literal: {
+                    const auto literal{static_cast<std::uint32_t>(std::get<JSONValue::LiteralType>(value.value))};
+                    return intern_node(
+                        Node{.type = value.type, .first = literal}, JSONHasher::mix(0x100 + literal),
+                        [&](const Node &existing) { return existing.first == literal; });
+                }
+                case JSONValue::JSONValueType::number: {
+                    // +0 and -0 are equal but serialize differently, so they are not shared
+                    const JSONValue::NumberType number{std::get<JSONValue::NumberType>(value.value)};
+                    const NodeId                id{intern_node(
+                        Node{.type = value.type, .first = index(document.numbers.size())},
+                        JSONHasher::hash_number(number) ^ (std::signbit(number) ? 1 : 0),
+                        [&](const Node &existing)
+                        {
+                            const JSONValue::NumberType other{document.numbers[existing.first]};
+                            return other == number && std::signbit(other) == std::signbit(number);
+                        })};
+                    if (document.nodes[id].first == document.numbers.size())
+                    {
+                        document.numbers.push_back(number);
+                    }
+                    return id;
+                }
+                case JSONValue::JSONValueType::string: {
+                    const auto &string{std::get<JSONValue::StringType>(value.value)};
+                    document.report.bytes_before += heap_bytes(string);
+                    const std::uint32_t interned{intern_string(string)};
+                    return intern_node(
+                        Node{.type = value.type, .first = interned}, JSONHasher::mix(0x300 ^ interned),
+                        [&](const Node &existing) { return existing.first == interned; });
+                }
+                case JSONValue::JSONValueType::array: {
+                    const auto &array{std::get<JSONValue::ArrayType>(value.value)};
+                    document.report.bytes_before += array.capacity() * sizeof(JSONValue);
+
+                    const std::size_t offset{child_stack.size()};
+                    for (const auto &element : array)
+                    {
+                        if (element.type != JSONValue::JSONValueType::undefined)
+                        {
+                            const NodeId child{intern(element)};
+                            child_stack.push_back(child);
+                        }
+                    }
+
+                    const std::uint32_t count{index(child_stack.size() - offset)};
+                    const NodeId *const first{child_stack.data() + offset};
+                    JSONHasher          hasher{0x400};
+                    hasher.update(first, count * sizeof(NodeId));
+
+                    const NodeId id{intern_node(
+                        Node{.type = value.type, .first = index(offset), .count = count}, hasher.finish(),
+                        [&](const Node &existing)
+                        { return std::equal(first, first + count, document.children.begin() + existing.first); })};
+                    child_stack.resize(offset);
+                    return id;
+                }
+                case JSONValue::JSONValueType::object: {
+                    const auto &object{std::get<JSONValue::ObjectType>(value.value)};
+                    document.report.bytes_before += object.bucket_count() * sizeof(void *) +
+                                                    object.size() * (sizeof(JSONValue::ObjectType::value_type) +
+                                                                     2 * sizeof(void *));
+
+                    const std::size_t offset{member_stack.size()};
+                    for (const auto &[key, member] : object)
+                    {
+                        document.report.bytes_before += heap_bytes(key);
+                        if (member.type != JSONValue::JSONValueType::undefined)
+                        {
+                            const std::uint32_t interned{intern_string(key)};
+                            const NodeId        child{intern(member)};
+                            member_stack.push_back(Member{.key = interned, .value = child});
+                        }
+                    }
+
+                    const std::uint32_t count{index(member_stack.size() - offset)};
+                    Member *const       first{member_stack.data() + offset};
+                    std::sort(
+                        first, first + count, [&](const Member &lhs, const Member &rhs)
+                        { return document.get_string(lhs.key) < document.get_string(rhs.key); });
+                    JSONHasher hasher{0x500};
+                    for (const Member *member = first; member != first + count; ++member)
+                    {
+                        hasher.update(&member->key, sizeof(member->key));
+                        hasher.update(&member->value, sizeof(member->value));
+                    }
+
+                    const auto same_member = [](const Member &lhs, const Member &rhs)
+                    { return lhs.key == rhs.key && lhs.value == rhs.value; };
+                    const NodeId id{intern_node(
+                        Node{.type = value.type, .first = index(offset), .count = count}, hasher.finish(),
+                        [&](const Node &existing)
+                        {
+                            return std::equal(
+                                first, first + count, document.members.begin() + existing.first, same_member);
+                        })};
+                    member_stack.resize(offset);
+                    return id;
+                }
+                case JSONValue::JSONValueType::undefined:
+                default:
+                    --document.report.nodes_before;
+                    return 0;
+                }
+            }
+        };
+
+        inline JSONSharedDocument JSONSharedDocument::dedupe(const JSONValue &document)
+        {
+            JSONSharedDocument shared{};
+            Builder            builder{.document = shared};
+
+            shared.report.bytes_before = sizeof(JSONValue);
+            shared.root                = builder.intern(document);
+            ++shared.nodes[shared.root].uses;
+
+            shared.nodes.shrink_to_fit();
+            shared.children.shrink_to_fit();
+            shared.members.shrink_to_fit();
+            shared.numbers.shrink_to_fit();
+            shared.strings.shrink_to_fit();
+            shared.text.shrink_to_fit();
+
+            shared.report.nodes_after = shared.nodes.size() - 1;
+            shared.report.bytes_after =
+                sizeof(JSONSharedDocument) + shared.nodes.capacity() * sizeof(Node) +
+                shared.children.capacity() * sizeof(NodeId) + shared.members.capacity() * sizeof(Member) +
+                shared.numbers.capacity() * sizeof(JSONValue::NumberType) +
+                shared.strings.capacity() * sizeof(StringSpan) + Builder::heap_bytes(shared.text);
+            return shared;
+        }
+
+        /// @brief deduplicates a document, sharing its equal subtrees
+        /// @param document the document to deduplicate
+        /// @return the deduplicated (immutable) document
+        /// @see JSONSharedDocument
+        inline JSONSharedDocument dedupe(const JSONValue &document) { return JSONSharedDocument::dedupe(document); }
+
+        /// @brief serializes a deduplicated document; shared subtrees are formatted once and copied thereafter
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONSharedDocument)
+        {
+            std::u8string serialized{u8""};
+            val.write(serialized);
+            return serialized;
+        }
+
+        //--JSON Schema-------------------------------------------------------------------------------------------------
+
+        /// @brief the outcome of validating a document against a JSONSchema
+        struct JSONSchemaResult
+        {
+            /// @brief true if the document is valid
+            bool valid{true};
+
+            /// @brief the index of the event (i.e. value, key, or end of a container) at which validation failed
+            std::size_t failed_event{std::numeric_limits<std::size_t>::max()};
+
+            /// @brief why the document is invalid (a static string)
+            const char *reason{""};
+
+            /// @brief true if the document is valid
+            explicit operator bool() const noexcept { return valid; }
+        };
+
+        /// @brief a JSON Schema which has been compiled (once) into a flat validation program
+        ///
+        /// supports the following subset of JSON Schema (draft 2020-12):
+        ///     - boolean schemas (true and false)
+        ///     - type (a type name or an array of them; "integer" matches numbers without a fractional part)
+        ///     - enum and const
+        ///     - minimum, maximum, exclusiveMinimum, and exclusiveMaximum
+        ///     - minLength and maxLength (counted in code points) and pattern (see below)
+        ///     - items (a schema applied to every element), minItems, and maxItems
+        ///     - properties, required, additionalProperties, minProperties, and maxProperties
+        ///     - the annotations $schema, $id, $comment, $defs, definitions, title, description, default, examples,
+        ///       deprecated, readOnly, writeOnly, contentEncoding, contentMediaType, and format (which, as in 2020-12,
+        ///       does not assert anything)
+        ///
+        /// any other keyword (e.g. anyOf or $ref) makes compile() throw, since ignoring it would accept documents the
+        /// schema rejects; compiling with strict set to false ignores such keywords instead
+        ///
+        /// every (sub)schema becomes a fixed size Rule in a single table. The properties of an object schema are stored
+        /// in an open-addressing hash table (keyed by the same hash the key lookup computes once per key), so looking
+        /// up the rule of a member, checking whether it is required, and deciding whether it is an additional property
+        /// is a single probe
+        ///
+        /// patterns are ECMA-262 regular expressions restricted to: literals, '.', classes ([...], [^...], ranges,
+        /// \\d \\w \\s), anchors (^ and $), groups ((...) and (?:...)), alternation, and the quantifiers *, +, ?, {n},
+        /// {n,}, and {n,m}. They are compiled to a small NFA program which is searched (unanchored, like "pattern"
+        /// requires) in linear time without backtracking
+        ///
+        /// documents are validated by a JSONSchema::Validator, either from a JSONValue (walked without recursion) or
+        /// from a stream of parse events, in a single pass; a Validator does not allocate once its buffers have grown
+        /// to the depth of the documents it validates
+        ///
+        /// @remark compile() throws on malformed schemas; validation itself never throws
+        class JSONSchema
+        {
+          public:
+            //--JSONSchema Member Types---------------------------------------------------------------------------------
+
+            /// @brief the bits of the type mask of a Rule
+            enum TypeBit : std::uint8_t
+            {
+                null_bit     = 1 << 0, ///< null
+                boolean_bit  = 1 << 1, ///< true and false
+                integer_bit  = 1 << 2, ///< numbers without a fractional part
+                fraction_bit = 1 << 3, ///< numbers with a fractional part
+                string_bit   = 1 << 4, ///< strings
+                array_bit    = 1 << 5, ///< arrays
+                object_bit   = 1 << 6, ///< objects
+                any_bits     = 0x7f,   ///< every type
+            };
+
+            /// @brief marks an absent index (no pattern, no enum, ...)
+            static constexpr std::uint32_t none{std::numeric_limits<std::uint32_t>::max()};
+
+            /// @brief the index of the rule which accepts everything (the schema true)
+            static constexpr std::uint32_t accept_rule{0};
+
+            /// @brief the index of the rule which rejects everything (the schema false)
+            static constexpr std::uint32_t reject_rule{1};
+
+            /// @brief a compiled (sub)schema
+            struct Rule
+            {
+                using Limits = std::numeric_limits<JSONValue::NumberType>;
+
+                std::uint8_t          types{any_bits};              ///< the allowed types
+                bool                  structured_enum{false};       ///< true if the enum has arrays/objects
+                JSONValue::NumberType minimum{-Limits::infinity()}; ///< the minimum
+                JSONValue::NumberType maximum{Limits::infinity()};  ///< the maximum
+                bool                  exclusive_minimum{false};     ///< true if the minimum is not allowed
+                bool                  exclusive_maximum{false};     ///< true if the maximum is not allowed
+                std::uint32_t         min_length{0};                ///< minLength
+                std::uint32_t         max_length{none};             ///< maxLength
+                std::uint32_t         pattern{none};                ///< the index of the pattern
+                std::uint32_t         enum_first{none};             ///< the index of the first allowed value
+                std::uint32_t         enum_count{0};                ///< the number of allowed values
+                std::uint32_t         items{accept_rule};           ///< the rule of the elements of arrays
+                std::uint32_t         min_items{0};                 ///< minItems
+                std::uint32_t         max_items{none};              ///< maxItems
+                std::uint32_t         table_first{0};               ///< the index of the first property slot
+                std::uint32_t         table_size{0};                ///< the number of property slots (a power of two)
+                std::uint32_t         required_count{0};            ///< the number of required properties
+                std::uint32_t         additional{accept_rule};      ///< the rule of additional properties
+                std::uint32_t         min_properties{0};            ///< minProperties
+                std::uint32_t         max_properties{none};         ///< maxProperties
+            };
+
+            /// @brief a slot of the property table of an object rule
+            struct PropertySlot
+            {
+                std::uint64_t hash{0};           ///< the hash of the key (0 marks an empty slot)
+                std::uint32_t key_offset{0};     ///< the offset of the key in the key buffer
+                std::uint32_t key_size{0};       ///< the size of the key
+                std::uint32_t rule{accept_rule}; ///< the rule of the property value
+                bool          required{false};   ///< true if the property is required
+            };
+
+            /// @brief an instruction of a compiled pattern; jumps are relative so that fragments can be copied
+            struct PatternInstruction
+            {
+                /// @brief the operations a pattern program is made of
+                enum struct Op : std::uint8_t
+                {
+                    code_point, ///< consume the code point a
+                    any,        ///< consume any code point except line terminators
+                    range_set,  ///< consume a code point in (x == 0) or not in (x != 0) the ranges [a, a + b)
+                    split,      ///< continue at both +x and +y
+                    jump,       ///< continue at +x
+                    begin,      ///< assert the start of the input
+                    end,        ///< assert the end of the input
+                    match,      ///< the pattern matched
+                };
+
+                Op            op{Op::match}; ///< the operation
+                std::uint32_t a{0};          ///< the first operand
+                std::uint32_t b{0};          ///< the second operand
+                std::int32_t  x{0};          ///< the first relative target (or flag)
+                std::int32_t  y{0};          ///< the second relative target
+            };
+
+            /// @brief validates documents against a JSONSchema
+            ///
+            /// a document is either passed as a JSONValue to validate(...) or fed as a stream of parse events (the
+            /// on_... functions, in document order) followed by finish(). Validation stops checking at the first error;
+            /// a Validator can be reused (validate(...) and reset() start over) and keeps its buffers between
+            /// documents
+            class Validator
+            {
+              public:
+                //--Validator Ctors-------------------------------------------------------------------------------------
+
+                /// @brief creates a validator for a schema
+                /// @param schema the schema (which must outlive the validator)
+                explicit Validator(const JSONSchema &schema) :
+                    schema{&schema}, required_marks(schema.slots.size(), 0) { };
+
+                //--Validator Events------------------------------------------------------------------------------------
+
+                /// @brief starts validating a new document
+                void reset() noexcept
+                {
+                    frames.clear();
+                    captures.clear();
+                    has_root = false;
+                    events   = 0;
+                    result   = JSONSchemaResult{};
+                }
+
+                /// @brief a literal (null, true, or false)
+                void on_literal(JSONValue::LiteralType literal);
+
+                /// @brief a number
+                void on_number(JSONValue::NumberType number);
+
+                /// @brief a string
+                void on_string(std::u8string_view string);
+
+                /// @brief the start of an array
+                /// @param source the array as a JSONValue if there is one (allows comparing it to enum values directly
+                /// instead of capturing a copy of it)
+                void on_begin_array(const JSONValue *source = nullptr);
+
+                /// @brief the end of an array
+                void on_end_array();
+
+                /// @brief the start of an object
+                /// @param source the object as a JSONValue if there is one (see on_begin_array(...))
+                void on_begin_object(const JSONValue *source = nullptr);
+
+                /// @brief the key of the next member of an object
+                void on_key(std::u8string_view key);
+
+                /// @brief the end of an object
+                void on_end_object();
+
+                /// @brief ends the document
+                /// @return the outcome of the validation
+                JSONSchemaResult finish()
+                {
+                    if (result.valid && (!has_root || !frames.empty()))
+                    {
+                        fail("the document is incomplete");
+                    }
+                    return result;
+                }
+
+                //--Validator Validation--------------------------------------------------------------------------------
+
+                /// @brief validates a document in one pass, without recursion
+                /// @param document the document to validate
+                /// @return the outcome of the validation
+                JSONSchemaResult validate(const JSONValue &document);
+
+              private:
+                //--Validator Member Types------------------------------------------------------------------------------
+
+                /// @brief the validation state of an open array/object
+                struct Frame
+                {
+                    std::uint32_t    rule{accept_rule};      ///< the rule of the container
+                    std::uint32_t    count{0};               ///< the number of elements/members so far
+                    std::uint32_t    required_seen{0};       ///< the number of required members so far
+                    std::uint32_t    next_rule{accept_rule}; ///< the rule of the next member (set by on_key(...))
+                    std::uint32_t    mark{0};                ///< marks the required members seen (objects)
+                    const JSONValue *source{nullptr};        ///< the container as a JSONValue (if there is one)
+                    std::uint64_t    hash{0};                ///< the running structural hash (if hashing)
+                    std::uint64_t    key_hash{0};            ///< the hash of the key of the next member
+                    bool             object{false};          ///< true for objects, false for arrays
+                    bool             hashing{false};         ///< true if the container is hashed and captured
+                };
+
+                /// @brief a copy of a container which has to be compared to structured enum values
+                struct Capture
+                {
+                    JSONValue             value{}; ///< the container so far
+                    JSONValue::StringType key{};   ///< the key of the next member (objects)
+                };
+
+                /// @brief a container being walked by validate(...)
+                struct WalkFrame
+                {
+                    const JSONValue                      *node{nullptr}; ///< the container
+                    std::size_t                           index{0};      ///< the next element (arrays)
+                    JSONValue::ObjectType::const_iterator member{};      ///< the next member (objects)
+                };
+
+                //--Validator Member Variables--------------------------------------------------------------------------
+
+                const JSONSchema          *schema{nullptr}; ///< the schema
+                std::vector<Frame>         frames{};        ///< the open containers
+                std::vector<WalkFrame>     walk{};          ///< the containers being walked by validate(...)
+                std::vector<std::uint32_t> current{};       ///< pattern threads at the current position
+                std::vector<std::uint32_t> next{};          ///< pattern threads at the next position
+                std::vector<std::uint32_t> marks{};         ///< the generation each instruction was last added in
+                std::vector<std::uint32_t> pending{};       ///< instructions still to be added (epsilon closure)
+                std::uint32_t              generation{0};   ///< the current pattern generation
+                std::vector<std::uint32_t> required_marks;  ///< the mark of the object each slot was last seen in
+                std::uint32_t              object_mark{0};  ///< the mark of the most recent object
+                std::vector<Capture>       captures{};      ///< the containers being captured (see Frame::hashing)
+                bool                       has_root{false}; ///< true once the root value has started
+                std::size_t                events{0};       ///< the number of events so far
+                JSONSchemaResult           result{};        ///< the outcome so far
+
+                //--Validator Helpers-----------------------------------------------------------------------------------
+
+                void fail(const char *reason) noexcept
+                {
+                    if (result.valid)
+                    {
+                        result = JSONSchemaResult{.valid = false, .failed_event = events, .reason = reason};
+                    }
+                }
+
+                /// @brief the rule of the value which is about to start (nullptr if it is not allowed at all)
+                const Rule *begin_value();
+
+                /// @brief folds the hash of a completed value into its parent's running hash and adds the value to
+                /// the parent's capture (only called if the parent is hashing)
+                void end_value(std::uint64_t h, JSONValue &&value);
+
+                /// @brief true if a completed container matches one of the enum values of its rule
+                bool is_allowed(const Rule &rule, const Frame &frame, std::uint64_t h, const JSONValue &captured) const;
+
+                /// @brief checks the parts of a rule which apply to any value: the type and enum
+                bool check_type(const Rule &rule, std::uint8_t type_bit);
+
+                /// @brief adds an instruction (and everything reachable from it without consuming input) to a list
+                /// @return true if the pattern matched
+                bool add_thread(
+                    std::vector<std::uint32_t> &list, std::uint32_t first, std::uint32_t pc, std::size_t position,
+                    std::size_t size);
+
+                /// @brief searches a string for a match of a pattern
+                bool search(std::uint32_t pattern, std::u8string_view text);
+            };
+
+            //--JSONSchema Ctors----------------------------------------------------------------------------------------
+
+            /// @brief compiles a schema
+            /// @param schema the schema (a JSON Schema document)
+            /// @param strict if true, unsupported keywords are an error; otherwise they are ignored
+            /// @return the compiled schema
+            /// @throws std::exception if the schema is malformed or uses an unsupported keyword or pattern feature
+            static JSONSchema compile(const JSONValue &schema, bool strict = true);
+
+            //--JSONSchema Accessors------------------------------------------------------------------------------------
+
+            /// @brief the rule table (the root rule is get_rules()[get_root()])
+            const std::vector<Rule> &get_rules() const noexcept { return rules; }
+
+            /// @brief the index of the root rule
+            std::uint32_t get_root() const noexcept { return root; }
+
+            //--JSONSchema Validation-----------------------------------------------------------------------------------
+
+            /// @brief validates a document (using a temporary Validator)
+            /// @param document the document to validate
+            /// @return the outcome of the validation
+            JSONSchemaResult validate(const JSONValue &document) const { return Validator{*this}.validate(document); }
+
+          private:
+            //--JSONSchema Member Types---------------------------------------------------------------------------------
+
+            struct Compiler;
+            struct PatternCompiler;
+
+            /// @brief a compiled pattern: the instructions [first, first + count)
+            struct Pattern
+            {
+                std::uint32_t first{0}; ///< the index of the first instruction
+                std::uint32_t count{0}; ///< the number of instructions
+            };
+
+            //--JSONSchema Member Variables-----------------------------------------------------------------------------
+
+            std::vector<Rule>                          rules{};           ///< the rules (0 accepts, 1 rejects all)
+            std::vector<PropertySlot>                  slots{};           ///< the property tables of object rules
+            JSONValue::StringType                      keys{};            ///< the text of the property keys
+            std::vector<JSONValue>                     enum_values{};     ///< the enum values (hashes cached)
+            std::vector<Pattern>                       patterns{};        ///< the patterns
+            std::vector<PatternInstruction>            instructions{};    ///< the instructions of all patterns
+            std::vector<std::pair<char32_t, char32_t>> ranges{};          ///< the (inclusive) ranges of range sets
+            std::uint32_t                              root{accept_rule}; ///< the root rule
+
+            //--JSONSchema Helpers--------------------------------------------------------------------------------------
+
+            /// @brief finds the property slot of a key (nullptr if the rule has no such property)
+            const PropertySlot *find_property(const Rule &rule, std::u8string_view key, std::uint64_t h) const noexcept
+            {
+                if (rule.table_size == 0)
+                {
+                    return nullptr;
+                }
+
+                const std::uint32_t mask{rule.table_size - 1};
+                for (std::uint32_t i = static_cast<std::uint32_t>(h) & mask;; i = (i + 1) & mask)
+                {
+                    const PropertySlot &slot{slots[rule.table_first + i]};
+                    if (slot.hash == 0)
+                    {
+                        return nullptr;
+                    }
+                    if (slot.hash == h && std::u8string_view{keys}.substr(slot.key_offset, slot.key_size) == key)
+                    {
+                        return &slot;
+                    }
+                }
+            }
+
+            /// @brief decodes the UTF-8 code point at an offset (invalid bytes decode as themselves)
+            /// @return the code point and the number of bytes it takes up
+            static std::pair<char32_t, std::size_t> decode(std::u8string_view text, std::size_t offset) noexcept
+            {
+                const char8_t     lead{text[offset]};
+                const std::size_t size{lead < 0x80 ? 1u
+                                       : (lead >> 5) == 0x06 ? 2u
+                                       : (lead >> 4) == 0x0e ? 3u
+                                       : (lead >> 3) == 0x1e ? 4u
+                                                             : 0u};
+                if (size == 0 || offset + size > text.size())
+                {
+                    return {lead, 1};
+                }
+
+                char32_t code_point{size == 1 ? lead : static_cast<char32_t>(lead & (0x7f >> size))};
+                for (std::size_t i = 1; i < size; ++i)
+                {
+                    if ((text[offset + i] & 0xc0) != 0x80)
+                    {
+                        return {lead, 1};
+                    }
+                    code_point = (code_point << 6) | (text[offset + i] & 0x3f);
+                }
+                return {code_point, size};
+            }
+        };
+
+        /// @brief compiles JSON Schema patterns (see JSONSchema) into instructions
+        ///
+        /// a recursive descent parser producing self-contained fragments (all jumps are relative), which makes
+        /// concatenating, alternating, and repeating fragments a matter of copying them
+        struct JSONSchema::PatternCompiler
+        {
+            using Fragment = std::vector<PatternInstruction>;
+            using Op       = PatternInstruction::Op;
+
+            /// @brief the largest number of instructions a pattern may compile to
+            static constexpr std::size_t max_instructions{1 << 16};
+
+            std::u8string_view text{}; ///< the pattern being compiled
+            std::size_t        pos{0}; ///< the current position in the pattern
+            JSONSchema        &schema; ///< the schema being built (owns the range sets)
+
+            [[noreturn]] void fail(const char *what) const
+            {
+                std::string message{"[ben::json::JSONSchema::compile] pattern: "};
+                message.append(what);
+                message.append(" at offset ");
+                message.append(std::to_string(pos));
+                throw std::exception{message.c_str()};
+            }
+
+            bool at_end() const noexcept { return pos >= text.size(); }
+
+            char8_t peek() const noexcept { return at_end() ? u8'\0' : text[pos]; }
+
+            static void append(Fragment &to, const Fragment &from)
+            {
+                to.insert(to.end(), from.begin(), from.end());
+                if (to.size() > max_instructions)
+                {
+                    throw std::exception{"[ben::json::JSONSchema::compile] pattern: the pattern is too large"};
+                }
+            }
+
+            static std::int32_t size_of(const Fragment &fragment) { return static_cast<std::int32_t>(fragment.size()); }
+
+            /// @brief compiles the whole pattern
+            Fragment compile()
+            {
+                Fragment fragment{alternation()};
+                if (!at_end())
+                {
+                    fail("unbalanced ')'");
+                }
+                fragment.push_back(PatternInstruction{.op = Op::match});
+                return fragment;
+            }
+
+            Fragment alternation()
+            {
+                Fragment first{concatenation()};
+                if (peek() != u8'|')
+                {
+                    return first;
+                }
+                ++pos;
+                const Fragment second{alternation()};
+
+                // split(+1, +first + 2), first, jump(+second + 1), second
+                Fragment fragment{PatternInstruction{.op = Op::split, .x = 1, .y = size_of(first) + 2}};
+                append(fragment, first);
+                fragment.push_back(PatternInstruction{.op = Op::jump, .x = size_of(second) + 1});
+                append(fragment, second);
+                return fragment;
+            }
+
+            Fragment concatenation()
+            {
+                Fragment fragment{};
+                while (!at_end() && peek() != u8'|' && peek() != u8')')
+                {
+                    append(fragment, repetition());
+                }
+                return fragment;
+            }
+
+            std::uint32_t count()
+            {
+                if (peek() < u8'0' || peek() > u8'9')
+                {
+                    fail("expected a repetition count");
+                }
+                std::uint32_t value{0};
+                while (peek() >= u8'0' && peek() <= u8'9')
+                {
+                    value = value * 10 + (text[pos++] - u8'0');
+                    if (value > 1000)
+                    {
+                        fail("repetition counts may not exceed 1000");
+                    }
+                }
+                return value;
+            }
+
+            static Fragment optional(const Fragment &atom)
+            {
+                Fragment fragment{PatternInstruction{.op = Op::split, .x = 1, .y = size_of(atom) + 1}};
+                append(fragment, atom);
+                return fragment;
+            }
+
+            static Fragment star(const Fragment &atom)
+            {
+                Fragment fragment{PatternInstruction{.op = Op::split, .x = 1, .y = size_of(atom) + 2}};
+                append(fragment, atom);
+                fragment.push_back(PatternInstruction{.op = Op::jump, .x = -(size_of(atom) + 1)});
+                return fragment;
+            }
+
+            Fragment repetition()
+            {
+                const Fragment atom{this->atom()};
+
+                std::uint32_t minimum{1};
+                std::uint32_t maximum{1};
+                switch (peek())
+                {
+                case u8'*':
+                    minimum = 0;
+                    maximum = none;
+                    break;
+                case u8'+':
+                    maximum = none;
+                    break;
+                case u8'?':
+                    minimum = 0;
+                    break;
+                case u8'{':
+                    ++pos;
+                    minimum = count();
+                    maximum = minimum;
+                    if (peek() == u8',')
+                    {
+                        ++pos;
+                        maximum = peek() == u8'}' ? none : count();
+                    }
+                    if (peek() != u8'}' || maximum < minimum)
+                    {
+                        fail("malformed repetition");
+                    }
+                    break;
+                default:
+                    return atom;
+                }
+                ++pos;
+                if (peek() == u8'?')
+                {
+                    ++pos; // lazy quantifiers match the same strings
+                }
+
+                Fragment fragment{};
+                for (std::uint32_t i = 0; i < minimum; ++i)
+                {
+                    append(fragment, atom);
+                }
+                if (maximum == none)
+                {
+                    append(fragment, star(atom));
+                }
+                else
+                {
+                    for (std::uint32_t i = minimum; i < maximum; ++i)
+                    {
+                        append(fragment, optional(atom));
+                    }
+                }
+                return fragment;
+            }
+
+            /// @brief adds a range to the schema's range table
+            void add_range(char32_t first, char32_t last) { schema.ranges.emplace_back(first, last); }
+
+            /// @brief adds the ranges of a class escape (\\d, \\w, or \\s)
+            /// @return false if the escape is not a class escape
+            bool add_class_escape(char8_t escape)
+            {
+                switch (escape)
+                {
+                case u8'd':
+                    add_range(U'0', U'9');
+                    return true;
+                case u8'w':
+                    add_range(U'0', U'9');
+                    add_range(U'A', U'Z');
+                    add_range(U'_', U'_');
+                    add_range(U'a', U'z');
+                    return true;
+                case u8's':
+                    add_range(U'\t', U'\r');
+                    add_range(U' ', U' ');
+                    add_range(0xa0, 0xa0);
+                    add_range(0x1680, 0x1680);
+                    add_range(0x2000, 0x200a);
+                    add_range(0x2028, 0x2029);
+                    add_range(0x202f, 0x202f);
+                    add_range(0x205f, 0x205f);
+                    add_range(0x3000, 0x3000);
+                    add_range(0xfeff, 0xfeff);
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            /// @brief the code point of a (non-class) escape; pos is just past the backslash
+            char32_t escaped_code_point()
+            {
+                if (at_end())
+                {
+                    fail("incomplete escape");
+                }
+                const char8_t escape{text[pos++]};
+                switch (escape)
+                {
+                case u8'n':
+                    return U'\n';
+                case u8'r':
+                    return U'\r';
+                case u8't':
+                    return U'\t';
+                case u8'f':
+                    return U'\f';
+                case u8'v':
+                    return U'\v';
+                case u8'0':
+                    return U'\0';
+                case u8'u': {
+                    char32_t code_point{0};
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const char8_t digit{peek()};
+                        ++pos;
+                        if (digit >= u8'0' && digit <= u8'9')
+                        {
+                            code_point = code_point * 16 + (digit - u8'0');
+                        }
+                        else if ((digit | 0x20) >= u8'a' && (digit | 0x20) <= u8'f')
+                        {
+                            code_point = code_point * 16 + ((digit | 0x20) - u8'a' + 10);
+                        }
+                        else
+                        {
+                            fail("malformed \\u escape");
+                        }
+                    }
+                    return code_point;
+                }
+                default:
+                    if ((escape >= u8'a' && escape <= u8'z') || (escape >= u8'A' && escape <= u8'Z') ||
+                        (escape >= u8'1' && escape <= u8'9'))
+                    {
+                        fail("unsupported escape");
+                    }
+                    return escape;
+                }
+            }
+
+            /// @brief the next code point of the pattern (literally)
+            char32_t literal_code_point()
+            {
+                const auto [code_point, size]{decode(text, pos)};
+                pos += size;
+                return code_point;
+            }
+
+            Fragment range_set()
+            {
+                const std::uint32_t first{static_cast<std::uint32_t>(schema.ranges.size())};
+                const bool          negated{peek() == u8'^'};
+                pos += negated ? 1 : 0;
+
+                for (bool leading{true}; leading || peek() != u8']'; leading = false)
+                {
+                    if (at_end())
+                    {
+                        fail("unterminated character class");
+                    }
+
+                    char32_t low{0};
+                    if (peek() == u8'\\')
+                    {
+                        ++pos;
+                        if (add_class_escape(peek()))
+                        {
+                            ++pos;
+                            continue;
+                        }
+                        low = peek() == u8'b' ? (++pos, U'\b') : escaped_code_point();
+                    }
+                    else
+                    {
+                        low = literal_code_point();
+                    }
+
+                    char32_t high{low};
+                    if (peek() == u8'-' && pos + 1 < text.size() && text[pos + 1] != u8']')
+                    {
+                        ++pos;
+                        if (peek() == u8'\\')
+                        {
+                            ++pos;
+                            high = escaped_code_point();
+                        }
+                        else
+                        {
+                            high = literal_code_point();
+                        }
+                        if (high < low)
+                        {
+                            fail("character class range out of order");
+                        }
+                    }
+                    add_range(low, high);
+                }
+                ++pos; // ']'
+
+                return Fragment{PatternInstruction{
+                    .op = Op::range_set,
+                    .a  = first,
+                    .b  = static_cast<std::uint32_t>(schema.ranges.size()) - first,
+                    .x  = negated ? 1 : 0}};
+            }
+
+            Fragment atom()
+            {
+                const char8_t c{peek()};
+                switch (c)
+                {
+                case u8'(': {
+                    ++pos;
+                    if (peek() == u8'?')
+                    {
+                        if (pos + 1 >= text.size() || text[pos + 1] != u8':')
+                        {
+                            fail("lookarounds are not supported");
+                        }
+                        pos += 2;
+                    }
+                    Fragment fragment{alternation()};
+                    if (peek() != u8')')
+                    {
+                        fail("unbalanced '('");
+                    }
+                    ++pos;
+                    return fragment;
+                }
+                case u8'[':
+                    ++pos;
+                    return range_set();
+                case u8'.':
+                    ++pos;
+                    return Fragment{PatternInstruction{.op = Op::any}};
+                case u8'^':
+                    ++pos;
+                    return Fragment{PatternInstruction{.op = Op::begin}};
+                case u8'$':
+                    ++pos;
+                    return Fragment{PatternInstruction{.op = Op::end}};
+                case u8'*':
+                case u8'+':
+                case u8'?':
+                case u8'{':
+                    fail("nothing to repeat");
+                case u8'\\': {
+                    ++pos;
+                    const char8_t escape{peek()};
+                    const bool    negated{escape == u8'D' || escape == u8'W' || escape == u8'S'};
+                    const std::uint32_t first{static_cast<std::uint32_t>(schema.ranges.size())};
+                    if (add_class_escape(negated ? static_cast<char8_t>(escape | 0x20) : escape))
+                    {
+                        ++pos;
+                        return Fragment{PatternInstruction{
+                            .op = Op::range_set,
+                            .a  = first,
+                            .b  = static_cast<std::uint32_t>(schema.ranges.size()) - first,
+                            .x  = negated ? 1 : 0}};
+                    }
+                    return Fragment{PatternInstruction{.op = Op::code_point, .a = escaped_code_point()}};
+                }
+                default:
+                    return Fragment{PatternInstruction{.op = Op::code_point, .a = literal_code_point()}};
+                }
+            }
+        };
+
+        /// @brief compiles JSON Schema documents into rules (see JSONSchema)
+        struct JSONSchema::Compiler
+        {
+            JSONSchema &schema;       ///< the schema being built
+            bool        strict{true}; ///< true if unsupported keywords are an error
+
+            /// @brief the keywords compile(...) understands (assertions, applicators, and ignored annotations)
+            static constexpr std::array<std::u8string_view, 33> keywords{
+                u8"type", u8"enum", u8"const", u8"minimum", u8"maximum", u8"exclusiveMinimum", u8"exclusiveMaximum",
+                u8"minLength", u8"maxLength", u8"pattern", u8"items", u8"minItems", u8"maxItems", u8"properties",
+                u8"required", u8"additionalProperties", u8"minProperties", u8"maxProperties", u8"$schema", u8"$id",
+                u8"$comment", u8"$defs", u8"definitions", u8"title", u8"description", u8"default", u8"examples",
+                u8"deprecated", u8"readOnly", u8"writeOnly", u8"format", u8"contentEncoding", u8"contentMediaType"};
+
+            [[noreturn]] static void fail(const char *what)
+            {
+                std::string message{"[ben::json::JSONSchema::compile] "};
+                message.append(what);
+                throw std::exception{message.c_str()};
+            }
+
+            static const JSONValue *member(const JSONValue::ObjectType &object, const char8_t *key)
+            {
+                const auto found{object.find(key)};
+                return (found == object.end() || found->second.type == JSONValue::JSONValueType::undefined)
+                           ? nullptr
+                           : &found->second;
+            }
+
+            static JSONValue::NumberType number(const JSONValue *value, const char *what)
+            {
+                if (value->type != JSONValue::JSONValueType::number)
+                {
+                    fail(what);
+                }
+                return std::get<JSONValue::NumberType>(value->value);
+            }
+
+            static std::uint32_t count(const JSONValue *value, const char *what)
+            {
+                const JSONValue::NumberType n{number(value, what)};
+                if (n < 0 || n != std::floor(n) || n > std::numeric_limits<std::uint32_t>::max() - 1)
+                {
+                    fail(what);
+                }
+                return static_cast<std::uint32_t>(n);
+            }
+
+            static std::uint8_t type_bits(const JSONValue &name)
+            {
+                if (name.type != JSONValue::JSONValueType::string)
+                {
+                    fail("\"type\" must be a type name or an array of type names");
+                }
+
+                const auto &type{std::get<JSONValue::StringType>(name.value)};
+                if (type == u8"null")
+                {
+                    return null_bit;
+                }
+                if (type == u8"boolean")
+                {
+                    return boolean_bit;
+                }
+                if (type == u8"integer")
+                {
+                    return integer_bit;
+                }
+                if (type == u8"number")
+                {
+                    return integer_bit | fraction_bit;
+                }
+                if (type == u8"string")
+                {
+                    return string_bit;
+                }
+                if (type == u8"array")
+                {
+                    return array_bit;
+                }
+                if (type == u8"object")
+                {
+                    return object_bit;
+                }
+                fail("unknown type name");
+            }
+
+            std::uint32_t compile_pattern(const JSONValue::StringType &text)
+            {
+                PatternCompiler     compiler{.text = text, .schema = schema};
+                const auto          fragment{compiler.compile()};
+                const std::uint32_t index{static_cast<std::uint32_t>(schema.patterns.size())};
+                schema.patterns.push_back(Pattern{
+                    .first = static_cast<std::uint32_t>(schema.instructions.size()),
+                    .count = static_cast<std::uint32_t>(fragment.size())});
+                schema.instructions.insert(schema.instructions.end(), fragment.begin(), fragment.end());
+                return index;
+            }
+
+            void add_enum_value(Rule &rule, const JSONValue &value)
+            {
+                if (rule.enum_first == none)
+                {
+                    rule.enum_first = static_cast<std::uint32_t>(schema.enum_values.size());
+                }
+                schema.enum_values.push_back(value);
+                cache_hash(schema.enum_values.back());
+                ++rule.enum_count;
+                rule.structured_enum = rule.structured_enum || value.type == JSONValue::JSONValueType::array ||
+                                       value.type == JSONValue::JSONValueType::object;
+            }
+
+            /// @brief builds the property table of an object rule
+            void build_table(
+                Rule &rule, const std::vector<std::pair<JSONValue::StringType, std::uint32_t>> &properties,
+                const std::vector<JSONValue::StringType> &required)
+            {
+                std::vector<PropertySlot> entries{};
+                const auto                entry = [&](const JSONValue::StringType &key) -> PropertySlot &
+                {
+                    for (auto &slot : entries)
+                    {
+                        if (std::u8string_view{schema.keys}.substr(slot.key_offset, slot.key_size) == key)
+                        {
+                            return slot;
+                        }
+                    }
+                    entries.push_back(PropertySlot{
+                        .hash       = JSONHasher::hash_bytes(key.data(), key.size()),
+                        .key_offset = static_cast<std::uint32_t>(schema.keys.size()),
+                        .key_size   = static_cast<std::uint32_t>(key.size())});
+                    schema.keys.append(key);
+                    return entries.back();
+                };
+
+                for (const auto &[key, property_rule] : properties)
+                {
+                    entry(key).rule = property_rule;
+                }
+                for (const auto &key : required)
+                {
+                    PropertySlot &slot{entry(key)};
+                    rule.required_count += slot.required ? 0 : 1;
+                    slot.required = true;
+                }
+                if (entries.empty())
+                {
+                    return;
+                }
+
+                // at most half full, so probes stay short
+                std::uint32_t size{1};
+                while (size < 2 * entries.size())
+                {
+                    size *= 2;
+                }
+                rule.table_first = static_cast<std::uint32_t>(schema.slots.size());
+                rule.table_size  = size;
+                schema.slots.resize(schema.slots.size() + size);
+                const std::uint32_t mask{size - 1};
+                for (const auto &slot : entries)
+                {
+                    for (std::uint32_t i = static_cast<std::uint32_t>(slot.hash) & mask;; i = (i + 1) & mask)
+                    {
+                        if (schema.slots[rule.table_first + i].hash == 0)
+                        {
+                            schema.slots[rule.table_first + i] = slot;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            /// @brief compiles a (sub)schema
+            /// @return the index of its rule
+            std::uint32_t compile(const JSONValue &node)
+            {
+                if (node.type == JSONValue::JSONValueType::literal)
+                {
+                    switch (std::get<JSONValue::LiteralType>(node.value))
+                    {
+                    case JSONValue::LiteralType::true_v:
+                        return accept_rule;
+                    case JSONValue::LiteralType::false_v:
+                        return reject_rule;
+                    default:
+                        break;
+                    }
+                }
+                if (node.type != JSONValue::JSONValueType::object)
+                {
+                    fail("a schema must be an object or a boolean");
+                }
+
+                // sub-schemas are compiled first (they append to the rule table)
+                const auto &object{std::get<JSONValue::ObjectType>(node.value)};
+                Rule        rule{};
+
+                for (const auto &[key, value] : object)
+                {
+                    if (strict && std::find(keywords.begin(), keywords.end(), key) == keywords.end())
+                    {
+                        std::string what{"unsupported keyword \""};
+                        what.append(key.begin(), key.end());
+                        what.push_back('\"');
+                        fail(what.c_str());
+                    }
+                }
+
+                std::vector<std::pair<JSONValue::StringType, std::uint32_t>> properties{};
+                if (const JSONValue *value{member(object, u8"properties")})
+                {
+                    if (value->type != JSONValue::JSONValueType::object)
+                    {
+                        fail("\"properties\" must be an object");
+                    }
+                    for (const auto &[key, property] : std::get<JSONValue::ObjectType>(value->value))
+                    {
+                        if (property.type != JSONValue::JSONValueType::undefined)
+                        {
+                            properties.emplace_back(key, compile(property));
+                        }
+                    }
+                }
+                if (const JSONValue *value{member(object, u8"items")})
+                {
+                    rule.items = compile(*value);
+                }
+                if (const JSONValue *value{member(object, u8"additionalProperties")})
+                {
+                    rule.additional = compile(*value);
+                }
+
+                std::vector<JSONValue::StringType> required{};
+                if (const JSONValue *value{member(object, u8"required")})
+                {
+                    if (value->type != JSONValue::JSONValueType::array)
+                    {
+                        fail("\"required\" must be an array of strings");
+                    }
+                    for (const auto &key : std::get<JSONValue::ArrayType>(value->value))
+                    {
+                        if (key.type != JSONValue::JSONValueType::string)
+                        {
+                            fail("\"required\" must be an array of strings");
+                        }
+                        required.push_back(std::get<JSONValue::StringType>(key.value));
+                    }
+                }
+                build_table(rule, properties, required);
+
+                if (const JSONValue *value{member(object, u8"type")})
+                {
+                    rule.types = 0;
+                    if (value->type == JSONValue::JSONValueType::array)
+                    {
+                        for (const auto &name : std::get<JSONValue::ArrayType>(value->value))
+                        {
+                            rule.types |= type_bits(name);
+                        }
+                    }
+                    else
+                    {
+                        rule.types = type_bits(*value);
+                    }
+                }
+
+                if (const JSONValue *value{member(object, u8"enum")})
+                {
+                    if (value->type != JSONValue::JSONValueType::array)
+                    {
+                        fail("\"enum\" must be an array");
+                    }
+                    rule.enum_first = static_cast<std::uint32_t>(schema.enum_values.size());
+                    for (const auto &allowed : std::get<JSONValue::ArrayType>(value->value))
+                    {
+                        add_enum_value(rule, allowed);
+                    }
+                }
+                if (const JSONValue *value{member(object, u8"const")})
+                {
+                    if (rule.enum_first != none)
+                    {
+                        fail("\"enum\" and \"const\" can not be combined");
+                    }
+                    add_enum_value(rule, *value);
+                }
+
+                if (const JSONValue *value{member(object, u8"minimum")})
+                {
+                    rule.minimum = number(value, "\"minimum\" must be a number");
+                }
+                if (const JSONValue *value{member(object, u8"maximum")})
+                {
+                    rule.maximum = number(value, "\"maximum\" must be a number");
+                }
+                if (const JSONValue *value{member(object, u8"exclusiveMinimum")})
+                {
+                    const JSONValue::NumberType bound{number(value, "\"exclusiveMinimum\" must be a number")};
+                    if (bound >= rule.minimum)
+                    {
+                        rule.minimum           = bound;
+                        rule.exclusive_minimum = true;
+                    }
+                }
+                if (const JSONValue *value{member(object, u8"exclusiveMaximum")})
+                {
+                    const JSONValue::NumberType bound{number(value, "\"exclusiveMaximum\" must be a number")};
+                    if (bound <= rule.maximum)
+                    {
+                        rule.maximum           = bound;
+                        rule.exclusive_maximum = true;
+                    }
+                }
+
+                const auto optional_count = [&](const char8_t *key, std::uint32_t &target, const char *what)
+                {
+                    if (const JSONValue *value{member(object, key)})
+                    {
+                        target = count(value, what);
+                    }
+                };
+                optional_count(u8"minLength", rule.min_length, "\"minLength\" must be a non-negative integer");
+                optional_count(u8"maxLength", rule.max_length, "\"maxLength\" must be a non-negative integer");
+                optional_count(u8"minItems", rule.min_items, "\"minItems\" must be a non-negative integer");
+                optional_count(u8"maxItems", rule.max_items, "\"maxItems\" must be a non-negative integer");
+                optional_count(
+                    u8"minProperties", rule.min_properties, "\"minProperties\" must be a non-negative integer");
+                optional_count(
+                    u8"maxProperties", rule.max_properties, "\"maxProperties\" must be a non-negative integer");
+
+                if (const JSONValue *value{member(object, u8"pattern")})
+                {
+                    if (value->type != JSONValue::JSONValueType::string)
+                    {
+                        fail("\"pattern\" must be a string");
+                    }
+                    rule.pattern = compile_pattern(std::get<JSONValue::StringType>(value->value));
+                }
+
+                schema.rules.push_back(rule);
+                return static_cast<std::uint32_t>(schema.rules.size() - 1);
+            }
+        };
+
+        inline JSONSchema JSONSchema::compile(const JSONValue &schema, bool strict)
+        {
+            JSONSchema compiled{};
+            compiled.rules.push_back(Rule{});           // accept_rule
+            compiled.rules.push_back(Rule{.types = 0}); // reject_rule
+            compiled.root = Compiler{.schema = compiled, .strict = strict}.compile(schema);
+            return compiled;
+        }
+
+        //--JSONSchema::Validator Implementation------------------------------------------------------------------------
+
+        inline const JSONSchema::Rule *JSONSchema::Validator::begin_value()
+        {
+            ++events;
+            if (!result.valid)
+            {
+                return nullptr;
+            }
+
+            std::uint32_t rule{schema->root};
+            if (!frames.empty())
+            {
+                Frame &parent{frames.back()};
+                rule = parent.object ? parent.next_rule : schema->rules[parent.rule].items;
+                ++parent.count;
+            }
+            else if (has_root)
+            {
+                fail("the document has more than one root value");
+                return nullptr;
+            }
+            has_root = true;
+            return &schema->rules[rule];
+        }
+
+        inline void JSONSchema::Validator::end_value(std::uint64_t h, JSONValue &&value)
+        {
+            Frame   &parent{frames.back()};
+            Capture &capture{captures.back()};
+            if (parent.object)
+            {
+                parent.hash = JSONHasher::object_next(parent.hash, parent.key_hash, h);
+                std::get<JSONValue::ObjectType>(capture.value.value).insert_or_assign(capture.key, std::move(value));
+            }
+            else
+            {
+                parent.hash = JSONHasher::array_next(parent.hash, h);
+                std::get<JSONValue::ArrayType>(capture.value.value).push_back(std::move(value));
+            }
+        }
+
+        inline bool JSONSchema::Validator::is_allowed(
+            const Rule &rule, const Frame &frame, std::uint64_t h, const JSONValue &captured) const
+        {
+            // without a source, the hash only preselects candidates; the captured copy confirms the match
+            for (std::uint32_t i = rule.enum_first; i < rule.enum_first + rule.enum_count; ++i)
+            {
+                const JSONValue &allowed{schema->enum_values[i]};
+                if (frame.source ? allowed == *frame.source : (allowed.hash_cache == h && allowed == captured))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline bool JSONSchema::Validator::check_type(const Rule &rule, std::uint8_t type_bit)
+        {
+            if ((rule.types & type_bit) == 0)
+            {
+                fail(rule.types == 0 ? "the schema does not allow any value" : "the type of the value is not allowed");
+                return false;
+            }
+            return true;
+        }
+
+        inline void JSONSchema::Validator::on_literal(JSONValue::LiteralType literal)
+        {
+            const Rule *const rule{begin_value()};
+            if (rule && check_type(*rule, literal == JSONValue::LiteralType::null_v ? null_bit : boolean_bit) &&
+                rule->enum_first != none)
+            {
+                bool found{false};
+                for (std::uint32_t i = rule->enum_first; !found && i < rule->enum_first + rule->enum_count; ++i)
+                {
+                    const JSONValue &allowed{schema->enum_values[i]};
+                    found = allowed.type == JSONValue::JSONValueType::literal &&
+                            std::get<JSONValue::LiteralType>(allowed.value) == literal;
+                }
+                if (!found)
+                {
+                    fail("the value is not one of the allowed values");
+                }
+            }
+            if (!frames.empty() && frames.back().hashing)
+            {
+                end_value(JSONHasher::hash_literal(literal, JSONHasher::default_seed), JSONValue{literal});
+            }
+        }
+
+        inline void JSONSchema::Validator::on_number(JSONValue::NumberType number)
+        {
+            const Rule *const rule{begin_value()};
+            if (rule && check_type(*rule, number == std::floor(number) ? integer_bit : fraction_bit))
+            {
+                if (number < rule->minimum || (rule->exclusive_minimum && number == rule->minimum))
+                {
+                    fail("the number is below the minimum");
+                }
+                else if (number > rule->maximum || (rule->exclusive_maximum && number == rule->maximum))
+                {
+                    fail("the number is above the maximum");
+                }
+                else if (rule->enum_first != none)
+                {
+                    bool found{false};
+                    for (std::uint32_t i = rule->enum_first; !found && i < rule->enum_first + rule->enum_count; ++i)
+                    {
+                        const JSONValue &allowed{schema->enum_values[i]};
+                        found = allowed.type == JSONValue::JSONValueType::number &&
+                                std::get<JSONValue::NumberType>(allowed.value) == number;
+                    }
+                    if (!found)
+                    {
+                        fail("the value is not one of the allowed values");
+                    }
+                }
+            }
+            if (!frames.empty() && frames.back().hashing)
+            {
+                end_value(
+                    JSONHasher::finalize(JSONHasher::hash_number(number, JSONHasher::default_seed)), JSONValue{number});
+            }
+        }
+
+        inline void JSONSchema::Validator::on_string(std::u8string_view string)
+        {
+            const Rule *const rule{begin_value()};
+            if (rule && check_type(*rule, string_bit))
+            {
+                if (rule->min_length != 0 || rule->max_length != none)
+                {
+                    // count code points, i.e. every byte which is not a continuation byte
+                    std::size_t length{0};
+                    for (const char8_t unit : string)
+                    {
+                        length += (unit & 0xc0) != 0x80 ? 1 : 0;
+                    }
+                    if (length < rule->min_length)
+                    {
+                        fail("the string is shorter than the minimum length");
+                    }
+                    else if (rule->max_length != none && length > rule->max_length)
+                    {
+                        fail("the string is longer than the maximum length");
+                    }
+                }
+                if (rule->pattern != none && result.valid && !search(rule->pattern, string))
+                {
+                    fail("the string does not match the pattern");
+                }
+                if (rule->enum_first != none && result.valid)
+                {
+                    bool found{false};
+                    for (std::uint32_t i = rule->enum_first; !found && i < rule->enum_first + rule->enum_count; ++i)
+                    {
+                        const JSONValue &allowed{schema->enum_values[i]};
+                        found = allowed.type == JSONValue::JSONValueType::string &&
+                                std::get<JSONValue::StringType>(allowed.value) == string;
+                    }
+                    if (!found)
+                    {
+                        fail("the value is not one of the allowed values");
+                    }
+                }
+            }
+            if (!frames.empty() && frames.back().hashing)
+            {
+                end_value(
+                    JSONHasher::hash_string(string, JSONHasher::default_seed),
+                    JSONValue{JSONValue::StringType{string}});
+            }
+        }
+
+        inline void JSONSchema::Validator::on_begin_array(const JSONValue *source)
+        {
+            const Rule *const   rule{begin_value()};
+            const std::uint32_t index{rule ? static_cast<std::uint32_t>(rule - schema->rules.data()) : accept_rule};
+            if (rule)
+            {
+                check_type(*rule, array_bit);
+            }
+
+            const bool hashing{(!frames.empty() && frames.back().hashing) ||
+                               (rule && rule->structured_enum && source == nullptr)};
+            frames.push_back(Frame{
+                .rule    = result.valid ? index : accept_rule,
+                .source  = source,
+                .hash    = JSONHasher::array_begin(JSONHasher::default_seed),
+                .object  = false,
+                .hashing = hashing});
+            if (hashing)
+            {
+                captures.push_back(Capture{.value = JSONValue{JSONValue::ArrayType{}}});
+            }
+        }
+
+        inline void JSONSchema::Validator::on_begin_object(const JSONValue *source)
+        {
+            const Rule *const   rule{begin_value()};
+            const std::uint32_t index{rule ? static_cast<std::uint32_t>(rule - schema->rules.data()) : accept_rule};
+            if (rule)
+            {
+                check_type(*rule, object_bit);
+            }
+
+            const bool hashing{(!frames.empty() && frames.back().hashing) ||
+                               (rule && rule->structured_enum && source == nullptr)};
+            if (++object_mark == 0)
+            {
+                std::fill(required_marks.begin(), required_marks.end(), 0);
+                object_mark = 1;
+            }
+            frames.push_back(Frame{
+                .rule    = result.valid ? index : accept_rule,
+                .mark    = object_mark,
+                .source  = source,
+                .object  = true,
+                .hashing = hashing});
+            if (hashing)
+            {
+                captures.push_back(Capture{.value = JSONValue{JSONValue::ObjectType{}}});
+            }
+        }
+
+        inline void JSONSchema::Validator::on_key(std::u8string_view key)
+        {
+            ++events;
+            if (frames.empty() || !frames.back().object)
+            {
+                fail("a key outside of an object");
+                return;
+            }
+
+            Frame &frame{frames.back()};
+            if (!result.valid)
+            {
+                return;
+            }
+
+            const Rule         &rule{schema->rules[frame.rule]};
+            const std::uint64_t h{JSONHasher::hash_bytes(key.data(), key.size())};
+            frame.key_hash = h;
+            if (frame.hashing)
+            {
+                captures.back().key = key;
+            }
+            if (const PropertySlot *slot{schema->find_property(rule, key, h)})
+            {
+                // a repeated key must not count a required member twice
+                const std::size_t index{static_cast<std::size_t>(slot - schema->slots.data())};
+                frame.next_rule = slot->rule;
+                if (slot->required && required_marks[index] != frame.mark)
+                {
+                    required_marks[index] = frame.mark;
+                    ++frame.required_seen;
+                }
+            }
+            else if (rule.additional == reject_rule)
+            {
+                fail("additional properties are not allowed");
+            }
+            else
+            {
+                frame.next_rule = rule.additional;
+            }
+        }
+
+        inline void JSONSchema::Validator::on_end_array()
+        {
+            ++events;
+            if (frames.empty() || frames.back().object)
+            {
+                fail("an unbalanced end of an array");
+                return;
+            }
+
+            const Frame frame{frames.back()};
+            frames.pop_back();
+            const std::uint64_t h{JSONHasher::array_end(frame.hash, frame.count)};
+            JSONValue           captured{};
+            if (frame.hashing)
+            {
+                captured = std::move(captures.back().value);
+                captures.pop_back();
+            }
+
+            const Rule &rule{schema->rules[frame.rule]};
+            if (frame.count < rule.min_items)
+            {
+                fail("the array has fewer than the minimum number of items");
+            }
+            else if (rule.max_items != none && frame.count > rule.max_items)
+            {
+                fail("the array has more than the maximum number of items");
+            }
+            else if (rule.enum_first != none && result.valid && !is_allowed(rule, frame, h, captured))
+            {
+                fail("the value is not one of the allowed values");
+            }
+            if (!frames.empty() && frames.back().hashing)
+            {
+                end_value(h, std::move(captured));
+            }
+        }
+
+        inline void JSONSchema::Validator::on_end_object()
+        {
+            ++events;
+            if (frames.empty() || !frames.back().object)
+            {
+                fail("an unbalanced end of an object");
+                return;
+            }
+
+            const Frame frame{frames.back()};
+            frames.pop_back();
+            const std::uint64_t h{JSONHasher::object_end(frame.hash, frame.count, JSONHasher::default_seed)};
+            JSONValue           captured{};
+            if (frame.hashing)
+            {
+                captured = std::move(captures.back().value);
+                captures.pop_back();
+            }
+
+            const Rule &rule{schema->rules[frame.rule]};
+            if (frame.required_seen < rule.required_count)
+            {
+                fail("a required property is missing");
+            }
+            else if (frame.count < rule.min_properties)
+            {
+                fail("the object has fewer than the minimum number of properties");
+            }
+            else if (rule.max_properties != none && frame.count > rule.max_properties)
+            {
+                fail("the object has more than the maximum number of properties");
+            }
+            else if (rule.enum_first != none && result.valid && !is_allowed(rule, frame, h, captured))
+            {
+                fail("the value is not one of the allowed values");
+            }
+            if (!frames.empty() && frames.back().hashing)
+            {
+                end_value(h, std::move(captured));
+            }
+        }
+
+        inline JSONSchemaResult JSONSchema::Validator::validate(const JSONValue &document)
+        {
+            reset();
+            walk.clear();
+
+            const auto emit = [&](const JSONValue &value)
+            {
+                switch (value.type)
+                {
+                case JSONValue::JSONValueType::literal:
+                    on_literal(std::get<JSONValue::LiteralType>(value.value));
+                    break;
+                case JSONValue::JSONValueType::number:
+                    on_number(std::get<JSONValue::NumberType>(value.value));
+                    break;
+                case JSONValue::JSONValueType::string:
+                    on_string(std::get<JSONValue::StringType>(value.value));
+                    break;
+                case JSONValue::JSONValueType::array:
+                    on_begin_array(&value);
+                    walk.push_back(WalkFrame{.node = &value});
+                    break;
+                case JSONValue::JSONValueType::object:
+                    on_begin_object(&value);
+                    walk.push_back(
+                        WalkFrame{.node = &value, .member = std::get<JSONValue::ObjectType>(value.value).begin()});
+                    break;
+                case JSONValue::JSONValueType::undefined:
+                default:
+                    break;
+                }
+            };
+
+            if (document.type == JSONValue::JSONValueType::undefined)
+            {
+                fail("the document is undefined");
+                return result;
+            }
+
+            emit(document);
+            while (!walk.empty() && result.valid)
+            {
+                WalkFrame &top{walk.back()};
+                if (top.node->type == JSONValue::JSONValueType::array)
+                {
+                    const auto &array{std::get<JSONValue::ArrayType>(top.node->value)};
+                    if (top.index == array.size())
+                    {
+                        walk.pop_back();
+                        on_end_array();
+                    }
+                    else if (const JSONValue &element{array[top.index++]};
+                             element.type != JSONValue::JSONValueType::undefined)
+                    {
+                        emit(element);
+                    }
+                }
+                else
+                {
+                    if (top.member == std::get<JSONValue::ObjectType>(top.node->value).end())
+                    {
+                        walk.pop_back();
+                        on_end_object();
+                    }
+                    else if (const auto &[key, value]{*top.member++}; value.type != JSONValue::JSONValueType::undefined)
+                    {
+                        on_key(key);
+                        emit(value);
+                    }
+                }
+            }
+            return finish();
+        }
+
+        inline bool JSONSchema::Validator::add_thread(
+            std::vector<std::uint32_t> &list, std::uint32_t first, std::uint32_t pc, std::size_t position,
+            std::size_t size)
+        {
+            using Op = PatternInstruction::Op;
+
+            pending.clear();
+            pending.push_back(pc);
+            while (!pending.empty())
+            {
+                pc = pending.back();
+                pending.pop_back();
+                if (marks[pc] == generation)
+                {
+                    continue;
+                }
+                marks[pc] = generation;
+
+                const PatternInstruction &instruction{schema->instructions[first + pc]};
+                switch (instruction.op)
+                {
+                case Op::jump:
+                    pending.push_back(pc + instruction.x);
+                    break;
+                case Op::split:
+                    pending.push_back(pc + instruction.y);
+                    pending.push_back(pc + instruction.x);
+                    break;
+                case Op::begin:
+                    if (position == 0)
+                    {
+                        pending.push_back(pc + 1);
+                    }
+                    break;
+                case Op::end:
+                    if (position == size)
+                    {
+                        pending.push_back(pc + 1);
+                    }
+                    break;
+                case Op::match:
+                    return true;
+                default:
+                    list.push_back(pc);
+                    break;
+                }
+            }
+            return false;
+        }
+
+        inline bool JSONSchema::Validator::search(std::uint32_t pattern, std::u8string_view text)
+        {
+            using Op = PatternInstruction::Op;
+
+            const Pattern &program{schema->patterns[pattern]};
+            if (marks.size() < program.count)
+            {
+                marks.resize(program.count, 0);
+            }
+            const auto next_generation = [&]()
+            {
+                if (++generation == 0)
+                {
+                    std::fill(marks.begin(), marks.end(), 0);
+                    generation = 1;
+                }
+            };
+
+            // a Pike VM: every thread advances in lock step, one code point at a time, and a new thread starts at every
+            // position since the search is unanchored
+            current.clear();
+            next_generation();
+            for (std::size_t position = 0;;)
+            {
+                if (add_thread(current, program.first, 0, position, text.size()))
+                {
+                    return true;
+                }
+                if (position == text.size())
+                {
+                    return false;
+                }
+
+                const auto [code_point, size]{decode(text, position)};
+                next.clear();
+                next_generation();
+                for (const std::uint32_t pc : current)
+                {
+                    const PatternInstruction &instruction{schema->instructions[program.first + pc]};
+                    bool                      consumed{false};
+                    switch (instruction.op)
+                    {
+                    case Op::code_point:
+                        consumed = code_point == instruction.a;
+                        break;
+                    case Op::any:
+                        consumed = code_point != U'\n' && code_point != U'\r' && code_point != 0x2028 &&
+                                   code_point != 0x2029;
+                        break;
+                    case Op::range_set: {
+                        bool in{false};
+                        for (std::uint32_t i = instruction.a; !in && i < instruction.a + instruction.b; ++i)
+                        {
+                            in = code_point >= schema->ranges[i].first && code_point <= schema->ranges[i].second;
+                        }
+                        consumed = in != (instruction.x != 0);
+                        break;
+                    }
+                    default:
+                        break;
+                    }
+                    if (consumed && add_thread(next, program.first, pc + 1, position + size, text.size()))
+                    {
+                        return true;
+                    }
+                }
+                std::swap(current, next);
+                position += size;
+            }
+        }
+
+        /// @brief validates a document against a schema
+        /// @param document the document to validate
+        /// @param schema the compiled schema
+        /// @return the outcome of the validation
+        /// @see JSONSchema
+        inline JSONSchemaResult validate(const JSONValue &document, const JSONSchema &schema)
+        {
+            return schema.validate(document);
+        }
+
+        //--JSON Canonical Form-----------------------------------------------------------------------------------------
+
+        /// @brief a sink which hashes the output instead of storing it (so a content hash of the serialized form can be
+        /// computed without materializing it)
+        struct JSONHashSink
+        {
+            JSONHasher hasher{}; ///< the hash of the output so far
+
+            void write(const char8_t *data, std::size_t size) noexcept { hasher.update(data, size); }
+            void put(char8_t unit) noexcept { hasher.update(&unit, 1); }
+
+            /// @brief the hash of the output so far
+            std::uint64_t digest() const noexcept { return hasher.finish(); }
+        };
+
+        /// @brief the canonical output format (in the spirit of RFC 8785, the JSON Canonicalization Scheme)
+        ///
+        /// output is a function of the (logical) value alone:
+        ///     - no whitespace
+        ///     - object members sorted by the UTF-16 code units of their keys
+        ///     - numbers in their shortest round-trip form as formatted by ECMAScript (numbers are converted to IEEE
+        ///     doubles first; -0 is written as 0; NaN and infinities can not be written)
+        ///     - strings with the minimal escaping (\\", \\\\, \\b, \\f, \\n, \\r, \\t, and \\u00xx for the other
+        ///     control characters)
+        ///
+        /// a format is a policy of a JSONWriter: besides sort_keys and number(...), it provides the punctuation
+        /// between the tokens of arrays and objects (open, separator, colon, and close)
+        struct JSONCanonicalFormat
+        {
+            /// @brief members are written in key order (see less(...))
+            static constexpr bool sort_keys{true};
+
+            /// @brief compares two UTF-8 keys by their UTF-16 code units
+            ///
+            /// byte order (i.e. code point order) and UTF-16 order only disagree when a supplementary code point
+            /// (encoded as a surrogate pair) meets a code point in [U+E000, U+FFFF], so keys are compared bytewise and
+            /// only the code points at the first difference are decoded
+            static bool less(std::u8string_view lhs, std::u8string_view rhs) noexcept
+            {
+                const auto [l, r]{std::mismatch(lhs.begin(), lhs.end(), rhs.begin(), rhs.end())};
+                if (l == lhs.end() || r == rhs.end())
+                {
+                    return l == lhs.end() && r != rhs.end();
+                }
+                if (*l < 0xee && *r < 0xee)
+                {
+                    return *l < *r;
+                }
+
+                // a byte >= 0xee can only be a lead byte, so the keys differ in the code point starting right here
+                const std::size_t offset{static_cast<std::size_t>(l - lhs.begin())};
+                const auto        units = [](std::u8string_view key, std::size_t at) -> std::uint32_t
+                {
+                    char32_t    code_point{key[at]};
+                    std::size_t size{1};
+                    if (code_point >= 0xf0)
+                    {
+                        code_point &= 0x07;
+                        size = 4;
+                    }
+                    else if (code_point >= 0xe0)
+                    {
+                        code_point &= 0x0f;
+                        size = 3;
+                    }
+                    else if (code_point >= 0xc0)
+                    {
+                        code_point &= 0x1f;
+                        size = 2;
+                    }
+                    for (std::size_t i = 1; i < size && at + i < key.size(); ++i)
+                    {
+                        code_point = (code_point << 6) | (key[at + i] & 0x3f);
+                    }
+
+                    // the UTF-16 code units of the code point (the high one first)
+                    if (code_point < 0x10000)
+                    {
+                        return static_cast<std::uint32_t>(code_point) << 16;
+                    }
+                    const std::uint32_t offset{static_cast<std::uint32_t>(code_point) - 0x10000};
+                    return ((0xd800 + (offset >> 10)) << 16) | (0xdc00 + (offset & 0x3ff));
+                };
+                return units(lhs, offset) < units(rhs, offset);
+            }
+
+            /// @brief writes a number as ECMAScript's Number.prototype.toString would
+            /// @throws std::exception if the number is NaN or infinite
+            template <typename Sink> static void number(Sink &sink, JSONValue::NumberType value)
+            {
+                const double number{static_cast<double>(value)};
+                if (!std::isfinite(number))
+                {
+                    throw std::exception{"[ben::json::JSONCanonicalFormat] NaN and infinity can not be serialized"};
+                }
+                if (number == 0)
+                {
+                    sink.put(u8'0');
+                    return;
+                }
+                if (std::fabs(number) < 0x1p53 && number == std::trunc(number))
+                {
+                    // every integer below 2^53 is written in full (ECMAScript only rounds larger integers)
+                    JSONIntegerFormatter::write(sink, number);
+                    return;
+                }
+
+                // the shortest round-trip digits and the decimal exponent, i.e. number = 0.digits * 10^point
+                std::array<char, 32> scientific{'\0'};
+                const auto           res{std::to_chars(
+                    scientific.data(), scientific.data() + scientific.size(), number, std::chars_format::scientific)};
+                std::array<char8_t, 17> digits{};
+                int                     count{0};
+                const char             *c{scientific.data() + (number < 0 ? 1 : 0)};
+                for (; *c != 'e'; ++c)
+                {
+                    if (*c != '.')
+                    {
+                        digits[count++] = static_cast<char8_t>(*c);
+                    }
+                }
+                int exponent{0};
+                std::from_chars(c + (c[1] == '+' ? 2 : 1), res.ptr, exponent);
+                const int point{exponent + 1};
+
+                std::array<char8_t, 32> out{};
+                std::size_t             size{0};
+                const auto              put = [&](char8_t unit) { out[size++] = unit; };
+                const auto              put_digits = [&](int first, int last)
+                {
+                    for (int i = first; i < last; ++i)
+                    {
+                        put(digits[i]);
+                    }
+                };
+
+                if (number < 0)
+                {
+                    put(u8'-');
+                }
+                if (count <= point && point <= 21)
+                {
+                    put_digits(0, count);
+                    for (int i = count; i < point; ++i)
+                    {
+                        put(u8'0');
+                    }
+                }
+                else if (0 < point && point <= 21)
+                {
+                    put_digits(0, point);
+                    put(u8'.');
+                    put_digits(point, count);
+                }
+                else if (-6 < point && point <= 0)
+                {
+                    put(u8'0');
+                    put(u8'.');
+                    for (int i = point; i < 0; ++i)
+                    {
+                        put(u8'0');
+                    }
+                    put_digits(0, count);
+                }
+                else
+                {
+                    put(digits[0]);
+                    if (count > 1)
+                    {
+                        put(u8'.');
+                        put_digits(1, count);
+                    }
+                    put(u8'e');
+                    put(point - 1 < 0 ? u8'-' : u8'+');
+                    std::array<char, 8> magnitude{'\0'};
+                    const auto          end{std::to_chars(
+                        magnitude.data(), magnitude.data() + magnitude.size(), point - 1 < 0 ? 1 - point : point - 1)};
+                    for (const char *m = magnitude.data(); m != end.ptr; ++m)
+                    {
+                        put(static_cast<char8_t>(*m));
+                    }
+                }
+                sink.write(out.data(), size);
+            }
+
+            template <typename Sink> static void open(Sink &sink, char8_t bracket, std::size_t) { sink.put(bracket); }
+
+            template <typename Sink> static void separator(Sink &sink, bool first, std::size_t)
+            {
+                if (!first)
+                {
+                    sink.put(u8',');
+                }
+            }
+
+            template <typename Sink> static void colon(Sink &sink) { sink.put(u8':'); }
+
+            template <typename Sink> static void close(Sink &sink, char8_t bracket, bool, std::size_t)
+            {
+                sink.put(bracket);
+            }
+        };
+
+        /// @brief writes the canonical form of a value to a sink
+        /// @tparam Sink the type receiving the output
+        /// @param value the value to write
+        /// @param sink the sink receiving the output
+        /// @throws std::exception if the value can not be written (it is undefined or contains NaN or infinity)
+        /// @see JSONCanonicalFormat
+        template <typename Sink> void write_canonical(const JSONValue &value, Sink &sink)
+        {
+            JSONWriter<JSONCanonicalFormat, Sink>{sink}.write(value);
+        }
+
+        /// @brief serializes a value in canonical form, so that equal values serialize to the same bytes
+        /// @param value the value to serialize
+        /// @return the canonical form of the value (an empty string if it can not be serialized, in which case the
+        /// error is printed like serialize(...) does)
+        /// @see JSONCanonicalFormat
+        inline std::u8string serialize_canonical(const JSONValue &value) noexcept
+        {
+            std::u8string serialized{u8""};
+
+            try
+            {
+                JSONStringSink sink{serialized};
+                write_canonical(value, sink);
+            }
+            catch (const std::exception &e)
+            {
+                serialized.clear();
+                std::cout << "[ben::json::serialize_canonical] Error: " << e.what() << " Returning empty string.\n";
+            }
+            catch (...)
+            {
+                serialized.clear();
+                std::cout << "[ben::json::serialize_canonical] Error: An unknown error has occured. Returning empty "
+                             "string.\n";
+            }
+
+            return serialized;
+        }
+
+        /// @brief hashes the canonical form of a value without materializing it (a content hash, e.g. for ETags)
+        /// @param value the value to hash
+        /// @return JSONHasher::hash_bytes(...) of serialize_canonical(value)
+        /// @throws std::exception if the value can not be written (it is undefined or contains NaN or infinity)
+        inline std::uint64_t canonical_hash(const JSONValue &value)
+        {
+            JSONHashSink sink{};
+            write_canonical(value, sink);
+            return sink.digest();
+        }
+
+        //--JSON Serialization Options----------------------------------------------------------------------------------
+
+        /// @brief the output styles of serialize(const JSONValue &, const JSONSerializeOptions &)
+        enum struct JSONOutputStyle
+        {
+            standard,  ///< the format of serialize(...) (see JSONDefaultFormat)
+            compact,   ///< no whitespace (see JSONCompactFormat)
+            pretty,    ///< one element per line, indented (see JSONPrettyFormat)
+            canonical, ///< the canonical form (see JSONCanonicalFormat)
+        };
+
+        /// @brief options of serialize(const JSONValue &, const JSONSerializeOptions &)
+        struct JSONSerializeOptions
+        {
+            JSONOutputStyle   style{JSONOutputStyle::standard};     ///< the output style
+            std::size_t       indent_width{4};                      ///< the spaces per nesting level (pretty only)
+            bool              crlf{false};                          ///< true to break lines with "\r\n" (pretty only)
+            JSONUtf8Mode      utf8{JSONUtf8Mode::reject};           ///< what to do with invalid UTF-8 strings
+            bool              ascii_only{false};                    ///< true to escape non-ASCII (not canonical)
+            JSONNonFiniteMode non_finite{JSONNonFiniteMode::error}; ///< what to do with NaN/infinity (not canonical)
+            JSONPrecision     precision{};                          ///< how non-integers are rounded (not canonical)
+        };
+
+        /// @brief creates the JSONWriter of the requested output style and passes it to a function
+        ///
+        /// the style is dispatched once, up front: each style is a separate instantiation of JSONWriter, so e.g. the
+        /// compact style does not test for indentation anywhere while writing
+        ///
+        /// @tparam Sink the type receiving the output (see JSONStringSink, JSONCharStringSink, JSONSpanSink, etc.)
+        /// @param sink the sink receiving the output
+        /// @param options the output style (and its settings)
+        /// @param function called with the writer (by reference)
+        template <typename Sink, typename Function>
+        void with_writer(Sink &sink, const JSONSerializeOptions &options, Function &&function)
+        {
+            switch (options.style)
+            {
+            case JSONOutputStyle::compact: {
+                JSONWriter<JSONCompactFormat, Sink> writer{
+                    sink, {}, options.utf8, options.ascii_only, options.non_finite, options.precision};
+                function(writer);
+                break;
+            }
+            case JSONOutputStyle::pretty: {
+                JSONPrettyFormat                   format{options.indent_width, options.crlf};
+                JSONWriter<JSONPrettyFormat, Sink> writer{
+                    sink, std::move(format), options.utf8, options.ascii_only, options.non_finite, options.precision};
+                function(writer);
+                break;
+            }
+            case JSONOutputStyle::canonical: {
+                JSONWriter<JSONCanonicalFormat, Sink> writer{sink}; // the canonical form must be valid UTF-8
+                function(writer);
+                break;
+            }
+            case JSONOutputStyle::standard:
+            default: {
+                JSONWriter<JSONDefaultFormat, Sink> writer{
+                    sink, {}, options.utf8, options.ascii_only, options.non_finite, options.precision};
+                function(writer);
+                break;
+            }
+            }
+        }
+
+        /// @brief writes a value to a sink in the requested output style
+        /// @tparam Sink the type receiving the output (see JSONStringSink, JSONCharStringSink, JSONSpanSink, etc.)
+        /// @param value the value to write
+        /// @param sink the sink receiving the output
+        /// @param options the output style (and its settings)
+        /// @throws std::exception if the value can not be written
+        template <typename Sink>
+        void write(const JSONValue &value, Sink &sink, const JSONSerializeOptions &options = {})
+        {
+            with_writer(sink, options, [&value](auto &writer) { writer.write(value); });
+        }
+
+        /// @brief serializes a value in the requested output style
+        /// @param value the value to serialize
+        /// @param options the output style (and its settings)
+        /// @return the serialized value (an empty string if it can not be serialized, in which case the error is
+        /// printed like serialize(...) does)
+        /// @see write(...)
+        inline std::u8string serialize(const JSONValue &value, const JSONSerializeOptions &options) noexcept
+        {
+            std::u8string serialized{u8""};
+
+            try
+            {
+                JSONStringSink sink{serialized};
+                write(value, sink, options);
+            }
+            catch (const std::exception &e)
+            {
+                serialized.clear();
+                std::cout << "[ben::json::serialize] Error: " << e.what() << " Returning empty string.\n";
+            }
+            catch (...)
+            {
+                serialized.clear();
+                std::cout << "[ben::json::serialize] Error: An unknown error has occured. Returning empty string.\n";
+            }
+
+            return serialized;
+        }
+
+        /// @brief appends the serialization of a value to a buffer of chars, i.e. the buffer a socket, HTTP library,
+        /// or std::ostream consumes (so the output is not copied from a std::u8string)
+        /// @tparam Buffer std::string or std::vector<char>
+        /// @param value the value to serialize
+        /// @param out the buffer to append to (left as it was if the value can not be serialized)
+        /// @param options the output style (and its settings)
+        /// @return the number of chars appended (0 if the value can not be serialized, in which case the error is
+        /// printed like serialize(...) does)
+        template <
+            typename Buffer,
+            std::enable_if_t<std::is_same_v<Buffer, std::string> || std::is_same_v<Buffer, std::vector<char>>, bool>
+                enabled = true>
+        std::size_t serialize_into(
+            const JSONValue &value, Buffer &out, const JSONSerializeOptions &options = {}) noexcept
+        {
+            using Sink =
+                std::conditional_t<std::is_same_v<Buffer, std::string>, JSONCharStringSink, JSONCharVectorSink>;
+
+            const std::size_t size{out.size()};
+            try
+            {
+                Sink sink{out};
+                write(value, sink, options);
+                return out.size() - size;
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "[ben::json::serialize_into] Error: " << e.what() << " Returning 0.\n";
+            }
+            catch (...)
+            {
+                std::cout << "[ben::json::serialize_into] Error: An unknown error has occured. Returning 0.\n";
+            }
+
+            out.resize(size);
+            return 0;
+        }
+
+        /// @brief writes the serialization of a value into a fixed size buffer of chars (without allocating any output)
+        /// @param value the value to serialize
+        /// @param out the buffer to write to (the chars past the returned size are unspecified)
+        /// @param options the output style (and its settings)
+        /// @return the number of chars written (0 if the value can not be serialized or does not fit in the buffer, in
+        /// which case the error is printed like serialize(...) does)
+        inline std::size_t serialize_into(
+            const JSONValue &value, std::span<char> out, const JSONSerializeOptions &options = {}) noexcept
+        {
+            try
+            {
+                JSONSpanSink sink{out};
+                write(value, sink, options);
+                return sink.size;
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "[ben::json::serialize_into] Error: " << e.what() << " Returning 0.\n";
+            }
+            catch (...)
+            {
+                std::cout << "[ben::json::serialize_into] Error: An unknown error has occured. Returning 0.\n";
+            }
+
+            return 0;
+        }
+
+        /// @brief serializes a value into a std::string (for APIs which take chars rather than char8_ts)
+        /// @param value the value to serialize
+        /// @param options the output style (and its settings)
+        /// @return the serialized value (an empty string if it can not be serialized, in which case the error is
+        /// printed like serialize(...) does)
+        inline std::string serialize_chars(const JSONValue &value, const JSONSerializeOptions &options = {}) noexcept
+        {
+            std::string serialized{};
+            serialize_into(value, serialized, options);
+            return serialized;
+        }
+
+        /// @brief serializes packed numbers (e.g. the data of a std::vector<float>) as an array, without building a
+        /// JSONValue for each of them; floats are written in the shortest form of the float
+        /// @tparam Number an arithmetic type
+        /// @param numbers the numbers to serialize
+        /// @param options the output style (and its settings, e.g. the precision of the numbers)
+        /// @return the serialized array (an empty string if it can not be serialized, in which case the error is
+        /// printed like serialize(...) does)
+        template <typename Number, std::enable_if_t<std::is_arithmetic_v<Number>, bool> enabled = true>
+        std::u8string serialize_numbers(
+            std::span<const Number> numbers, const JSONSerializeOptions &options = {}) noexcept
+        {
+            std::u8string serialized{u8""};
+
+            try
+            {
+                serialized.reserve(numbers.size() * 8);
+                JSONStringSink sink{serialized};
+                with_writer(sink, options, [numbers](auto &writer) { writer.write_numbers(numbers); });
+            }
+            catch (const std::exception &e)
+            {
+                serialized.clear();
+                std::cout << "[ben::json::serialize] Error: " << e.what() << " Returning empty string.\n";
+            }
+            catch (...)
+            {
+                serialized.clear();
+                std::cout << "[ben::json::serialize] Error: An unknown error has occured. Returning empty string.\n";
+            }
+
+            return serialized;
+        }
+
+        //--JSON Streaming Reformat-------------------------------------------------------------------------------------
+
+        /// @brief the grammar of JSON numbers, advanced one unit at a time (so numbers may span chunks of input)
+        struct JSONNumberGrammar
+        {
+            /// @brief the parts of a number
+            enum struct Part : std::uint8_t
+            {
+                start,
+                sign,
+                zero,
+                integer,
+                point,
+                fraction,
+                exponent,
+                exponent_sign,
+                exponent_digits,
+            };
+
+            Part part{Part::start}; ///< the part of the number reached so far
+
+            /// @brief advances the grammar by one unit (the first unit must be '-' or a digit)
+            /// @return false (leaving the grammar as it was) if the unit can not continue the number
+            bool step(char8_t unit) noexcept
+            {
+                const bool digit{unit >= u8'0' && unit <= u8'9'};
+                const bool exponent{unit == u8'e' || unit == u8'E'};
+                switch (part)
+                {
+                case Part::start: // the caller has checked the first unit already
+                    part = unit == u8'-' ? Part::sign : (unit == u8'0' ? Part::zero : Part::integer);
+                    return true;
+                case Part::sign:
+                    if (digit)
+                    {
+                        part = unit == u8'0' ? Part::zero : Part::integer;
+                    }
+                    return digit;
+                case Part::zero:
+                case Part::integer:
+                    if (digit)
+                    {
+                        return part == Part::integer; // no leading zeros
+                    }
+                    if (unit == u8'.' || exponent)
+                    {
+                        part = exponent ? Part::exponent : Part::point;
+                        return true;
+                    }
+                    return false;
+                case Part::point:
+                    if (digit)
+                    {
+                        part = Part::fraction;
+                    }
+                    return digit;
+                case Part::fraction:
+                    if (exponent)
+                    {
+                        part = Part::exponent;
+                    }
+                    return digit || exponent;
+                case Part::exponent:
+                    if (unit == u8'+' || unit == u8'-')
+                    {
+                        part = Part::exponent_sign;
+                        return true;
+                    }
+                    [[fallthrough]];
+                case Part::exponent_sign:
+                    if (digit)
+                    {
+                        part = Part::exponent_digits;
+                    }
+                    return digit;
+                case Part::exponent_digits:
+                default:
+                    return digit;
+                }
+            }
+
+            /// @brief true if the number may end here
+            bool complete() const noexcept
+            {
+                return part == Part::zero || part == Part::integer || part == Part::fraction ||
+                       part == Part::exponent_digits;
+            }
+        };
+
+        /// @brief the outcome of checking JSON text (see JSONTokenizer and JSONValidator)
+        struct JSONValidationResult
+        {
+            /// @brief true if the text is well-formed JSON
+            bool valid{true};
+
+            /// @brief the offset (in bytes) of the first unit which is not valid (the size of the text if it ended too
+            /// early)
+            std::size_t offset{0};
+
+            /// @brief why the text is not valid (a static string)
+            const char *reason{""};
+
+            /// @brief true if the text is well-formed JSON
+            explicit operator bool() const noexcept { return valid; }
+        };
+
+        /// @brief a token handler which ignores every token, so that a JSONTokenizer only checks the text
+        struct JSONNullTokenHandler
+        {
+            void open(char8_t, std::size_t) noexcept { };
+            void separator(bool, std::size_t) noexcept { };
+            void colon() noexcept { };
+            void close(char8_t, bool, std::size_t) noexcept { };
+            void text(const char8_t *, std::size_t) noexcept { };
+        };
+
+        /// @brief splits JSON text (a single value, surrounded by any amount of whitespace) in valid UTF-8 into tokens
+        /// without building any values, and passes them to a handler as they are found
+        ///
+        /// the text may be fed in chunks of any size; tokens (including multi-byte UTF-8 sequences) which span chunks
+        /// are resumed where they were left off. The tokenizer never allocates: open arrays/objects are tracked in a
+        /// fixed-size bit stack (one bit per nesting level, up to max_depth levels), strings are skipped a block at a
+        /// time (see JSONStringScanner), and failures are recorded in the result rather than thrown
+        ///
+        /// the handler receives the punctuation as events, and strings (with their quotes), numbers, and literals as
+        /// runs of the text, in the order of the text (a token which spans chunks is passed as one run per chunk):
+        /// - open(bracket, depth): '[' or '{', opening nesting level depth (0 for the outermost array/object)
+        /// - separator(first, depth): before each element/key of the array/object at nesting level depth
+        /// - colon(): between a key and its value
+        /// - close(bracket, empty, depth): ']' or '}', closing nesting level depth
+        /// - text(data, size): a run of a string, a number, or a literal
+        ///
+        /// escape sequences are checked for their form only (e.g. a \\u escape sequence encoding an unpaired surrogate
+        /// is accepted, as the JSON grammar allows)
+        ///
+        /// @tparam Handler the type receiving the tokens (see JSONNullTokenHandler and JSONReformatter)
+        template <typename Handler> class JSONTokenizer
+        {
+          public:
+            /// @brief the deepest nesting of arrays/objects which is accepted
+            static constexpr std::size_t max_depth{1024};
+
+            /// @brief creates a tokenizer
+            /// @param handler the handler receiving the tokens
+            explicit JSONTokenizer(Handler handler = Handler{}) : handler{std::move(handler)} { };
+
+            //--JSONTokenizer Input-------------------------------------------------------------------------------------
+
+            /// @brief tokenizes the next chunk of the text (once the text is known to be invalid, input is ignored)
+            /// @param chunk the next chunk of the text
+            /// @return the outcome so far
+            const JSONValidationResult &feed(std::u8string_view chunk)
+            {
+                std::size_t i{0};
+                run = 0;
+                while (i < chunk.size() && state != State::failed)
+                {
+                    const char8_t unit{chunk[i]};
+                    switch (state)
+                    {
+                    case State::string:
+                        i = scan_string(chunk, i);
+                        break;
+                    case State::escape:
+                        if (std::u8string_view{u8"\"\\/bfnrtu"}.find(unit) == std::u8string_view::npos)
+                        {
+                            fail("invalid escape sequence", i);
+                            break;
+                        }
+                        state   = unit == u8'u' ? State::unicode : State::string;
+                        pending = 0;
+                        ++i;
+                        break;
+                    case State::unicode:
+                        if (!((unit >= u8'0' && unit <= u8'9') || (unit >= u8'a' && unit <= u8'f') ||
+                              (unit >= u8'A' && unit <= u8'F')))
+                        {
+                            fail("invalid \\u escape sequence", i);
+                            break;
+                        }
+                        state = ++pending == 4 ? State::string : State::unicode;
+                        ++i;
+                        break;
+                    case State::continuation:
+                        i = continue_sequence(chunk, i);
+                        break;
+                    case State::number:
+                        while (i < chunk.size() && number.step(chunk[i]))
+                        {
+                            ++i;
+                        }
+                        if (i < chunk.size())
+                        {
+                            if (!number.complete())
+                            {
+                                fail("malformed number", i);
+                                break;
+                            }
+                            end_token(chunk, i, end_value()); // the unit which ended the number is handled next
+                        }
+                        break;
+                    case State::literal:
+                        if (unit != literal[pending])
+                        {
+                            fail("invalid literal", i);
+                            break;
+                        }
+                        ++i;
+                        if (++pending == literal.size())
+                        {
+                            end_token(chunk, i, end_value());
+                        }
+                        break;
+                    default:
+                        if (unit == u8' ' || unit == u8'\t' || unit == u8'\n' || unit == u8'\r')
+                        {
+                            ++i;
+                            break;
+                        }
+                        i += structural(unit, i) ? 1 : 0;
+                        break;
+                    }
+                }
+
+                // the rest of a token which continues in the next chunk
+                if (state >= State::string && state <= State::literal)
+                {
+                    handler.text(chunk.data() + run, chunk.size() - run);
+                }
+                offset += chunk.size();
+                return result;
+            }
+
+            /// @brief marks the end of the text
+            /// @return the outcome of the check
+            const JSONValidationResult &finish()
+            {
+                if (state == State::number && number.complete())
+                {
+                    state = end_value();
+                }
+                if (state != State::end && state != State::failed)
+                {
+                    fail("unexpected end of input", 0);
+                }
+                return result;
+            }
+
+          private:
+            //--JSONTokenizer Private Member Types----------------------------------------------------------------------
+
+            /// @brief what the next unit of the text may be (the states from string to literal are within a token)
+            enum struct State : std::uint8_t
+            {
+                value,         ///< a value (at the top level or after a colon)
+                first_element, ///< an element or the end of an (empty) array
+                element,       ///< an element (after a comma)
+                first_key,     ///< a key or the end of an (empty) object
+                key,           ///< a key (after a comma)
+                colon,         ///< the colon after a key
+                next,          ///< a comma or the end of the current array/object
+                string,        ///< within a string
+                escape,        ///< after a backslash within a string
+                unicode,       ///< within the hex digits of a \\u escape sequence
+                continuation,  ///< within a multi-byte UTF-8 sequence in a string
+                number,        ///< within a number
+                literal,       ///< within true, false, or null
+                end,           ///< after the value (only whitespace may follow)
+                failed,        ///< after the first failure (the rest of the text is ignored)
+            };
+
+            /// @brief one bit per nesting level: 0 for arrays and 1 for objects
+            using ContainerBits = std::array<std::uint64_t, max_depth / 64>;
+
+            //--JSONTokenizer Member Variables--------------------------------------------------------------------------
+
+            Handler              handler;             ///< the handler receiving the tokens
+            ContainerBits        objects{};           ///< the kinds of the open arrays/objects
+            std::size_t          depth{0};            ///< the number of open arrays/objects
+            State                state{State::value}; ///< what the next unit of the text may be
+            JSONNumberGrammar    number{};            ///< the grammar of the current number
+            bool                 in_key{false};       ///< true if the current string is a key
+            std::size_t          pending{0};          ///< the units of the literal/escape/UTF-8 sequence seen/expected
+            char8_t              lower{0x80};         ///< the smallest valid next continuation byte
+            char8_t              upper{0xbf};         ///< the largest valid next continuation byte
+            std::u8string_view   literal{};           ///< the current literal
+            std::size_t          run{0};              ///< the start of the current token in the current chunk
+            std::size_t          offset{0};           ///< the offset of the current chunk in the text
+            JSONValidationResult result{};            ///< the outcome so far
+
+            //--JSONTokenizer Helpers-----------------------------------------------------------------------------------
+
+            /// @brief true if the innermost open container is an object
+            bool in_object() const noexcept { return (objects[(depth - 1) / 64] >> ((depth - 1) % 64)) & 1; }
+
+            /// @brief the state after a complete value
+            State end_value() const noexcept { return depth == 0 ? State::end : State::next; }
+
+            /// @brief records the first failure
+            void fail(const char *reason, std::size_t at) noexcept
+            {
+                result = JSONValidationResult{.valid = false, .offset = offset + at, .reason = reason};
+                state  = State::failed;
+            }
+
+            /// @brief starts a string, a number, or a literal
+            void begin_token(std::size_t at, State token) noexcept
+            {
+                run   = at;
+                state = token;
+            }
+
+            /// @brief passes the (rest of the) current token to the handler
+            /// @param chunk the current chunk
+            /// @param end the index after the token
+            /// @param next the state after the token
+            void end_token(std::u8string_view chunk, std::size_t end, State next)
+            {
+                handler.text(chunk.data() + run, end - run);
+                state = next;
+            }
+
+            /// @brief passes over the units of a string up to its end (or the end of the chunk), checking the
+            /// multi-byte UTF-8 sequences in between
+            /// @return the index after the units which were checked
+            std::size_t scan_string(std::u8string_view chunk, std::size_t i)
+            {
+                while (state == State::string)
+                {
+                    i = skip_ascii(chunk, i);
+                    if (i == chunk.size())
+                    {
+                        break;
+                    }
+
+                    const char8_t unit{chunk[i]};
+                    if (unit == u8'\"')
+                    {
+                        end_token(chunk, i + 1, in_key ? State::colon : end_value());
+                        return i + 1;
+                    }
+                    if (unit == u8'\\')
+                    {
+                        state = State::escape;
+                        return i + 1;
+                    }
+                    if (unit < 0x20)
+                    {
+                        fail("unescaped control character in a string", i);
+                        return i;
+                    }
+                    pending = JSONStringScanner::continuations(unit, lower, upper);
+                    if (pending == 0)
+                    {
+                        fail("invalid UTF-8", i);
+                        return i;
+                    }
+                    state = State::continuation;
+                    i     = continue_sequence(chunk, i + 1);
+                }
+                return i;
+            }
+
+            /// @brief skips the printable ASCII units of a string, block by block (see JSONStringScanner)
+            /// @return the index of the first unit which is not printable ASCII, or is a quote or a backslash (or the
+            /// size of the chunk)
+            static std::size_t skip_ascii(std::u8string_view chunk, std::size_t i) noexcept
+            {
+                constexpr std::size_t block_size{JSONStringScanner::block_size};
+
+                JSONStringScanner scanner{};
+                for (; i + block_size <= chunk.size(); i += block_size)
+                {
+                    const JSONStringScanner::Mask special{scanner.template scan<false, true>(chunk.data() + i)};
+                    if (special != 0)
+                    {
+                        return i + static_cast<std::size_t>(std::countr_zero(special));
+                    }
+                }
+                while (i < chunk.size() && chunk[i] < 0x80 && !JSONStringScanner::must_escape(chunk[i]))
+                {
+                    ++i;
+                }
+                return i;
+            }
+
+            /// @brief checks the continuation bytes of the current UTF-8 sequence which are in a chunk (see
+            /// JSONStringScanner::continuations(...))
+            /// @return the index after them
+            std::size_t continue_sequence(std::u8string_view chunk, std::size_t i) noexcept
+            {
+                for (; pending != 0 && i < chunk.size(); ++i, --pending)
+                {
+                    if (chunk[i] < lower || chunk[i] > upper)
+                    {
+                        fail("invalid UTF-8", i);
+                        return i;
+                    }
+                    lower = 0x80;
+                    upper = 0xbf;
+                }
+                if (pending == 0)
+                {
+                    state = State::string;
+                }
+                return i;
+            }
+
+            /// @brief handles a (non-whitespace) unit between tokens
+            /// @return true if the unit was consumed (false if it starts a number or a literal, which match it again)
+            bool structural(char8_t unit, std::size_t at)
+            {
+                switch (state)
+                {
+                case State::first_element:
+                case State::element:
+                    if (unit == u8']' && state == State::first_element)
+                    {
+                        close(unit, true);
+                        return true;
+                    }
+                    handler.separator(state == State::first_element, depth - 1);
+                    return begin_value(unit, at);
+                case State::first_key:
+                case State::key:
+                    if (unit == u8'}' && state == State::first_key)
+                    {
+                        close(unit, true);
+                        return true;
+                    }
+                    if (unit != u8'\"')
+                    {
+                        fail("expected a key", at);
+                        return false;
+                    }
+                    handler.separator(state == State::first_key, depth - 1);
+                    in_key = true;
+                    begin_token(at, State::string);
+                    return true;
+                case State::colon:
+                    if (unit != u8':')
+                    {
+                        fail("expected ':'", at);
+                        return false;
+                    }
+                    handler.colon();
+                    state = State::value;
+                    return true;
+                case State::next:
+                    if (unit == u8',')
+                    {
+                        state = in_object() ? State::key : State::element;
+                        return true;
+                    }
+                    if (unit != (in_object() ? u8'}' : u8']'))
+                    {
+                        fail(in_object() ? "expected ',' or '}'" : "expected ',' or ']'", at);
+                        return false;
+                    }
+                    close(unit, false);
+                    return true;
+                case State::end:
+                    fail("unexpected data after the value", at);
+                    return false;
+                case State::value:
+                default:
+                    return begin_value(unit, at);
+                }
+            }
+
+            /// @brief handles the first unit of a value
+            /// @return true if the unit was consumed (false if it starts a number or a literal, which match it again)
+            bool begin_value(char8_t unit, std::size_t at)
+            {
+                switch (unit)
+                {
+                case u8'[':
+                case u8'{': {
+                    if (depth == max_depth)
+                    {
+                        fail("too deeply nested", at);
+                        return false;
+                    }
+                    handler.open(unit, depth);
+                    const std::uint64_t bit{std::uint64_t{1} << (depth % 64)};
+                    objects[depth / 64] = unit == u8'{' ? (objects[depth / 64] | bit) : (objects[depth / 64] & ~bit);
+                    ++depth;
+                    state = unit == u8'[' ? State::first_element : State::first_key;
+                    return true;
+                }
+                case u8'\"':
+                    in_key = false;
+                    begin_token(at, State::string);
+                    return true;
+                case u8't':
+                case u8'f':
+                case u8'n':
+                    literal = unit == u8't' ? u8"true" : (unit == u8'f' ? u8"false" : u8"null");
+                    pending = 0;
+                    begin_token(at, State::literal);
+                    return false;
+                default:
+                    if (unit != u8'-' && (unit < u8'0' || unit > u8'9'))
+                    {
+                        fail("expected a value", at);
+                        return false;
+                    }
+                    number = JSONNumberGrammar{};
+                    begin_token(at, State::number);
+                    return false;
+                }
+            }
+
+            /// @brief closes the innermost open array/object
+            void close(char8_t bracket, bool empty)
+            {
+                --depth;
+                handler.close(bracket, empty, depth);
+                state = end_value();
+            }
+        };
+
+        /// @brief re-formats JSON text without building a JSONValue (so memory use does not depend on the size of
+        /// the input)
+        ///
+        /// the input is split into tokens by a JSONTokenizer, so it may be fed in chunks of any size, and nesting is
+        /// limited to JSONTokenizer's max_depth levels. Whitespace between tokens is dropped and the punctuation is
+        /// regenerated by the format (see JSONWriter), while strings and numbers are copied through verbatim (runs of
+        /// a token within a chunk are written at once)
+        ///
+        /// the input must be a single JSON value (surrounded by any amount of whitespace) in valid UTF-8; malformed
+        /// input throws (with the offset of the offending unit), after which the output written so far is incomplete
+        ///
+        /// @tparam Format the output format (see JSONDefaultFormat, JSONCompactFormat, and JSONPrettyFormat; formats
+        /// which sort keys can not be written without buffering and are not supported)
+        /// @tparam Sink the type receiving the output (see JSONStringSink and JSONStreamSink)
+        template <typename Format, typename Sink> class JSONReformatter
+        {
+            static_assert(!Format::sort_keys, "JSONReformatter can not sort keys without buffering whole objects");
+
+          public:
+            /// @brief creates a reformatter
+            /// @param sink the sink receiving the output
+            /// @param format the format (formats may have state, e.g. an indentation buffer)
+            explicit JSONReformatter(Sink &sink, Format format = Format{}) :
+                tokenizer{Writer{sink, std::move(format)}} { };
+
+            //--JSONReformatter Input-----------------------------------------------------------------------------------
+
+            /// @brief consumes the next chunk of the input
+            /// @param chunk the next chunk of the input
+            /// @return a reference to this JSONReformatter
+            /// @throws std::exception if the input is malformed
+            JSONReformatter &feed(std::u8string_view chunk)
+            {
+                check(tokenizer.feed(chunk));
+                return *this;
+            }
+
+            /// @brief consumes the rest of a stream (in fixed size chunks)
+            /// @param input the stream to read from (it should be opened in binary mode)
+            /// @return a reference to this JSONReformatter
+            /// @throws std::exception if the input is malformed
+            JSONReformatter &feed(std::istream &input)
+            {
+                std::array<char8_t, 1 << 16> buffer{};
+
+                // char may alias any object, so reading the bytes into char8_ts through a char pointer is well defined
+                while (input.read(reinterpret_cast<char *>(buffer.data()), buffer.size()) || input.gcount() > 0)
+                {
+                    feed(std::u8string_view{buffer.data(), static_cast<std::size_t>(input.gcount())});
+                }
+                return *this;
+            }
+
+            /// @brief marks the end of the input
+            /// @throws std::exception if the input ended before a complete value
+            void finish() { check(tokenizer.finish()); }
+
+          private:
+            //--JSONReformatter Private Member Types--------------------------------------------------------------------
+
+            /// @brief writes the tokens to the sink in the output format
+            struct Writer
+            {
+                Sink  &sink;   ///< the sink receiving the output
+                Format format; ///< the output format
+
+                void open(char8_t bracket, std::size_t depth) { format.open(sink, bracket, depth); }
+                void separator(bool first, std::size_t depth) { format.separator(sink, first, depth); }
+                void colon() { format.colon(sink); }
+                void close(char8_t bracket, bool empty, std::size_t depth)
+                {
+                    format.close(sink, bracket, empty, depth);
+                }
+                void text(const char8_t *data, std::size_t size) { sink.write(data, size); }
+            };
+
+            //--JSONReformatter Member Variables------------------------------------------------------------------------
+
+            JSONTokenizer<Writer> tokenizer; ///< splits the input into tokens
+
+            //--JSONReformatter Helpers---------------------------------------------------------------------------------
+
+            /// @brief throws a std::exception describing malformed input
+            static void check(const JSONValidationResult &result)
+            {
+                if (!result)
+                {
+                    const std::string message{std::string{"[ben::json::JSONReformatter] "} + result.reason +
+                                              " (at byte " + std::to_string(result.offset) + ")"};
+                    throw std::exception{message.c_str()};
+                }
+            }
+        };
+
+        /// @brief strips the whitespace from JSON text without building a JSONValue
+        /// @tparam Input std::u8string_view (or anything convertible to it) or a std::istream (read to its end)
+        /// @tparam Sink the type receiving the output
+        /// @param input the JSON text
+        /// @param sink the sink receiving the output
+        /// @throws std::exception if the input is malformed
+        /// @see JSONReformatter
+        template <typename Input, typename Sink> void minify(Input &&input, Sink &sink)
+        {
+            JSONReformatter<JSONCompactFormat, Sink>{sink}.feed(input).finish();
+        }
+
+        /// @brief re-formats JSON text in an output style without building a JSONValue
+        /// @tparam Input std::u8string_view (or anything convertible to it) or a std::istream (read to its end)
+        /// @tparam Sink the type receiving the output
+        /// @param input the JSON text
+        /// @param sink the sink receiving the output
+        /// @param options the output style (the canonical style sorts keys, so it can not be streamed)
+        /// @throws std::exception if the input is malformed or the canonical style is requested
+        /// @see JSONReformatter
+        template <typename Input, typename Sink>
+        void reformat(Input &&input, Sink &sink, const JSONSerializeOptions &options = {})
+        {
+            switch (options.style)
+            {
+            case JSONOutputStyle::compact:
+                JSONReformatter<JSONCompactFormat, Sink>{sink}.feed(input).finish();
+                break;
+            case JSONOutputStyle::pretty: {
+                JSONPrettyFormat format{options.indent_width, options.crlf};
+                JSONReformatter<JSONPrettyFormat, Sink>{sink, std::move(format)}.feed(input).finish();
+                break;
+            }
+            case JSONOutputStyle::canonical:
+                throw std::exception{"[ben::json::reformat] the canonical style can not be streamed"};
+            case JSONOutputStyle::standard:
+            default:
+                JSONReformatter<JSONDefaultFormat, Sink>{sink}.feed(input).finish();
+                break;
+            }
+        }
+
+        //--Raw Numbers-------------------------------------------------------------------------------------------------
+
+        /// @brief a number kept as its JSON text (e.g. as it was read from a document), so that passing it through
+        /// neither converts it twice nor changes how it is written: 1.10 stays 1.10, and integers which are too large
+        /// for a JSONValue::NumberType keep all of their digits
+        ///
+        /// the text is checked against the JSON grammar once, when the number is created; serializing the number
+        /// copies the text, and the binary value is only parsed (then cached) when value() is called. Unlike the
+        /// numbers of a JSONValue, a raw number is written as is: the precision of a JSONSerializeOptions does not
+        /// apply to it
+        ///
+        /// raw numbers are also exact: integers of any width (e.g. 64- or 128-bit ids) and decimals (e.g. amounts of
+        /// money, see decimal(...)) are written with all of their digits, converted back exactly by to_integer(...),
+        /// and compared by their digits (see compare(...)), so none of them needs a general big number library
+        class JSONRawNumber
+        {
+            /// @brief true if Integer is an integer type a raw number converts from and to exactly (i.e. not bool)
+            template <typename Integer>
+            static constexpr bool exact_integer_v{std::is_integral_v<Integer> && !std::is_same_v<Integer, bool>};
+
+          public:
+            /// @brief creates a raw number from its JSON text
+            /// @param text the text of the number (e.g. "-12.50e3")
+            /// @throws std::exception if the text is not a JSON number
+            explicit JSONRawNumber(std::u8string_view text) : lexeme{text}
+            {
+                if (!valid(text))
+                {
+                    throw std::exception{"[ben::json::JSONRawNumber] the text is not a JSON number"};
+                }
+            };
+
+            /// @brief creates a raw number from a number (written like serialize(...) writes it)
+            /// @throws std::exception if the number is NaN or infinite
+            explicit JSONRawNumber(JSONValue::NumberType value) : parsed{value}, has_value{true}
+            {
+                std::array<char8_t, JSONDefaultFormat::max_number_size> utf8;
+                lexeme.assign(utf8.data(), JSONDefaultFormat::format_number(value, utf8.data()));
+            };
+
+            /// @brief creates a raw number from an integer (with all of its digits)
+            template <typename Integer, std::enable_if_t<exact_integer_v<Integer>, bool> enabled = true>
+            explicit JSONRawNumber(Integer integer)
+            {
+                std::array<char8_t, max_digits<Integer> + 1> utf8;
+                utf8[0] = u8'-';
+                const std::size_t sign{integer < 0 ? 1u : 0u};
+                lexeme.assign(utf8.data(), sign + format_magnitude(integer, utf8.data() + sign));
+            };
+
+            /// @brief creates a raw number from a decimal, e.g. decimal(-12345, 2) is -123.45
+            /// @param unscaled the digits of the decimal (as an integer)
+            /// @param scale the number of digits after the decimal point
+            template <typename Integer, std::enable_if_t<exact_integer_v<Integer>, bool> enabled = true>
+            static JSONRawNumber decimal(Integer unscaled, std::size_t scale)
+            {
+                if (scale == 0)
+                {
+                    return JSONRawNumber{unscaled};
+                }
+
+                std::array<char8_t, max_digits<Integer>> utf8;
+                const std::size_t                        count{format_magnitude(unscaled, utf8.data())};
+                std::u8string     text{unscaled < 0 ? u8"-" : u8""};
+                if (count <= scale)
+                {
+                    text.append(u8"0.").append(scale - count, u8'0').append(utf8.data(), count);
+                }
+                else
+                {
+                    text.append(utf8.data(), count - scale).append(1, u8'.').append(utf8.data() + count - scale, scale);
+                }
+                return JSONRawNumber{std::u8string_view{text}};
+            }
+
+            /// @brief true if a text is a JSON number (without surrounding whitespace)
+            static bool valid(std::u8string_view text) noexcept
+            {
+                if (text.empty() || (text[0] != u8'-' && (text[0] < u8'0' || text[0] > u8'9')))
+                {
+                    return false;
+                }
+                JSONNumberGrammar grammar{};
+                for (const char8_t unit : text)
+                {
+                    if (!grammar.step(unit))
+                    {
+                        return false;
+                    }
+                }
+                return grammar.complete();
+            }
+
+            /// @brief the JSON text of the number
+            std::u8string_view text() const noexcept { return lexeme; }
+
+            /// @brief the value of the number (parsed from the text on the first call; integers beyond the precision
+            /// of a JSONValue::NumberType are rounded)
+            /// @throws std::exception if the number is out of the range of a JSONValue::NumberType
+            JSONValue::NumberType value() const
+            {
+                if (!has_value)
+                {
+                    // char may alias the UTF-8 code units, so the text is parsed in place
+                    const char *const chars{reinterpret_cast<const char *>(lexeme.data())};
+                    if (std::from_chars(chars, chars + lexeme.size(), parsed).ec != std::errc{})
+                    {
+                        throw std::exception{"[ben::json::JSONRawNumber] the number is out of range"};
+                    }
+                    has_value = true;
+                }
+                return parsed;
+            }
+
+            /// @brief converts the number to an integer exactly
+            /// @param out receives the integer (left as it was if the number can not be converted)
+            /// @param scale the number of decimal places the integer holds (e.g. 2 to convert 123.45 to 12345 cents)
+            /// @return false if the number times 10^scale is not an integer or does not fit in the integer type
+            template <typename Integer, std::enable_if_t<exact_integer_v<Integer>, bool> enabled = true>
+            bool to_integer(Integer &out, std::size_t scale = 0) const noexcept
             {
-                if (value.type == JSONValue::JSONValueType::undefined)
+                const Digits digits{split()};
+                if (digits.first == digits.size())
                 {
-                    continue;
+                    out = 0;
+                    return true;
                 }
 
-                if (!first)
+                // the significant digits must all be before the (scaled) decimal point
+                const std::int64_t point{digits.point + static_cast<std::int64_t>(scale)};
+                const std::int64_t first{static_cast<std::int64_t>(digits.first)};
+                if (point <= static_cast<std::int64_t>(digits.last) || point - first > 39)
+                {
+                    return false;
+                }
+
+                std::array<char, 41> ascii;
+                std::size_t          size{0};
+                if (digits.negative)
+                {
+                    ascii[size++] = '-';
+                }
+                for (std::int64_t i = first; i < point; ++i)
+                {
+                    ascii[size++] = static_cast<char>(digits.at(static_cast<std::size_t>(i)));
+                }
+                Integer                      integer{0};
+                const std::from_chars_result res{std::from_chars(ascii.data(), ascii.data() + size, integer)};
+                if (res.ec != std::errc{} || res.ptr != ascii.data() + size)
+                {
+                    return false;
+                }
+                out = integer;
+                return true;
+            }
+
+            /// @brief compares two raw numbers by value, exactly (so 1.10 equals 1.1 and 1e2 equals 100)
+            ///
+            /// integers without exponents (e.g. ids) are compared by their sign, their length, and then their
+            /// digits; other numbers are compared by the exponent of their first significant digit and then their
+            /// significant digits
+            /// @return a negative integer, zero, or a positive integer if this number is less than, equal to, or
+            /// greater than the other number
+            int compare(const JSONRawNumber &other) const noexcept
+            {
+                if (lexeme == other.lexeme)
+                {
+                    return 0;
+                }
+                if (lexeme.find_first_of(u8".eE") == std::u8string::npos &&
+                    other.lexeme.find_first_of(u8".eE") == std::u8string::npos)
+                {
+                    // JSON integers have no leading zeros, so a longer integer has a greater magnitude
+                    const std::u8string_view lhs{std::u8string_view{lexeme}.substr(lexeme[0] == u8'-' ? 1 : 0)};
+                    const std::u8string_view rhs{
+                        std::u8string_view{other.lexeme}.substr(other.lexeme[0] == u8'-' ? 1 : 0)};
+                    const int lhs_sign{lhs == u8"0" ? 0 : (lexeme[0] == u8'-' ? -1 : 1)};
+                    const int rhs_sign{rhs == u8"0" ? 0 : (other.lexeme[0] == u8'-' ? -1 : 1)};
+                    if (lhs_sign != rhs_sign || lhs_sign == 0)
+                    {
+                        return lhs_sign - rhs_sign;
+                    }
+                    const int order{
+                        lhs.size() != rhs.size() ? (lhs.size() < rhs.size() ? -1 : 1) : lhs.compare(rhs)};
+                    return lhs_sign * order;
+                }
+
+                const Digits lhs{split()};
+                const Digits rhs{other.split()};
+                const bool   lhs_zero{lhs.first == lhs.size()};
+                const bool   rhs_zero{rhs.first == rhs.size()};
+                if (lhs_zero || rhs_zero)
+                {
+                    return (lhs_zero ? 0 : (lhs.negative ? -1 : 1)) - (rhs_zero ? 0 : (rhs.negative ? -1 : 1));
+                }
+                if (lhs.negative != rhs.negative)
+                {
+                    return lhs.negative ? -1 : 1;
+                }
+
+                // the magnitudes, compared by their leading exponent and then digit by digit (trailing zeros aside)
+                const int sign{lhs.negative ? -1 : 1};
+                if (lhs.leading() != rhs.leading())
+                {
+                    return lhs.leading() < rhs.leading() ? -sign : sign;
+                }
+                for (std::size_t i = lhs.first, j = rhs.first; i <= lhs.last || j <= rhs.last; ++i, ++j)
+                {
+                    const char8_t left{i <= lhs.last ? lhs.at(i) : u8'0'};
+                    const char8_t right{j <= rhs.last ? rhs.at(j) : u8'0'};
+                    if (left != right)
+                    {
+                        return left < right ? -sign : sign;
+                    }
+                }
+                return 0;
+            }
+
+          private:
+            /// @brief the digits of the text: the integer and fraction digits (one sequence), the position of the
+            /// decimal point within them (moved by the exponent), and the first and last significant digit
+            struct Digits
+            {
+                bool               negative{false}; ///< true if the number has a minus sign
+                std::u8string_view integer{};       ///< the digits before the decimal point in the text
+                std::u8string_view fraction{};      ///< the digits after the decimal point in the text
+                std::int64_t       point{0};        ///< the index of the first digit after the (moved) decimal point
+                std::size_t        first{0};        ///< the index of the first non-zero digit (size() if none)
+                std::size_t        last{0};         ///< the index of the last non-zero digit
+
+                std::size_t size() const noexcept { return integer.size() + fraction.size(); }
+
+                char8_t at(std::size_t i) const noexcept
+                {
+                    return i < integer.size() ? integer[i] : (i < size() ? fraction[i - integer.size()] : u8'0');
+                }
+
+                /// @brief the exponent of the first significant digit
+                std::int64_t leading() const noexcept { return point - static_cast<std::int64_t>(first) - 1; }
+            };
+
+            Digits split() const noexcept
+            {
+                Digits            digits{};
+                const std::size_t sign{lexeme[0] == u8'-' ? std::size_t{1} : std::size_t{0}};
+                const std::size_t exponent{std::min(lexeme.find_first_of(u8"eE"), lexeme.size())};
+                const std::size_t dot{std::min(lexeme.find(u8'.'), exponent)};
+                digits.negative = sign == 1;
+                digits.integer  = std::u8string_view{lexeme}.substr(sign, dot - sign);
+                digits.fraction = dot < exponent ? std::u8string_view{lexeme}.substr(dot + 1, exponent - dot - 1)
+                                                 : std::u8string_view{};
+
+                // exponents beyond the range of any number are clamped (which keeps the comparisons right)
+                std::int64_t shift{0};
+                if (exponent < lexeme.size())
+                {
+                    const char *const chars{reinterpret_cast<const char *>(lexeme.data())};
+                    const std::size_t start{exponent + (lexeme[exponent + 1] == u8'+' ? 2 : 1)};
+                    if (std::from_chars(chars + start, chars + lexeme.size(), shift).ec != std::errc{})
+                    {
+                        shift = lexeme[exponent + 1] == u8'-' ? -(std::int64_t{1} << 53) : std::int64_t{1} << 53;
+                    }
+                    shift = std::clamp(shift, -(std::int64_t{1} << 53), std::int64_t{1} << 53);
+                }
+                digits.point = static_cast<std::int64_t>(digits.integer.size()) + shift;
+
+                digits.first = digits.size();
+                for (std::size_t i = 0; i < digits.size(); ++i)
+                {
+                    if (digits.at(i) != u8'0')
+                    {
+                        digits.first = digits.first == digits.size() ? i : digits.first;
+                        digits.last  = i;
+                    }
+                }
+                return digits;
+            }
+
+            /// @brief the number of digits of the largest magnitude of an integer type
+            template <typename Integer>
+            static constexpr std::size_t max_digits{
+                std::max<std::size_t>(std::numeric_limits<std::make_unsigned_t<Integer>>::digits10 + 1,
+                                      JSONIntegerFormatter::max_size)};
+
+            /// @brief writes the digits of the magnitude of an integer (without a sign)
+            /// @param out the buffer (at least max_digits<Integer> units)
+            /// @return the number of units written
+            template <typename Integer> static std::size_t format_magnitude(Integer integer, char8_t *out) noexcept
+            {
+                using Unsigned = std::make_unsigned_t<Integer>;
+                const Unsigned bits{static_cast<Unsigned>(integer)};
+                Unsigned       value{integer < 0 ? static_cast<Unsigned>(Unsigned{0} - bits) : bits};
+                if constexpr (sizeof(Unsigned) <= sizeof(std::uint64_t))
+                {
+                    return JSONIntegerFormatter::format(static_cast<std::uint64_t>(value), false, out);
+                }
+                else
+                {
+                    // wider integers (e.g. __int128) are split into chunks of 19 digits, each of which fits in 64 bits
+                    constexpr std::uint64_t chunk{10'000'000'000'000'000'000ull};
+                    constexpr std::size_t   chunk_digits{19};
+
+                    std::array<std::uint64_t, std::numeric_limits<Unsigned>::digits10 / chunk_digits + 1> chunks;
+                    std::size_t count{0};
+                    do
+                    {
+                        chunks[count++] = static_cast<std::uint64_t>(value % chunk);
+                        value /= chunk;
+                    } while (value != 0);
+
+                    std::size_t size{JSONIntegerFormatter::format(chunks[--count], false, out)};
+                    std::array<char8_t, JSONIntegerFormatter::max_size> digits;
+                    while (count > 0)
+                    {
+                        const std::size_t written{JSONIntegerFormatter::format(chunks[--count], false, digits.data())};
+                        std::fill_n(out + size, chunk_digits - written, u8'0');
+                        std::copy_n(digits.data(), written, out + size + chunk_digits - written);
+                        size += chunk_digits;
+                    }
+                    return size;
+                }
+            }
+
+            std::u8string                 lexeme{};         ///< the JSON text of the number
+            mutable JSONValue::NumberType parsed{0};        ///< the value of the number (once it is parsed)
+            mutable bool                  has_value{false}; ///< true once the value has been parsed
+        };
+
+        /// @brief true if two raw numbers are equal in value (see JSONRawNumber::compare(...))
+        inline bool operator==(const JSONRawNumber &lhs, const JSONRawNumber &rhs) noexcept
+        {
+            return lhs.compare(rhs) == 0;
+        }
+
+        /// @brief true if a raw number is less than another in value (see JSONRawNumber::compare(...))
+        inline bool operator<(const JSONRawNumber &lhs, const JSONRawNumber &rhs) noexcept
+        {
+            return lhs.compare(rhs) < 0;
+        }
+
+        bJSON_MAKE_SERIALIZABLE_INLINE(JSONRawNumber)
+        {
+            return std::u8string{val.text()};
+        }
+
+        //--JSON Pull Reading-------------------------------------------------------------------------------------------
+
+        /// @brief reads JSON text straight into typed values, token by token, without building JSONValues (it is what
+        /// the deserializers written by the bjsongen tool are made of)
+        ///
+        /// objects are read with begin_object() and next_member() (which reads the next key and its colon), arrays
+        /// with begin_array() and next_element(), and values with read(...); unwanted values are skipped with skip().
+        /// Strings without escape sequences are viewed in place rather than copied. Malformed text (or a value of the
+        /// wrong type) throws with the offset of the error; the text is expected to be UTF-8 (see validate(...))
+        class JSONPullReader
+        {
+          public:
+            /// @brief creates a reader
+            /// @param text the JSON text (which must outlive the reader)
+            explicit JSONPullReader(std::u8string_view text) noexcept : text{text} { };
+
+            /// @brief reads the opening brace of an object
+            void begin_object()
+            {
+                expect(u8'{');
+                first = true;
+            }
+
+            /// @brief reads the next member's key (and colon) of the object being read
+            /// @return false (having read the closing brace) if the object has no more members
+            bool next_member()
+            {
+                if (!next(u8'}'))
+                {
+                    return false;
+                }
+                member_key = string_token(key_buffer);
+                expect(u8':');
+                return true;
+            }
+
+            /// @brief the key of the member read last, unescaped (valid until the next call of next_member())
+            std::u8string_view key() const noexcept { return member_key; }
+
+            /// @brief reads the opening bracket of an array
+            void begin_array()
+            {
+                expect(u8'[');
+                first = true;
+            }
+
+            /// @brief moves to the next element of the array being read
+            /// @return false (having read the closing bracket) if the array has no more elements
+            bool next_element() { return next(u8']'); }
+
+            /// @brief reads a null if it is next (e.g. for an optional value)
+            /// @return true if a null was read
+            bool read_null()
+            {
+                skip_whitespace();
+                if (text.substr(pos, 4) != u8"null")
+                {
+                    return false;
+                }
+                pos += 4;
+                return true;
+            }
+
+            /// @brief reads a value: a boolean, a number (into an integral or floating point type, which must hold
+            /// it exactly or approximately, respectively), a string (into a std::u8string or std::string), the name
+            /// of an enumerator of an enum registered with bJSON_ENUM(...), or base64 (into a
+            /// std::vector<std::uint8_t>, see JSONBlob)
+            /// @throws std::exception if the next value is not of the type or can not be held by it
+            template <typename T> void read(T &out)
+            {
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    skip_whitespace();
+                    if (text.substr(pos, 4) == u8"true")
+                    {
+                        out = true;
+                        pos += 4;
+                    }
+                    else if (text.substr(pos, 5) == u8"false")
+                    {
+                        out = false;
+                        pos += 5;
+                    }
+                    else
+                    {
+                        fail("expected true or false");
+                    }
+                }
+                else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>)
+                {
+                    const std::u8string_view digits{number_token()};
+                    const char *const        first{reinterpret_cast<const char *>(digits.data())};
+                    const char *const        last{first + digits.size()};
+                    const auto [end, error]{std::from_chars(first, last, out)};
+                    if (error == std::errc::result_out_of_range)
+                    {
+                        fail("the number is out of range");
+                    }
+                    if (end != last)
+                    {
+                        // (integral types stop at a fraction or an exponent)
+                        fail(std::is_integral_v<T> ? "expected an integer" : "expected a floating point number");
+                    }
+                }
+                else if constexpr (std::is_same_v<T, JSONValue::StringType> || std::is_same_v<T, std::string>)
                 {
-                    serialized.push_back(u8',');
+                    const std::u8string_view units{string_token(value_buffer)};
+                    out.assign(reinterpret_cast<const typename T::value_type *>(units.data()), units.size());
+                }
+                else if constexpr (is_json_enum_v<T>)
+                {
+                    if (!parse_enum(string_token(value_buffer), out))
+                    {
+                        fail("unknown enumerator");
+                    }
                 }
                 else
                 {
+                    static_assert(
+                        std::is_same_v<T, std::vector<std::uint8_t>>,
+                        "[ben::json::JSONPullReader] values of the type can not be read");
+                    if (!decode_base64(string_token(value_buffer), out))
+                    {
+                        fail("expected base64");
+                    }
+                }
+            }
+
+            /// @brief skips a value (of any type, including nested arrays and objects)
+            void skip()
+            {
+                skip_whitespace();
+                const char8_t unit{peek()};
+                if (unit == u8'{' || unit == u8'[')
+                {
+                    const bool object{unit == u8'{'};
+                    object ? begin_object() : begin_array();
+                    while (object ? next_member() : next_element())
+                    {
+                        skip();
+                    }
+                }
+                else if (unit == u8'\"')
+                {
+                    string_token(value_buffer);
+                }
+                else if (unit == u8'-' || (unit >= u8'0' && unit <= u8'9'))
+                {
+                    number_token();
+                }
+                else if (!read_null())
+                {
+                    bool literal{false};
+                    read(literal);
+                }
+            }
+
+            /// @brief checks that nothing but whitespace is left
+            void finish()
+            {
+                skip_whitespace();
+                if (pos != text.size())
+                {
+                    fail("unexpected text after the value");
+                }
+            }
+
+            /// @brief the offset (in bytes) of the next unit to read
+            std::size_t offset() const noexcept { return pos; }
+
+          private:
+            std::u8string_view text;           ///< the JSON text
+            std::size_t        pos{0};         ///< the offset of the next unit to read
+            bool               first{false};   ///< true until the first element/member of a container is reached
+            std::u8string_view member_key{};   ///< the key of the member read last
+            std::u8string      key_buffer{};   ///< the unescaped key (when it has escape sequences)
+            std::u8string      value_buffer{}; ///< the unescaped string value (when it has escape sequences)
+
+            [[noreturn]] void fail(const char *what) const
+            {
+                std::string message{"[ben::json::JSONPullReader] "};
+                message.append(what);
+                message.append(" at offset ");
+                message.append(std::to_string(pos));
+                throw std::exception{message.c_str()};
+            }
+
+            char8_t peek() const noexcept { return pos < text.size() ? text[pos] : u8'\0'; }
+
+            void skip_whitespace() noexcept
+            {
+                while (pos < text.size() &&
+                       (text[pos] == u8' ' || text[pos] == u8'\n' || text[pos] == u8'\r' || text[pos] == u8'\t'))
+                {
+                    ++pos;
+                }
+            }
+
+            void expect(char8_t unit)
+            {
+                skip_whitespace();
+                if (peek() != unit)
+                {
+                    const std::string message{std::string{"expected '"} + static_cast<char>(unit) + "'"};
+                    fail(message.c_str());
+                }
+                ++pos;
+            }
+
+            /// @brief moves past the comma before the next element/member of a container
+            /// @return false (having read the closing unit) if there is no next element/member
+            bool next(char8_t close)
+            {
+                skip_whitespace();
+                if (peek() == close)
+                {
+                    ++pos;
                     first = false;
+                    return false;
+                }
+                if (!first)
+                {
+                    expect(u8',');
                 }
+                first = false;
+                return true;
+            }
 
-                serialized.push_back(u8' ');
-                serialized.append(serialize(JSONValue{key}));
-                serialized.append(u8" : ");
-                serialized.append(serialize(value));
+            /// @brief reads a number (checked against the JSON grammar)
+            /// @return the text of the number
+            std::u8string_view number_token()
+            {
+                skip_whitespace();
+                const std::size_t start{pos};
+                const char8_t     unit{peek()};
+                if (unit != u8'-' && (unit < u8'0' || unit > u8'9'))
+                {
+                    fail("expected a number");
+                }
+                JSONNumberGrammar grammar{};
+                while (pos < text.size() && grammar.step(text[pos]))
+                {
+                    ++pos;
+                }
+                if (!grammar.complete())
+                {
+                    fail("incomplete number");
+                }
+                return text.substr(start, pos - start);
             }
-            serialized.append(u8" }");
-            return serialized;
-        }
 
-        inline bJSON_DEFINE_SERIALIZATION(JSONValue)
+            /// @brief reads a string: viewed in place if it has no escape sequences, otherwise unescaped into a buffer
+            /// (unpaired surrogates become U+FFFD)
+            std::u8string_view string_token(std::u8string &buffer)
+            {
+                expect(u8'\"');
+                const std::size_t start{pos};
+                while (pos < text.size() && text[pos] != u8'\"' && text[pos] != u8'\\' && text[pos] >= 0x20)
+                {
+                    ++pos;
+                }
+                if (peek() == u8'\"')
+                {
+                    return text.substr(start, pos++ - start);
+                }
+
+                buffer.assign(text.data() + start, pos - start);
+                while (pos < text.size() && text[pos] != u8'\"')
+                {
+                    const char8_t unit{text[pos++]};
+                    if (unit < 0x20)
+                    {
+                        --pos;
+                        fail("control character in string");
+                    }
+                    if (unit != u8'\\')
+                    {
+                        buffer.push_back(unit);
+                        continue;
+                    }
+
+                    const char8_t escape{peek()};
+                    ++pos;
+                    switch (escape)
+                    {
+                    case u8'\"':
+                    case u8'\\':
+                    case u8'/':
+                        buffer.push_back(escape);
+                        break;
+                    case u8'b':
+                        buffer.push_back(u8'\b');
+                        break;
+                    case u8'f':
+                        buffer.push_back(u8'\f');
+                        break;
+                    case u8'n':
+                        buffer.push_back(u8'\n');
+                        break;
+                    case u8'r':
+                        buffer.push_back(u8'\r');
+                        break;
+                    case u8't':
+                        buffer.push_back(u8'\t');
+                        break;
+                    case u8'u':
+                    {
+                        char32_t code_point{hex()};
+                        if (code_point >= 0xd800 && code_point < 0xdc00 && text.substr(pos, 2) == u8"\\u")
+                        {
+                            const std::size_t high{pos};
+                            pos += 2;
+                            const char32_t low{hex()};
+                            if (low >= 0xdc00 && low < 0xe000)
+                            {
+                                code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+                            }
+                            else
+                            {
+                                pos = high; // the second escape sequence is read on its own
+                            }
+                        }
+                        if (code_point >= 0xd800 && code_point < 0xe000)
+                        {
+                            code_point = JSONTranscoder::replacement;
+                        }
+                        std::array<char8_t, 4> utf8;
+                        buffer.append(utf8.data(), JSONTranscoder::encode(code_point, utf8.data()));
+                        break;
+                    }
+                    default:
+                        --pos;
+                        fail("invalid escape sequence");
+                    }
+                }
+                if (pos == text.size())
+                {
+                    fail("unterminated string");
+                }
+                ++pos;
+                return buffer;
+            }
+
+            /// @brief reads the four hexadecimal digits of a \\u escape sequence
+            char32_t hex()
+            {
+                char32_t value{0};
+                for (std::size_t i = 0; i < 4; ++i, ++pos)
+                {
+                    const char8_t unit{peek()};
+                    int           digit{-1};
+                    if (unit >= u8'0' && unit <= u8'9')
+                    {
+                        digit = unit - u8'0';
+                    }
+                    else if ((unit | 0x20) >= u8'a' && (unit | 0x20) <= u8'f')
+                    {
+                        digit = (unit | 0x20) - u8'a' + 10;
+                    }
+                    if (digit < 0)
+                    {
+                        fail("invalid \\u escape sequence");
+                    }
+                    value = value << 4 | static_cast<char32_t>(digit);
+                }
+                return value;
+            }
+        };
+
+        //--JSON Validation---------------------------------------------------------------------------------------------
+
+        /// @brief checks that text is well-formed JSON (a single value, surrounded by any amount of whitespace) in
+        /// valid UTF-8, without building any values
+        ///
+        /// the text is split into tokens by a JSONTokenizer which ignores them, so the validator never allocates and
+        /// reports failures through the result rather than by throwing. The text may be fed in chunks of any size;
+        /// tokens (including multi-byte UTF-8 sequences) may span chunks
+        class JSONValidator
         {
-            std::u8string serialized{u8""};
-            switch (val.type)
+          public:
+            /// @brief the deepest nesting of arrays/objects which is accepted
+            static constexpr std::size_t max_depth{JSONTokenizer<JSONNullTokenHandler>::max_depth};
+
+            //--JSONValidator Input-------------------------------------------------------------------------------------
+
+            /// @brief checks the next chunk of the text (once the text is known to be invalid, input is ignored)
+            /// @param chunk the next chunk of the text
+            /// @return a reference to this JSONValidator
+            JSONValidator &feed(std::u8string_view chunk) noexcept
             {
-            case JSONValue::JSONValueType::literal:
-                serialized.append(serialize(std::get<JSONValue::LiteralType>(val.value)));
-                break;
-            case JSONValue::JSONValueType::number:
-                serialized.append(serialize(std::get<JSONValue::NumberType>(val.value)));
-                break;
-            case JSONValue::JSONValueType::string:
-                serialized.append(serialize(std::get<JSONValue::StringType>(val.value)));
-                break;
-            case JSONValue::JSONValueType::array:
-                serialized.append(serialize(std::get<JSONValue::ArrayType>(val.value)));
-                break;
-            case JSONValue::JSONValueType::object:
-                serialized.append(serialize(std::get<JSONValue::ObjectType>(val.value)));
-                break;
-            case JSONValue::JSONValueType::undefined:
-            default:
-                throw std::exception{"JSONValue::type was 'undefined' -- it can not be serialized!"};
-                break;
+                tokenizer.feed(chunk);
+                return *this;
             }
-            return serialized;
-        }
 
-        //--Converts to JSONValue Type
-        // Template-------------------------------------------------------------------------
+            /// @brief marks the end of the text
+            /// @return the outcome of the check
+            JSONValidationResult finish() noexcept { return tokenizer.finish(); }
 
-        /// @brief templated serialization function which is enabled via the second template parameter which depends
-        /// on the type not being JSON serializable itself, but serializable via conversion to a JSONValue
-        /// @tparam T the type (which is NOT JSON serializable but CAN be used to construct a JSONValue) to
-        /// serialize
-        /// @tparam enabled the second template parameter which is of type bool and defaults to true, only present
-        /// when enable_if_t<> evaluates to true which happens when T is not directly serializable but can be
-        /// converted to a JSONValue
-        /// @param val the value to serialize (passed by forwarding reference)
-        /// @return (constexpr) const string containing the result of the serialization implementation for the value
-        /// of type T
-        /// @see ben::json::serialize<ben::json::JSONValue>(const ben::json::JSONValue & val)
-        template <typename T, std::enable_if_t<converts_to_json_value_v<T>, bool> enabled = true>
-        const std::u8string serialize(T &&val) noexcept
+            /// @brief forgets everything fed so far (so the validator can check another text)
+            void reset() noexcept { *this = JSONValidator{}; }
+
+          private:
+            //--JSONValidator Member Variables--------------------------------------------------------------------------
+
+            JSONTokenizer<JSONNullTokenHandler> tokenizer{}; ///< checks the text
+        };
+
+        /// @brief checks that text is well-formed JSON in valid UTF-8, without building any values
+        /// @param text the text to check
+        /// @return the outcome of the check
+        /// @see JSONValidator
+        inline JSONValidationResult validate(std::u8string_view text) noexcept
         {
-            return serialize(JSONValue{std::forward<T>(val)});
+            return JSONValidator{}.feed(text).finish();
         }
 
     } // namespace json
 
 } // namespace ben
 
+/// @brief hashes JSONValues structurally (so they can be used as keys of unordered containers)
+/// @see ben::json::hash(const ben::json::JSONValue &value)
+template <> struct std::hash<ben::json::JSONValue>
+{
+    std::size_t operator()(const ben::json::JSONValue &value) const
+    {
+        return static_cast<std::size_t>(ben::json::hash(value));
+    }
+};
+
 #undef bJSON_NAMESPACE
 #define bJSON_NAMESPACE() ben::json::
 
@@ -88,6 +88,30 @@ function make_examples()
     ]]
 end
 
+function make_tools()
+  -- the command line tool (minify/format JSON in constant memory)
+  project "bjson"
+    set_project_defaults()
+    kind "ConsoleApp"
+
+    -- the tool has its own entry point
+    defines{"bNO_ENTRY_POINT",}
+    removefiles{"../src/**.*",}
+
+    files{"../tools/bjson/**.*",}
+
+  -- the code generator (structs and specialized serializers/deserializers from an IDL)
+  project "bjsongen"
+    set_project_defaults()
+    kind "ConsoleApp"
+
+    -- the tool has its own entry point
+    defines{"bNO_ENTRY_POINT",}
+    removefiles{"../src/**.*",}
+
+    files{"../tools/bjsongen/**.*",}
+end
+
 --[[
 ##########################################################################################
     "CONTEXT VARIABLES" -- useful for getting/setting/manipulating context values
@@ -448,6 +472,16 @@ function make_test_project ()
 
     -- Set the project specific files
     files{"../tests/**.*",}
+
+    -- the generated code tests include the header bjsongen generates from the test IDL (so it is always current)
+    dependson{"bjsongen",}
+    includedirs{"%{prj.location}generated/",}
+    prebuildmessage "Generating test headers."
+    prebuildcommands
+    {
+      "{MKDIR} %[%{prj.location}generated]",
+      "%[%{prj.location}bin/%{cfg.platform}/%{cfg.buildcfg}/bjsongen] %[../tests/bjsongen/catalog.idl] %[%{prj.location}generated/catalog.h]"
+    }
 end
 
 --[[
@@ -609,6 +643,10 @@ function build_workspace_and_projects()
   -- make the examples (if we're building examples)
   group "Examples"
   if (string.lower(cv.buildExamples) == "true") then make_examples() end
+
+  -- make the tools
+  group "Tools"
+  make_tools()
 end
 
 --[[
@@ -6,12 +6,48 @@
 #include "bJSON.h"
 #include "bUnitTests.h"
 
+// generated by bjsongen from tests/bjsongen/catalog.idl when the tests are built
+#include "catalog.h"
+
 //--"PRIVATE" TEST VALUES-----------------------------------------------------------------------------------------------
 
 namespace
 {
     using namespace ben::json;
 
+    /// @brief example enums (contiguous, and with gaps) registered with bJSON_ENUM()
+    enum struct Color
+    {
+        red,
+        green,
+        blue
+    };
+
+    enum Status : short
+    {
+        failed  = -1,
+        pending = 10,
+        done    = 20
+    };
+
+    /// @brief example aggregates registered with bJSON_AGGREGATE()
+    struct Point
+    {
+        int           x{0};
+        double        y{0};
+        std::u8string label{u8""};
+    };
+
+    struct Shape
+    {
+        Point                     origin{};
+        Color                     color{Color::red};
+        bool                      filled{false};
+        float                     scale{1};
+        std::string               name{""};
+        std::chrono::milliseconds lifetime{0};
+    };
+
     /// @brief example struct based on example usage documentation
     struct Example
     {
@@ -21,6 +57,14 @@ namespace
 
 } // namespace
 
+// example enum registrations
+bJSON_ENUM(Color, red, green, blue);
+bJSON_ENUM(Status, failed, pending, done);
+
+// example aggregate registrations
+bJSON_AGGREGATE(Point, x, y, label);
+bJSON_AGGREGATE(Shape, origin, color, filled, scale, name, lifetime);
+
 // example struct serialization implementation based on example usage documentation
 bJSON_MAKE_SERIALIZABLE(Example)
 {
@@ -161,7 +205,8 @@ bTEST_FUNCTION(conversion_types_work_correctly, "serialization")
     // constructor up to this point)
     bTEST_ASSERT(serialize(u8"test") == serialize(std::u8string(u8"test")));
 
-    // we need a "smarter"/more nuanced way to handle char* and string conversions so we'll save those for a later time
+    // ...as well as char* literals and the other string types (see other_string_types_are_transcoded)
+    bTEST_ASSERT(serialize("test") == serialize(std::u8string(u8"test")));
 
     // will add more conversion tests here as new conversions are added! We hit the "big three" though --
     // bools/literals, numbers, and strings!
@@ -185,4 +230,1285 @@ bTEST_FUNCTION(example_type_works_correctly, "serialization")
     bTEST_ASSERT(serialize(e1) == u8R"""({ "name" : "top-level", "parent" : null })""");
     bTEST_ASSERT(serialize(e2) == u8R"""({ "name" : "child", "parent" : "top-level" })""");
     bTEST_ASSERT(serialize(e3) == u8"");
+};
+
+/// @brief ensures that compiled JSONPath expressions select the expected nodes (children, wildcards, recursive descent,
+/// slices, and filters)
+bTEST_FUNCTION(json_path_selects_expected_nodes, "json path")
+{
+    using namespace ben::json;
+
+    const JSONValue document{JSONValue::ObjectType{
+        {u8"store",
+         JSONValue::ObjectType{
+             {u8"books",
+              JSONValue::ArrayType{
+                  JSONValue::ObjectType{{u8"title", u8"A"}, {u8"price", 8}},
+                  JSONValue::ObjectType{{u8"title", u8"B"}, {u8"price", 12}, {u8"isbn", u8"0-1"}},
+                  JSONValue::ObjectType{{u8"title", u8"C"}, {u8"price", 9}},
+                  JSONValue::ObjectType{{u8"title", u8"D"}, {u8"price", 23}, {u8"isbn", u8"0-2"}}}},
+             {u8"bicycle", JSONValue::ObjectType{{u8"price", 20}}}}}
+    }};
+
+    const auto titles = [&document](std::u8string_view expression)
+    {
+        std::u8string joined{};
+        JSONPath::compile(expression)
+            .evaluate(
+                document,
+                [&joined](const JSONValue &node) { joined.append(std::get<JSONValue::StringType>(node.value)); });
+        return joined;
+    };
+
+    bTEST_ASSERT(titles(u8"$.store.books[0].title") == u8"A");
+    bTEST_ASSERT(titles(u8"$['store']['books'][-1]['title']") == u8"D");
+    bTEST_ASSERT(titles(u8"$.store.books[*].title") == u8"ABCD");
+    bTEST_ASSERT(titles(u8"$..title") == u8"ABCD");
+    bTEST_ASSERT(titles(u8"$.store.books[1:3].title") == u8"BC");
+    bTEST_ASSERT(titles(u8"$.store.books[::-2].title") == u8"DB");
+    bTEST_ASSERT(titles(u8"$.store.books[?(@.price < 10)].title") == u8"AC");
+    bTEST_ASSERT(titles(u8"$.store.books[?@.isbn && @.price > 20].title") == u8"D");
+    bTEST_ASSERT(titles(u8"$.store.books[?@.title == 'A' || @.title == \"C\"].title") == u8"AC");
+    bTEST_ASSERT(titles(u8"$.store.books[?!@.isbn].title") == u8"AC");
+
+    bTEST_ASSERT(JSONPath::compile(u8"$..price").select(document).size() == 5);
+    bTEST_ASSERT(JSONPath::compile(u8"$.store.missing").select_first(document) == nullptr);
+
+    // the evaluation stack can be reused between queries so repeated evaluation does not allocate
+    JSONPath::Stack stack{};
+    bTEST_ASSERT(JSONPath::compile(u8"$.store.*").evaluate(document, [](const JSONValue &) {}, stack) == 2);
+
+    // malformed expressions are rejected when compiled
+    bool threw{false};
+    try
+    {
+        JSONPath::compile(u8"store.books");
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    bTEST_ASSERT(threw);
+};
+
+/// @brief ensures that JSON Patches are applied in place and that a failing patch leaves the document untouched
+bTEST_FUNCTION(json_patch_applies_atomically, "json patch")
+{
+    using namespace ben::json;
+
+    JSONValue document{JSONValue::ObjectType{
+        {u8"name", u8"bJSON"},
+        {u8"tags", JSONValue::ArrayType{u8"a", u8"b"}},
+        {u8"meta", JSONValue::ObjectType{{u8"version", 1}}}
+    }};
+
+    const auto at = [&document](std::u8string_view pointer) { return JSONPointer::compile(pointer).resolve(document); };
+
+    // patches compiled from a JSON Patch document...
+    const JSONPatch compiled{JSONPatch::compile(JSONValue::ArrayType{
+        JSONValue::ObjectType{{u8"op", u8"add"}, {u8"path", u8"/tags/-"}, {u8"value", u8"c"}},
+        JSONValue::ObjectType{{u8"op", u8"replace"}, {u8"path", u8"/meta/version"}, {u8"value", 2}},
+        JSONValue::ObjectType{{u8"op", u8"move"}, {u8"from", u8"/name"}, {u8"path", u8"/meta/name"}},
+        JSONValue::ObjectType{{u8"op", u8"test"}, {u8"path", u8"/meta/name"}, {u8"value", u8"bJSON"}}})};
+    bTEST_ASSERT(compiled.apply(document));
+    bTEST_ASSERT(serialize(*at(u8"/tags")) == u8R"""([ "a", "b", "c" ])""");
+    bTEST_ASSERT(serialize(*at(u8"/meta/version")) == u8"2");
+    bTEST_ASSERT(serialize(*at(u8"/meta/name")) == u8R"""("bJSON")""");
+    bTEST_ASSERT(at(u8"/name") == nullptr);
+
+    // ...and patches built in code
+    bTEST_ASSERT(JSONPatch{}.remove(u8"/tags/0").copy(u8"/tags/0", u8"/tags/1").apply(document));
+    bTEST_ASSERT(serialize(*at(u8"/tags")) == u8R"""([ "b", "b", "c" ])""");
+
+    // a failing operation undoes everything which was applied before it
+    JSONValue before{document};
+    const JSONPatchResult failed{JSONPatch{}
+                                     .add(u8"/tags/0", u8"z")
+                                     .remove(u8"/meta")
+                                     .move(u8"/tags", u8"/moved")
+                                     .test(u8"/moved/0", u8"not z")
+                                     .apply(document)};
+    bTEST_ASSERT(!failed);
+    bTEST_ASSERT(failed.failed_operation == 3);
+    bTEST_ASSERT(serialize(document) == serialize(before));
+
+    bTEST_ASSERT(!JSONPatch{}.add(u8"/missing/child", 1).apply(document));
+    bTEST_ASSERT(!JSONPatch{}.move(u8"/meta", u8"/meta/inner").apply(document));
+    bTEST_ASSERT(serialize(document) == serialize(before));
+
+    // including moves onto an existing member or onto the whole document
+    bTEST_ASSERT(!JSONPatch{}.move(u8"/tags", u8"/meta").test(u8"/missing", 1).apply(document));
+    bTEST_ASSERT(document == before);
+    bTEST_ASSERT(!JSONPatch{}.move(u8"/tags", u8"").test(u8"/missing", 1).apply(document));
+    bTEST_ASSERT(document == before);
+
+    // patches convert back to their JSON Patch document representation
+    const std::u8string text{serialize(JSONPatch{}.remove(u8"/a~1b").to_json_value())};
+    bTEST_ASSERT(
+        text == u8R"""([ { "op" : "remove", "path" : "/a~1b" } ])""" ||
+        text == u8R"""([ { "path" : "/a~1b", "op" : "remove" } ])""");
+    bTEST_ASSERT(JSONPointer::compile(u8"/a~1b").get_tokens().front().key == u8"a/b");
+};
+
+/// @brief ensures that the patch generated by diffing two documents turns the first document into the second one, and
+/// that unchanged subtrees do not produce any operations
+bTEST_FUNCTION(json_diff_generates_equivalent_patch, "json patch")
+{
+    using namespace ben::json;
+
+    const JSONValue shared{JSONValue::ObjectType{{u8"street", u8"Main"}, {u8"number", 12}}};
+    const JSONValue from{JSONValue::ObjectType{
+        {u8"id", 1},
+        {u8"address", shared},
+        {u8"removed", true},
+        {u8"list", JSONValue::ArrayType{1, 2, 3, 4, 5, JSONValue::ObjectType{{u8"a", 1}}}}
+    }};
+    const JSONValue to{JSONValue::ObjectType{
+        {u8"id", 2},
+        {u8"address", shared},
+        {u8"a/b", u8"added"},
+        {u8"list", JSONValue::ArrayType{0, 1, 3, 4, 5, JSONValue::ObjectType{{u8"a", 2}}, 6}}
+    }};
+
+    const JSONPatch patch{diff(from, to)};
+
+    // nothing under the unchanged "address" subtree is touched
+    for (const auto &operation : patch.get_operations())
+    {
+        bTEST_ASSERT(operation.path.get_text().starts_with(u8"/address") == false);
+    }
+
+    JSONValue patched{from};
+    bTEST_ASSERT(patch.apply(patched));
+    bTEST_ASSERT(JSONPatch{}.test(u8"", to).apply(patched));
+
+    // the modified array element is diffed in place rather than replaced wholesale
+    bool nested{false};
+    for (const auto &operation : patch.get_operations())
+    {
+        nested = nested || operation.path.get_text() == u8"/list/5/a";
+    }
+    bTEST_ASSERT(nested);
+
+    // identical documents produce an empty patch
+    bTEST_ASSERT(diff(from, JSONValue{from}).get_operations().empty());
+
+    // subtrees with equal hashes are still compared, so a collision (simulated by a stale cached hash) hides no edit
+    JSONValue stale{JSONValue::ObjectType{{u8"a", JSONValue::ArrayType{2, 3}}}};
+    const JSONValue target{stale};
+    cache_hash(stale);
+    std::get<JSONValue::ArrayType>(std::get<JSONValue::ObjectType>(stale.value)[u8"a"].value)[0] = JSONValue{1};
+    JSONValue fixed{stale};
+    bTEST_ASSERT(diff(stale, target).apply(fixed) && fixed == target);
+};
+
+/// @brief ensures that structurally equal values hash and compare equal (regardless of member order and the sign of
+/// zero), that cached hashes are reused, and that patching a document invalidates the hashes it caches
+bTEST_FUNCTION(json_value_hash_and_equality, "json value")
+{
+    using namespace ben::json;
+
+    JSONValue a{JSONValue::ObjectType{{u8"x", 1}, {u8"y", JSONValue::ArrayType{true, u8"s", 0.0}}}};
+    JSONValue b{JSONValue::ObjectType{{u8"y", JSONValue::ArrayType{true, u8"s", -0.0}}, {u8"x", 1}}};
+    bTEST_ASSERT(a == b);
+    bTEST_ASSERT(hash(a) == hash(b));
+    bTEST_ASSERT(hash128(a) == hash128(b));
+    bTEST_ASSERT(!(JSONValue{true} == JSONValue{0}) && hash(JSONValue{true}) != hash(JSONValue{0}));
+    bTEST_ASSERT(!(JSONValue{JSONValue::ArrayType{1, 2}} == JSONValue{JSONValue::ArrayType{2, 1}}));
+
+    // streaming the bytes in pieces hashes the same as hashing them at once
+    JSONHasher hasher{};
+    hasher.update("structural ", 11);
+    hasher.update("hash", 4);
+    bTEST_ASSERT(hasher.finish() == JSONHasher::hash_bytes("structural hash", 15));
+
+    // hashes are stable: words are read as little endian whatever the byte order of the host
+    bTEST_ASSERT(JSONHasher::hash_bytes("a stable hash of 25 bytes", 25) == 0x6e51252f32670dd5ull);
+
+    // values can be used as keys of unordered containers
+    std::unordered_map<JSONValue, int> counts{};
+    ++counts[a];
+    ++counts[b];
+    ++counts[JSONValue{u8"other"}];
+    bTEST_ASSERT(counts.size() == 2 && counts[a] == 2);
+
+    // caching does not change the hash, and copies carry the cache along
+    const std::uint64_t h{hash(a)};
+    bTEST_ASSERT(cache_hash(a) == h && a.hash_cache == h);
+    JSONValue copy{a};
+    bTEST_ASSERT(copy.hash_cache == h && copy == a);
+
+    // patching invalidates the caches along the modified path, so the values no longer compare equal
+    bTEST_ASSERT(JSONPatch{}.replace(u8"/y/1", u8"t").apply(copy));
+    bTEST_ASSERT(copy.hash_cache == 0);
+    bTEST_ASSERT(!(copy == a) && cache_hash(copy) != h);
+    bTEST_ASSERT(JSONPatch{}.replace(u8"/y/1", u8"s").apply(copy));
+    bTEST_ASSERT(copy == a && hash(copy) == h);
+
+    // so does resolving a pointer for writing, while resolving a const document leaves the caches alone
+    cache_hash(copy);
+    bTEST_ASSERT(JSONPointer::compile(u8"/y").resolve(std::as_const(copy)) && copy.hash_cache == h);
+    *JSONPointer::compile(u8"/y/1").resolve(copy) = JSONValue{u8"t"};
+    bTEST_ASSERT(copy.hash_cache == 0 && !(copy == a));
+
+    // numbers which are not finite hash without undefined behavior (NaN only compares equal to the same JSONValue)
+    const auto infinity{std::numeric_limits<JSONValue::NumberType>::infinity()};
+    bTEST_ASSERT(hash(JSONValue{infinity}) == hash(JSONValue{infinity}));
+    bTEST_ASSERT(hash(JSONValue{infinity}) != hash(JSONValue{-infinity}));
+    const JSONValue nan{std::numeric_limits<JSONValue::NumberType>::quiet_NaN()};
+    bTEST_ASSERT(hash(nan) != hash(JSONValue{infinity}) && !(nan == JSONValue{nan}));
+};
+
+/// @brief ensures that deduplication shares repeated subtrees, reports the memory saved, serializes like the original
+/// document, and expands back into an equal document
+bTEST_FUNCTION(json_dedupe_shares_repeated_subtrees, "json value")
+{
+    using namespace ben::json;
+
+    const JSONValue address{JSONValue::ObjectType{{u8"street", u8"Main Street, Springfield"}}};
+    JSONValue::ArrayType people{};
+    for (int i = 0; i < 100; ++i)
+    {
+        people.push_back(JSONValue::ArrayType{i % 10, address, JSONValue::ArrayType{u8"tag", -0.0, true}});
+    }
+    const JSONValue document{std::move(people)};
+
+    const JSONSharedDocument shared{dedupe(document)};
+    const JSONDedupeReport  &report{shared.get_report()};
+    bTEST_ASSERT(report.nodes_before == 1 + 100 * 8);
+    bTEST_ASSERT(report.nodes_after < 40);
+    bTEST_ASSERT(report.bytes_after < report.bytes_before);
+
+    // the shared address block is a single node referenced by every record
+    const auto &nodes{shared.get_nodes()};
+    bTEST_ASSERT(std::count_if(
+                     nodes.begin(), nodes.end(),
+                     [](const auto &node) { return node.type == JSONValue::JSONValueType::object; }) == 1);
+
+    bTEST_ASSERT(serialize(shared) == serialize(document));
+    bTEST_ASSERT(shared.expand() == document);
+
+    // equal objects are shared regardless of member order
+    const JSONSharedDocument objects{dedupe(JSONValue{JSONValue::ArrayType{
+        JSONValue::ObjectType{{u8"a", 1}, {u8"b", 2}, {u8"c", 3}},
+        JSONValue::ObjectType{{u8"c", 3}, {u8"b", 2}, {u8"a", 1}}}})};
+    bTEST_ASSERT(objects.get_children()[0] == objects.get_children()[1]);
+    bTEST_ASSERT(serialize(objects) == u8R"""([ { "a" : 1, "b" : 2, "c" : 3 }, { "a" : 1, "b" : 2, "c" : 3 } ])""");
+};
+
+/// @brief ensures that compiled schemas accept valid documents and reject invalid ones, both when validating a
+/// JSONValue and when validating a stream of parse events
+bTEST_FUNCTION(json_schema_validates_documents, "json schema")
+{
+    using namespace ben::json;
+
+    const JSONSchema schema{JSONSchema::compile(JSONValue{JSONValue::ObjectType{
+        {u8"type", u8"object"},
+        {u8"required", JSONValue::ArrayType{u8"id", u8"name"}},
+        {u8"additionalProperties", false},
+        {u8"properties",
+         JSONValue::ObjectType{
+             {u8"id", JSONValue::ObjectType{{u8"type", u8"integer"}, {u8"minimum", 1}}},
+             {u8"name", JSONValue::ObjectType{{u8"type", u8"string"}, {u8"pattern", u8"^[A-Z]\\w*( \\w+)*$"}}},
+             {u8"tags",
+              JSONValue::ObjectType{
+                  {u8"type", u8"array"},
+                  {u8"maxItems", 2},
+                  {u8"items", JSONValue::ObjectType{{u8"enum", JSONValue::ArrayType{u8"a", u8"b"}}}}}},
+             {u8"origin",
+              JSONValue::ObjectType{
+                  {u8"enum", JSONValue::ArrayType{JSONValue::ArrayType{0, 0}, JSONValue::LiteralType::null_v}}}}}}}})};
+
+    const auto document = [](JSONValue::ObjectType members)
+    {
+        JSONValue::ObjectType object{{u8"id", 7}, {u8"name", u8"Bob Smith"}};
+        for (auto &[key, value] : members)
+        {
+            object[key] = std::move(value);
+        }
+        return JSONValue{std::move(object)};
+    };
+
+    bTEST_ASSERT(schema.validate(document({})));
+    bTEST_ASSERT(schema.validate(document({{u8"tags", JSONValue::ArrayType{u8"b", u8"a"}}})));
+    bTEST_ASSERT(schema.validate(document({{u8"origin", JSONValue::ArrayType{0, 0}}})));
+
+    bTEST_ASSERT(!schema.validate(JSONValue{JSONValue::ArrayType{}}));
+    bTEST_ASSERT(!schema.validate(document({{u8"id", 0}})));
+    bTEST_ASSERT(!schema.validate(document({{u8"id", 1.5}})));
+    bTEST_ASSERT(!schema.validate(document({{u8"name", u8"bob"}})));
+    bTEST_ASSERT(!schema.validate(document({{u8"tags", JSONValue::ArrayType{u8"a", u8"c"}}})));
+    bTEST_ASSERT(!schema.validate(document({{u8"tags", JSONValue::ArrayType{u8"a", u8"a", u8"a"}}})));
+    bTEST_ASSERT(!schema.validate(document({{u8"origin", JSONValue::ArrayType{0, 1}}})));
+    bTEST_ASSERT(!schema.validate(document({{u8"extra", true}})));
+    const JSONSchemaResult missing{schema.validate(JSONValue{JSONValue::ObjectType{{u8"id", 7}}})};
+    bTEST_ASSERT(!missing && std::string{missing.reason} == "a required property is missing");
+
+    // the same checks driven by parse events (structured enum values are captured and compared)
+    JSONSchema::Validator validator{schema};
+    const auto            stream = [&](JSONValue::NumberType x)
+    {
+        validator.reset();
+        validator.on_begin_object();
+        validator.on_key(u8"id");
+        validator.on_number(3);
+        validator.on_key(u8"name");
+        validator.on_string(u8"Ann");
+        validator.on_key(u8"origin");
+        validator.on_begin_array();
+        validator.on_number(x);
+        validator.on_number(0);
+        validator.on_end_array();
+        validator.on_end_object();
+        return validator.finish();
+    };
+    bTEST_ASSERT(stream(0));
+    bTEST_ASSERT(!stream(1));
+
+    validator.reset();
+    validator.on_begin_object();
+    validator.on_key(u8"id");
+    bTEST_ASSERT(!validator.finish());
+
+    // a repeated key does not count as a second required property
+    validator.reset();
+    validator.on_begin_object();
+    validator.on_key(u8"id");
+    validator.on_number(1);
+    validator.on_key(u8"id");
+    validator.on_number(2);
+    validator.on_end_object();
+    bTEST_ASSERT(!validator.finish());
+
+    const auto throws = [](const JSONValue &schema)
+    {
+        try
+        {
+            JSONSchema::compile(schema);
+        }
+        catch (const std::exception &)
+        {
+            return true;
+        }
+        return false;
+    };
+    bTEST_ASSERT(throws(JSONValue{JSONValue::ObjectType{{u8"pattern", u8"(unbalanced"}}}));
+
+    // unsupported keywords are rejected unless the schema is compiled leniently
+    const JSONValue any_of{JSONValue::ObjectType{
+        {u8"title", u8"strings"},
+        {u8"anyOf", JSONValue::ArrayType{JSONValue::ObjectType{{u8"type", u8"string"}}}}
+    }};
+    bTEST_ASSERT(throws(any_of));
+    bTEST_ASSERT(JSONSchema::compile(any_of, false).validate(JSONValue{5}));
+};
+
+/// @brief ensures that canonical serialization only depends on the logical value (sorted keys, normalized numbers,
+/// minimal escaping) and that the hashing sink matches hashing the materialized output
+bTEST_FUNCTION(canonical_serialization_is_deterministic, "canonical")
+{
+    using namespace ben::json;
+
+    JSONValue::ObjectType members{};
+    for (int i = 0; i < 64; ++i)
+    {
+        members.emplace(std::u8string(1, static_cast<char8_t>(u8'0' + (i * 37) % 64)), i);
+    }
+    JSONValue::ObjectType reversed{};
+    reversed.reserve(256);
+    for (const auto &[key, value] : members)
+    {
+        reversed.emplace(key, value);
+    }
+    bTEST_ASSERT(serialize_canonical(members) == serialize_canonical(reversed));
+    bTEST_ASSERT(canonical_hash(members) == canonical_hash(reversed));
+
+    const JSONValue document{JSONValue::ObjectType{
+        {u8"b", JSONValue::ArrayType{1e21, 1e20, 1.5e-7, 0.000001, -0.0, 100, 4.5, 333333333.33333329}},
+        {u8"a", u8"tab\tquote\"\x01é"},
+        {u8"\uFB01", JSONValue::LiteralType::null_v},
+        {u8"\U0001F600", true},
+        {u8"\r", false}}};
+    const std::u8string expected{
+        u8R"""({"\r":false,"a":"tab\tquote\"\u0001)""" u8"é"
+        u8R"""(","b":[1e+21,100000000000000000000,1.5e-7,0.000001,0,100,4.5,333333333.3333333],)"""
+        u8"\"\U0001F600\":true,\"\uFB01\":null}"}; // UTF-16 order puts U+1F600 (D83D DE00) before U+FB01
+    bTEST_ASSERT(serialize_canonical(document) == expected);
+    bTEST_ASSERT(canonical_hash(document) == JSONHasher::hash_bytes(expected.data(), expected.size()));
+
+    // NaN can not be written canonically
+    bTEST_ASSERT(serialize_canonical(JSONValue{std::numeric_limits<double>::quiet_NaN()}).empty());
+};
+
+/// @brief ensures that the compact and pretty output styles produce the expected whitespace and that the default
+/// output is unchanged
+bTEST_FUNCTION(output_styles_format_whitespace, "serialize options")
+{
+    using namespace ben::json;
+
+    const JSONValue document{JSONValue::ArrayType{
+        1, u8"a", JSONValue::ObjectType{{u8"k", JSONValue::LiteralType::null_v}}, JSONValue::ArrayType{}}};
+
+    bTEST_ASSERT(serialize(document) == u8R"""([ 1, "a", { "k" : null }, [ ] ])""");
+    bTEST_ASSERT(serialize(document, {.style = JSONOutputStyle::standard}) == serialize(document));
+    bTEST_ASSERT(serialize(document, {.style = JSONOutputStyle::compact}) == u8R"""([1,"a",{"k":null},[]])""");
+    bTEST_ASSERT(
+        serialize(document, {.style = JSONOutputStyle::pretty, .indent_width = 2}) ==
+        u8"[\n  1,\n  \"a\",\n  {\n    \"k\": null\n  },\n  []\n]");
+    bTEST_ASSERT(
+        serialize(document, {.style = JSONOutputStyle::pretty, .indent_width = 1, .crlf = true}) ==
+        u8"[\r\n 1,\r\n \"a\",\r\n {\r\n  \"k\": null\r\n },\r\n []\r\n]");
+
+    // nesting deeper than the precomputed indentation
+    JSONValue     nested{1};
+    std::u8string expected{u8"1"};
+    for (std::size_t depth = 20; depth-- > 0;)
+    {
+        nested   = JSONValue{JSONValue::ArrayType{std::move(nested)}};
+        expected = u8"[\n" + std::u8string((depth + 1) * 4, u8' ') + expected + u8"\n" +
+                   std::u8string(depth * 4, u8' ') + u8"]";
+    }
+    bTEST_ASSERT(serialize(nested, {.style = JSONOutputStyle::pretty}) == expected);
+
+    // undefined elements are skipped in every style
+    const JSONValue sparse{JSONValue::ArrayType{1, JSONValue{}, JSONValue::ArrayType{}}};
+    bTEST_ASSERT(serialize(sparse) == u8"[ 1, [ ] ]");
+    bTEST_ASSERT(serialize(sparse, {.style = JSONOutputStyle::compact}) == u8"[1,[]]");
+};
+
+/// @brief ensures that streaming minify/reformat match serializing the equivalent JSONValue, regardless of how the
+/// input is split into chunks, and that malformed input is rejected
+bTEST_FUNCTION(streaming_reformat_matches_serialization, "reformat")
+{
+    using namespace ben::json;
+
+    const std::u8string input{
+        u8" [ 1 , -2.5,\t\"a \\\"b\\\" é 😀\" ,\r\n{ \"k\" : [ true , false, null , [ ] , { } ] } ] \n"};
+    const JSONValue document{JSONValue::ArrayType{
+        1, -2.5, u8"a \"b\" é 😀",
+        JSONValue::ObjectType{{u8"k", JSONValue::ArrayType{true, false, JSONValue::LiteralType::null_v,
+                                                           JSONValue::ArrayType{}, JSONValue::ObjectType{}}}}}};
+
+    for (const auto style : {JSONOutputStyle::standard, JSONOutputStyle::compact, JSONOutputStyle::pretty})
+    {
+        const JSONSerializeOptions options{.style = style, .indent_width = 3};
+        const std::u8string        expected{serialize(document, options)};
+
+        std::u8string  whole{};
+        JSONStringSink whole_sink{whole};
+        reformat(input, whole_sink, options);
+        bTEST_ASSERT(whole == expected);
+
+        // feeding one unit at a time resumes every token across chunk boundaries
+        std::u8string                                     split{};
+        JSONStringSink                                    split_sink{split};
+        JSONReformatter<JSONPrettyFormat, JSONStringSink> reformatter{split_sink, JSONPrettyFormat{3}};
+        for (const char8_t unit : input)
+        {
+            reformatter.feed(std::u8string_view{&unit, 1});
+        }
+        reformatter.finish();
+        bTEST_ASSERT(split == serialize(document, {.style = JSONOutputStyle::pretty, .indent_width = 3}));
+    }
+
+    // numbers and escape sequences are copied verbatim
+    std::u8string  minified{};
+    JSONStringSink minified_sink{minified};
+    minify(u8"{ \"\\u00e9\" : -2.50E+03 }", minified_sink);
+    bTEST_ASSERT(minified == u8R"""({"\u00e9":-2.50E+03})""");
+
+    for (const std::u8string_view malformed : {u8"", u8"[1,]", u8"{\"a\" 1}", u8"01", u8"tru", u8"[1] x", u8"\"a\nb\"",
+                                               u8"[1}", u8"-", u8"1.e5", u8"\"\\x\"", u8"\"\xe2\xac\"",
+                                               u8"\"\xc0\xaf\"", u8"\"\xed\xa0\x80\"", u8"\"\xf4\x90\x80\x80\"",
+                                               u8"\"\xff\""})
+    {
+        bool           threw{false};
+        std::u8string  out{};
+        JSONStringSink sink{out};
+        try
+        {
+            minify(malformed, sink);
+        }
+        catch (const std::exception &)
+        {
+            threw = true;
+        }
+        bTEST_ASSERT(threw);
+    }
+};
+
+/// @brief ensures that JSON text is validated (grammar and UTF-8) without building values, in one piece or in chunks,
+/// and that failures report the offset of the first invalid unit
+bTEST_FUNCTION(validation_checks_grammar_and_utf8, "validation")
+{
+    using namespace ben::json;
+
+    const std::u8string valid{u8" {\"k\": [1, -0.5e+10, true, false, null, "
+                              u8"\"a long string with \\\"escapes\\\" \\u00e9 and é 😀\", {}, []]} "};
+    bTEST_ASSERT(validate(valid));
+
+    // chunks split tokens (and multi-byte UTF-8 sequences) anywhere
+    JSONValidator validator{};
+    for (const char8_t unit : valid)
+    {
+        validator.feed(std::u8string_view{&unit, 1});
+    }
+    bTEST_ASSERT(validator.finish());
+
+    const auto fails_at = [](std::u8string_view text, std::size_t offset)
+    {
+        const JSONValidationResult result{validate(text)};
+        return !result.valid && result.offset == offset;
+    };
+    bTEST_ASSERT(fails_at(u8"", 0));
+    bTEST_ASSERT(fails_at(u8"[1,]", 3));
+    bTEST_ASSERT(fails_at(u8"{\"a\" 1}", 5));
+    bTEST_ASSERT(fails_at(u8"[01]", 2));
+    bTEST_ASSERT(fails_at(u8"[1] [2]", 4));
+    bTEST_ASSERT(fails_at(u8"[\"tab\there\"]", 5));
+    bTEST_ASSERT(fails_at(u8"[1", 2));
+
+    // overlong encodings, surrogates, and truncated sequences are not valid UTF-8
+    const std::array<std::u8string, 3> invalid_utf8{
+        std::u8string{u8'"', char8_t{0xc0}, char8_t{0xaf}, u8'"'},
+        std::u8string{u8'"', char8_t{0xed}, char8_t{0xa0}, char8_t{0x80}, u8'"'},
+        std::u8string{u8'"', char8_t{0xe2}, char8_t{0x82}, u8'"'}};
+    bTEST_ASSERT(fails_at(invalid_utf8[0], 1));
+    bTEST_ASSERT(fails_at(invalid_utf8[1], 2));
+    bTEST_ASSERT(fails_at(invalid_utf8[2], 3));
+
+    // nesting is limited (the validator never allocates)
+    const std::u8string deep(JSONValidator::max_depth + 1, u8'[');
+    bTEST_ASSERT(fails_at(deep, JSONValidator::max_depth));
+};
+
+/// @brief ensures that strings are validated as UTF-8 while they are escaped: invalid strings are rejected by
+/// default, may be repaired with U+FFFD, or may be passed through when the caller trusts them
+bTEST_FUNCTION(strings_are_validated_as_utf8, "serialization")
+{
+    using namespace ben::json;
+
+    // long enough to span several scanning blocks, with a sequence straddling each block boundary
+    std::u8string valid{};
+    for (std::size_t i = 0; i < 40; ++i)
+    {
+        valid += u8"é\"😀\n";
+    }
+    std::u8string escaped{};
+    for (std::size_t i = 0; i < 40; ++i)
+    {
+        escaped += u8"é\\\"😀\\n";
+    }
+    bTEST_ASSERT(serialize(JSONValue{valid}) == u8"\"" + escaped + u8"\"");
+
+    // a truncated sequence in the middle of a long string, and overlong and surrogate encodings
+    std::u8string truncated{valid};
+    truncated.insert(truncated.begin() + 72, {char8_t{0xe2}, char8_t{0x82}});
+    const std::u8string overlong{u8'a', char8_t{0xc0}, char8_t{0xaf}, u8'b'};
+    const std::u8string surrogate{char8_t{0xed}, char8_t{0xa0}, char8_t{0x80}};
+
+    // rejected strings fail serialization (an empty result)
+    bTEST_ASSERT(serialize(JSONValue{truncated}).empty());
+    bTEST_ASSERT(serialize(JSONValue{overlong}).empty());
+    bTEST_ASSERT(serialize(JSONValue{surrogate}).empty());
+
+    // each maximal invalid subpart is replaced by a single U+FFFD
+    const JSONSerializeOptions replace{.utf8 = JSONUtf8Mode::replace};
+    bTEST_ASSERT(serialize(JSONValue{overlong}, replace) == u8"\"a��b\"");
+    bTEST_ASSERT(serialize(JSONValue{surrogate}, replace) == u8"\"���\"");
+    const std::u8string repaired{serialize(JSONValue{truncated}, replace)};
+    bTEST_ASSERT(repaired.size() == escaped.size() + 2 + 3);
+    bTEST_ASSERT(validate(repaired));
+
+    // trusted strings are escaped but otherwise written as they are
+    const std::u8string trusted{serialize(JSONValue{overlong}, {.utf8 = JSONUtf8Mode::trust})};
+    bTEST_ASSERT(trusted == u8"\"" + overlong + u8"\"");
+};
+
+/// @brief ensures that the ASCII-only mode escapes every character which is not ASCII as \uXXXX (with surrogate pairs
+/// past U+FFFF), in keys as well as values, and handles invalid UTF-8 like the default mode
+bTEST_FUNCTION(ascii_only_escapes_non_ascii, "serialization")
+{
+    using namespace ben::json;
+
+    const JSONSerializeOptions ascii{.style = JSONOutputStyle::compact, .ascii_only = true};
+
+    const JSONValue document{JSONValue::ArrayType{
+        JSONValue{u8"café \"€\" 😀\t"}, JSONValue{JSONValue::ObjectType{{u8"ключ", JSONValue{u8"\U0010FFFF"}}}}}};
+    bTEST_ASSERT(
+        serialize(document, ascii) ==
+        u8R"""(["caf\u00e9 \"\u20ac\" \ud83d\ude00\t",{"\u043a\u043b\u044e\u0447":"\udbff\udfff"}])""");
+
+    // long strings cross scanning blocks with sequences cut by the block boundaries
+    std::u8string text{};
+    std::u8string escaped{};
+    for (std::size_t i = 0; i < 50; ++i)
+    {
+        text += u8"abc日😀";
+        escaped += u8"abc\\u65e5\\ud83d\\ude00";
+    }
+    bTEST_ASSERT(serialize(JSONValue{text}, ascii) == u8"\"" + escaped + u8"\"");
+
+    // invalid sequences are rejected by default, or replaced (by an escaped U+FFFD)
+    const std::u8string invalid{u8'a', char8_t{0xe2}, char8_t{0x82}, u8'b'};
+    bTEST_ASSERT(serialize(JSONValue{invalid}, ascii).empty());
+    bTEST_ASSERT(
+        serialize(JSONValue{invalid}, {.utf8 = JSONUtf8Mode::replace, .ascii_only = true}) == u8"\"a\\ufffdb\"");
+};
+
+/// @brief ensures that char, UTF-16, UTF-32, and wide strings can be serialized directly and used to construct
+/// JSONValues (UTF-16/UTF-32 strings are transcoded to UTF-8, replacing unpaired surrogates with U+FFFD)
+bTEST_FUNCTION(other_string_types_are_transcoded, "serialization")
+{
+    using namespace ben::json;
+
+    // string literals are strings (rather than converting to bool)
+    bTEST_ASSERT(serialize("test") == u8"\"test\"");
+    bTEST_ASSERT(serialize(u"test") == u8"\"test\"");
+    bTEST_ASSERT(serialize(U"test") == u8"\"test\"");
+    bTEST_ASSERT(serialize(L"test") == u8"\"test\"");
+
+    const std::u8string expected{u8"\"café \\\"\U0001F600\\\" 日本\\n\""};
+    bTEST_ASSERT(serialize(std::string{"caf\xc3\xa9 \"\xf0\x9f\x98\x80\" \xe6\x97\xa5\xe6\x9c\xac\n"}) == expected);
+    bTEST_ASSERT(serialize(std::u16string_view{u"café \"\U0001F600\" 日本\n"}) == expected);
+    bTEST_ASSERT(serialize(std::u32string{U"café \"\U0001F600\" 日本\n"}) == expected);
+    bTEST_ASSERT(serialize(std::wstring{L"café \"\U0001F600\" 日本\n"}) == expected);
+
+    // long strings mix ASCII blocks (narrowed at once) with blocks which are transcoded code point by code point
+    std::u16string text{};
+    std::u8string  utf8{};
+    for (std::size_t i = 0; i < 20; ++i)
+    {
+        text += u"plain ASCII text, then \U0001F600!";
+        utf8 += u8"plain ASCII text, then \U0001F600!";
+    }
+    bTEST_ASSERT(JSONValue{std::u16string_view{text}} == JSONValue{utf8});
+    bTEST_ASSERT(serialize(text) == serialize(utf8));
+
+    // an unpaired surrogate can not be serialized (unless it is replaced), and is replaced in a JSONValue
+    const std::u16string unpaired{u'a', char16_t{0xd83d}, u'b'};
+    bTEST_ASSERT(serialize(unpaired).empty());
+    bTEST_ASSERT(JSONValue{std::u16string_view{unpaired}} == JSONValue{u8"a�b"});
+    bTEST_ASSERT(serialize(JSONValue{std::u16string_view{unpaired}}, {.ascii_only = true}) == u8"\"a\\ufffdb\"");
+};
+
+/// @brief ensures that values can be serialized directly into buffers of chars (std::string, std::vector<char>, and
+/// fixed size std::span<char>s), with the same output as serialize(...)
+bTEST_FUNCTION(serialization_into_char_buffers, "serialization")
+{
+    using namespace ben::json;
+
+    const JSONValue document{JSONValue::ArrayType{JSONValue{1}, JSONValue{u8"é\n"}, JSONValue{}, JSONValue{true}}};
+    const JSONSerializeOptions compact{.style = JSONOutputStyle::compact};
+    const std::u8string        expected{serialize(document, compact)};
+    const auto same = [&expected](const char *data, std::size_t size)
+    {
+        return std::u8string_view{expected} == std::u8string_view{reinterpret_cast<const char8_t *>(data), size};
+    };
+
+    // output is appended to what the buffers already hold
+    std::string text{"prefix:"};
+    bTEST_ASSERT(serialize_into(document, text, compact) == expected.size());
+    bTEST_ASSERT(text.starts_with("prefix:") && same(text.data() + 7, text.size() - 7));
+
+    std::vector<char> bytes{};
+    bTEST_ASSERT(serialize_into(document, bytes, compact) == expected.size());
+    bTEST_ASSERT(same(bytes.data(), bytes.size()));
+
+    const std::string        chars{serialize_chars(document)};
+    const std::u8string_view units{reinterpret_cast<const char8_t *>(chars.data()), chars.size()};
+    bTEST_ASSERT(units == serialize(document));
+
+    // fixed size buffers fail (returning 0) rather than overflowing
+    std::array<char, 64> buffer{};
+    const std::size_t    size{serialize_into(document, std::span<char>{buffer}, compact)};
+    bTEST_ASSERT(size == expected.size() && same(buffer.data(), size));
+    bTEST_ASSERT(serialize_into(document, std::span<char>{buffer.data(), expected.size() - 1}, compact) == 0);
+
+    // buffers are left as they were if a value can not be serialized
+    const JSONValue undefined{};
+    bTEST_ASSERT(serialize_into(undefined, text) == 0 && text.size() == 7 + expected.size());
+    bTEST_ASSERT(serialize_into(undefined, bytes) == 0 && bytes.size() == expected.size());
+};
+
+/// @brief ensures that integral numbers are written in full by the integer formatter (rather than in the shortest
+/// form, e.g. 1000000 rather than 1e+06), including at the boundaries of its digit counts
+bTEST_FUNCTION(integers_are_written_in_full, "serialization")
+{
+    using namespace ben::json;
+
+    bTEST_ASSERT(serialize(0) == u8"0");
+    bTEST_ASSERT(serialize(-7) == u8"-7");
+    bTEST_ASSERT(serialize(1000000) == u8"1000000");
+    bTEST_ASSERT(serialize(1'700'000'000'000ull) == u8"1700000000000");
+    bTEST_ASSERT(serialize(std::numeric_limits<std::int64_t>::min()) == u8"-9223372036854775808");
+    bTEST_ASSERT(serialize(0x1p63L) == u8"9223372036854775808");
+
+    // every digit count, on both sides of each power of ten
+    std::uint64_t power{1};
+    for (std::size_t digits = 1; digits < 20; ++digits, power *= 10)
+    {
+        const std::u8string nines(digits, u8'9');
+        std::u8string       one_zeros(digits, u8'0');
+        one_zeros[0] = u8'1';
+        bTEST_ASSERT(serialize(power) == one_zeros);
+        bTEST_ASSERT(serialize(power * 10 - 1) == nines);
+    }
+
+    // numbers which are not integers (or are too large) keep their shortest form
+    bTEST_ASSERT(serialize(0.5) == u8"0.5");
+    bTEST_ASSERT(serialize(1e300L) == u8"1e+300");
+    bTEST_ASSERT(serialize(JSONValue::ArrayType{JSONValue{20}, JSONValue{-1.25}}) == u8"[ 20, -1.25 ]");
+};
+
+/// @brief ensures that numbers which are doubles are written in the shortest form of the double (not of the wider
+/// long double), and that NaN and infinity are rejected or written as null, as requested
+bTEST_FUNCTION(doubles_are_shortest_and_non_finite_is_handled, "serialization")
+{
+    using namespace ben::json;
+
+    bTEST_ASSERT(serialize(JSONValue{3.14}) == u8"3.14");
+    bTEST_ASSERT(serialize(JSONValue{0.1}) == u8"0.1");
+    bTEST_ASSERT(serialize(JSONValue{-2.5e-300}) == u8"-2.5e-300");
+    bTEST_ASSERT(serialize(JSONValue{1e300}) == u8"1e+300");
+    bTEST_ASSERT(serialize(JSONValue{333333333.3333333}) == u8"333333333.3333333");
+
+    // numbers round-trip through the text
+    for (const double number : {0.1, 1.0 / 3.0, 6.02214076e23, 5e-324, std::numeric_limits<double>::max()})
+    {
+        const std::u8string text{serialize(JSONValue{number})};
+        const std::string   chars{text.begin(), text.end()};
+        double              parsed{0};
+        std::from_chars(chars.data(), chars.data() + chars.size(), parsed);
+        bTEST_ASSERT(parsed == number);
+    }
+
+    const JSONValue document{JSONValue::ArrayType{
+        JSONValue{1}, JSONValue{std::numeric_limits<double>::quiet_NaN()},
+        JSONValue{-std::numeric_limits<double>::infinity()}}};
+    bTEST_ASSERT(serialize(document).empty());
+    bTEST_ASSERT(serialize(document, {.style = JSONOutputStyle::compact}).empty());
+    bTEST_ASSERT(
+        serialize(document, {.style = JSONOutputStyle::compact, .non_finite = JSONNonFiniteMode::null}) ==
+        u8"[1,null,null]");
+    bTEST_ASSERT(serialize(document, {.style = JSONOutputStyle::canonical}).empty());
+};
+
+/// @brief ensures numbers which are not integers are rounded to the requested precision (per call, per field, and for
+/// packed arrays), while integers are still written in full
+bTEST_FUNCTION(numbers_are_rounded_to_a_precision, "serialization")
+{
+    using namespace ben::json;
+
+    const JSONSerializeOptions significant{.precision = {JSONRounding::significant, 4}};
+    bTEST_ASSERT(serialize(JSONValue{3.14159265}, significant) == u8"3.142");
+    bTEST_ASSERT(serialize(JSONValue{-0.000123456}, significant) == u8"-0.0001235");
+    bTEST_ASSERT(serialize(JSONValue{2.5}, significant) == u8"2.5");
+    bTEST_ASSERT(serialize(JSONValue{9.99996}, significant) == u8"10");
+    bTEST_ASSERT(serialize(JSONValue{123456.7}, significant) == u8"1.235e+05");
+    bTEST_ASSERT(serialize(JSONValue{1234567}, significant) == u8"1234567");
+
+    const JSONSerializeOptions decimals{.style = JSONOutputStyle::compact, .precision = {JSONRounding::decimals, 2}};
+    bTEST_ASSERT(serialize(JSONValue{3.14159265}, decimals) == u8"3.14");
+    bTEST_ASSERT(serialize(JSONValue{0.5}, decimals) == u8"0.50");
+    bTEST_ASSERT(serialize(JSONValue{-0.001}, decimals) == u8"-0.00");
+    bTEST_ASSERT(serialize(JSONValue{0.125}, decimals) == u8"0.12");
+    bTEST_ASSERT(serialize(JSONValue{1.005}, decimals) == u8"1.00");
+    const JSONValue array{JSONValue::ArrayType{JSONValue{1.0 / 3.0}, JSONValue{7}}};
+    bTEST_ASSERT(serialize(array, decimals) == u8"[0.33,7]");
+
+    // the canonical form is never rounded
+    const JSONSerializeOptions canonical{.style = JSONOutputStyle::canonical, .precision = {JSONRounding::decimals, 2}};
+    bTEST_ASSERT(serialize(JSONValue{0.1}, canonical) == u8"0.1");
+
+    // rounded to the same digits as std::to_chars
+    for (const double number : {0.1, 2.675, 1.0 / 3.0, 123.456789, -98765.4321, 5e-7, 1e-300})
+    {
+        for (int digits = 0; digits < 12; ++digits)
+        {
+            std::array<char, 512>      expected{};
+            const std::to_chars_result res{std::to_chars(
+                expected.data(), expected.data() + expected.size(), number, std::chars_format::fixed, digits)};
+            const JSONSerializeOptions options{.precision = {JSONRounding::decimals, digits}};
+            const std::u8string        text{serialize(JSONValue{number}, options)};
+            bTEST_ASSERT(std::string(text.begin(), text.end()) == std::string(expected.data(), res.ptr));
+        }
+    }
+
+    bTEST_ASSERT(serialize(JSONRoundedNumber{2.0 / 3.0, {JSONRounding::significant, 3}}) == u8"0.667");
+    bTEST_ASSERT(serialize(JSONRoundedNumber{2.0 / 3.0}) == u8"0.6666666666666666");
+
+    const std::vector<float> floats{0.1f, -2.5f, 1000000.0f, 3.14159f};
+    bTEST_ASSERT(serialize_numbers(std::span<const float>{floats}) == u8"[ 0.1, -2.5, 1000000, 3.14159 ]");
+    bTEST_ASSERT(serialize_numbers(std::span<const float>{floats}, decimals) == u8"[0.10,-2.50,1000000,3.14]");
+
+    const std::vector<int> integers{1, -2, 3};
+    bTEST_ASSERT(
+        serialize_numbers(std::span<const int>{integers}, {.style = JSONOutputStyle::pretty}) ==
+        u8"[\n    1,\n    -2,\n    3\n]");
+};
+
+/// @brief ensures runs of numbers (in arrays and packed spans) are written exactly like single numbers, including
+/// across the blocks they are formatted into
+bTEST_FUNCTION(number_runs_are_written_in_blocks, "serialization")
+{
+    using namespace ben::json;
+
+    // a run of numbers between other elements (and undefined elements, which are skipped)
+    const JSONValue mixed{JSONValue::ArrayType{
+        JSONValue{u8"a"}, JSONValue{1}, JSONValue{-2.5}, JSONValue{}, JSONValue{1700000000123}, JSONValue{true},
+        JSONValue{0.1}, JSONValue{7}}};
+    bTEST_ASSERT(serialize(mixed) == u8R"""([ "a", 1, -2.5, 1700000000123, true, 0.1, 7 ])""");
+    bTEST_ASSERT(
+        serialize(mixed, {.style = JSONOutputStyle::pretty, .indent_width = 1}) ==
+        u8"[\n \"a\",\n 1,\n -2.5,\n 1700000000123,\n true,\n 0.1,\n 7\n]");
+    bTEST_ASSERT(
+        serialize(mixed, {.style = JSONOutputStyle::canonical}) == u8R"""(["a",1,-2.5,1700000000123,true,0.1,7])""");
+
+    // long runs span several blocks
+    JSONValue::ArrayType      numbers{};
+    std::vector<std::int64_t> integers{};
+    std::u8string             expected{u8"["};
+    for (std::int64_t i = 0; i < 5000; ++i)
+    {
+        const std::int64_t integer{(i % 2 == 0 ? -1 : 1) * i * 1'000'000'007};
+        numbers.emplace_back(static_cast<JSONValue::NumberType>(integer));
+        integers.push_back(integer);
+        expected.append(i == 0 ? u8"" : u8",").append(serialize(JSONValue{integer}));
+    }
+    expected.append(u8"]");
+    bTEST_ASSERT(serialize(JSONValue{numbers}, {.style = JSONOutputStyle::compact}) == expected);
+    const std::span<const std::int64_t> packed{integers};
+    bTEST_ASSERT(serialize_numbers(packed, {.style = JSONOutputStyle::compact}) == expected);
+
+    const std::vector<std::int64_t> limits{
+        std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(), 0, 123456789};
+    bTEST_ASSERT(
+        serialize_numbers(std::span<const std::int64_t>{limits}) ==
+        u8"[ -9223372036854775808, 9223372036854775807, 0, 123456789 ]");
+    const std::vector<std::uint64_t> unsigned_limits{
+        std::numeric_limits<std::uint64_t>::max(), 10'000'000'000'000'000ull};
+    bTEST_ASSERT(
+        serialize_numbers(std::span<const std::uint64_t>{unsigned_limits}) ==
+        u8"[ 18446744073709551615, 10000000000000000 ]");
+
+    const std::vector<double> doubles{0.1, -1e300, 42.0, 1.0 / 3.0, std::numeric_limits<double>::infinity()};
+    bTEST_ASSERT(serialize_numbers(std::span<const double>{doubles}).empty());
+    bTEST_ASSERT(
+        serialize_numbers(std::span<const double>{doubles}, {.non_finite = JSONNonFiniteMode::null}) ==
+        u8"[ 0.1, -1e+300, 42, 0.3333333333333333, null ]");
+
+    // a run which does not fit in a fixed size buffer is still rejected
+    std::array<char, 16> buffer{};
+    bTEST_ASSERT(serialize_into(JSONValue{numbers}, std::span<char>{buffer}) == 0);
+};
+
+/// @brief ensures raw numbers are written exactly as their text and only parsed when their value is asked for
+bTEST_FUNCTION(raw_numbers_keep_their_text, "serialization")
+{
+    using namespace ben::json;
+
+    bTEST_ASSERT(is_json_serializable_v<JSONRawNumber>);
+    bTEST_ASSERT(serialize(JSONRawNumber{u8"1.10"}) == u8"1.10");
+    bTEST_ASSERT(serialize(JSONRawNumber{u8"-0"}) == u8"-0");
+    bTEST_ASSERT(serialize(JSONRawNumber{u8"2.5E+10"}) == u8"2.5E+10");
+    bTEST_ASSERT(
+        serialize(JSONRawNumber{u8"340282366920938463463374607431768211457"}) ==
+        u8"340282366920938463463374607431768211457");
+
+    const JSONRawNumber price{u8"19.990"};
+    bTEST_ASSERT(price.value() == 19.99L);
+    bTEST_ASSERT(price.text() == u8"19.990");
+
+    const JSONRawNumber formatted{JSONValue::NumberType{1000000}};
+    bTEST_ASSERT(formatted.text() == u8"1000000");
+    bTEST_ASSERT(formatted.value() == 1000000);
+
+    // the text must be a JSON number
+    for (const std::u8string_view text : {u8"", u8"01", u8"1.", u8".5", u8"+1", u8"1e", u8"NaN", u8" 1", u8"0x10"})
+    {
+        bool threw{false};
+        try
+        {
+            const JSONRawNumber number{text};
+        }
+        catch (...)
+        {
+            threw = true;
+        }
+        bTEST_ASSERT(threw && !JSONRawNumber::valid(text));
+    }
+
+    // a value out of range is only an error when it is asked for
+    const JSONRawNumber huge{u8"1e999999"};
+    bTEST_ASSERT(serialize(huge) == u8"1e999999");
+    bool threw{false};
+    try
+    {
+        static_cast<void>(huge.value());
+    }
+    catch (...)
+    {
+        threw = true;
+    }
+    bTEST_ASSERT(threw);
+};
+
+/// @brief ensures raw numbers hold integers and decimals exactly, convert back to integers exactly, and compare by
+/// value
+bTEST_FUNCTION(raw_numbers_are_exact, "serialization")
+{
+    using namespace ben::json;
+
+    bTEST_ASSERT(serialize(JSONRawNumber{std::numeric_limits<std::uint64_t>::max()}) == u8"18446744073709551615");
+    bTEST_ASSERT(serialize(JSONRawNumber{std::numeric_limits<std::int64_t>::min()}) == u8"-9223372036854775808");
+    bTEST_ASSERT(serialize(JSONRawNumber::decimal(-12345, 2)) == u8"-123.45");
+    bTEST_ASSERT(serialize(JSONRawNumber::decimal(5, 3)) == u8"0.005");
+    bTEST_ASSERT(serialize(JSONRawNumber::decimal(0, 2)) == u8"0.00");
+
+#if defined(__SIZEOF_INT128__)
+    // 128-bit integers are raw numbers wherever the standard library treats them as integers (e.g. -std=gnu++20)
+    const auto wide = [&](auto one)
+    {
+        if constexpr (std::is_integral_v<decltype(one)>)
+        {
+            const decltype(one) big{one << 100};
+            bTEST_ASSERT(serialize(JSONRawNumber{big}) == u8"1267650600228229401496703205376");
+            bTEST_ASSERT(serialize(JSONRawNumber{-big - 7}) == u8"-1267650600228229401496703205383");
+            bTEST_ASSERT(serialize(JSONRawNumber::decimal(big, 2)) == u8"12676506002282294014967032053.76");
+            bTEST_ASSERT(serialize(JSONRawNumber{one * 10'000'000'000'000'000'000ull}) == u8"10000000000000000000");
+        }
+    };
+    wide(static_cast<__int128>(1));
+#endif
+
+    std::uint64_t id{0};
+    bTEST_ASSERT(JSONRawNumber{u8"18446744073709551615"}.to_integer(id));
+    bTEST_ASSERT(id == std::numeric_limits<std::uint64_t>::max());
+    bTEST_ASSERT(JSONRawNumber{u8"1.5e3"}.to_integer(id) && id == 1500);
+    bTEST_ASSERT(!JSONRawNumber{u8"18446744073709551616"}.to_integer(id));
+    bTEST_ASSERT(!JSONRawNumber{u8"-1"}.to_integer(id));
+    bTEST_ASSERT(!JSONRawNumber{u8"2.5"}.to_integer(id));
+
+    std::int64_t cents{0};
+    bTEST_ASSERT(JSONRawNumber{u8"-123.45"}.to_integer(cents, 2) && cents == -12345);
+    bTEST_ASSERT(JSONRawNumber{u8"0.1"}.to_integer(cents, 2) && cents == 10);
+    bTEST_ASSERT(!JSONRawNumber{u8"0.125"}.to_integer(cents, 2));
+
+    // compared by value, exactly
+    bTEST_ASSERT(JSONRawNumber{u8"1.10"} == JSONRawNumber{u8"1.1"});
+    bTEST_ASSERT(JSONRawNumber{u8"1e2"} == JSONRawNumber{u8"100"});
+    bTEST_ASSERT(JSONRawNumber{u8"-0"} == JSONRawNumber{u8"0.0"});
+    bTEST_ASSERT(JSONRawNumber{u8"9007199254740993"} < JSONRawNumber{u8"9007199254740994"});
+    bTEST_ASSERT(JSONRawNumber{u8"-5"} < JSONRawNumber{u8"-4.99"});
+    bTEST_ASSERT(JSONRawNumber{u8"99"} < JSONRawNumber{u8"100"});
+    bTEST_ASSERT(JSONRawNumber{u8"0.001"} < JSONRawNumber{u8"1E-2"});
+    bTEST_ASSERT(!(JSONRawNumber{u8"1e999999"} < JSONRawNumber{u8"1e999998"}));
+};
+
+/// @brief ensures time points and durations are written as ISO-8601 (or epoch numbers) and parsed back
+bTEST_FUNCTION(time_points_and_durations_are_serializable, "serialization")
+{
+    using namespace ben::json;
+    using namespace std::chrono;
+
+    // 2024-02-29T13:45:30.250Z
+    const sys_time<milliseconds> leap_day{
+        sys_days{year{2024} / 2 / 29} + hours{13} + minutes{45} + milliseconds{30'250}};
+    bTEST_ASSERT(is_json_serializable_v<sys_time<milliseconds>>);
+    bTEST_ASSERT(serialize(leap_day) == u8"\"2024-02-29T13:45:30.250Z\"");
+    bTEST_ASSERT(serialize(floor<seconds>(leap_day)) == u8"\"2024-02-29T13:45:30Z\"");
+    bTEST_ASSERT(serialize(sys_time<microseconds>{leap_day}) == u8"\"2024-02-29T13:45:30.250000Z\"");
+    bTEST_ASSERT(serialize(sys_seconds{seconds{-1}}) == u8"\"1969-12-31T23:59:59Z\"");
+    bTEST_ASSERT(serialize(sys_days{year{10000} / 1 / 1}).empty());
+
+    // the extremes of the durations are out of range (or written exactly) without overflowing
+    bTEST_ASSERT(serialize(sys_seconds{seconds::min()}).empty());
+    bTEST_ASSERT(serialize(sys_seconds{seconds::max()}).empty());
+    bTEST_ASSERT(serialize(sys_time<nanoseconds>{nanoseconds::min()}) == u8"\"1677-09-21T00:12:43.145224192Z\"");
+
+    bTEST_ASSERT(serialize(JSONTimestamp{leap_day, JSONTimeStyle::iso8601, 1}) == u8"\"2024-02-29T13:45:30.2Z\"");
+    bTEST_ASSERT(serialize(JSONTimestamp{leap_day, JSONTimeStyle::epoch_seconds}) == u8"1709214330");
+    bTEST_ASSERT(serialize(JSONTimestamp{leap_day, JSONTimeStyle::epoch_milliseconds}) == u8"1709214330250");
+    bTEST_ASSERT(
+        serialize(JSONTimestamp{sys_seconds{seconds{-1}}, JSONTimeStyle::epoch_nanoseconds}) == u8"-1000000000");
+
+    bTEST_ASSERT(serialize(milliseconds{1'500}) == u8"\"PT1.500S\"");
+    bTEST_ASSERT(serialize(minutes{-2}) == u8"\"-PT120S\"");
+    bTEST_ASSERT(serialize(nanoseconds{7}) == u8"\"PT0.000000007S\"");
+    bTEST_ASSERT(serialize(nanoseconds::min()) == u8"\"-PT9223372036.854775808S\"");
+    bTEST_ASSERT(serialize(seconds::min()) == u8"\"-PT9223372036854775808S\"");
+
+    // parsing
+    sys_time<milliseconds> parsed{};
+    bTEST_ASSERT(parse_timestamp(u8"2024-02-29T13:45:30.250Z", parsed) && parsed == leap_day);
+    bTEST_ASSERT(parse_timestamp(u8"2024-02-29T19:15:30.2509+05:30", parsed) && parsed == leap_day);
+    bTEST_ASSERT(parse_timestamp(u8"2024-02-29t13:45:30.25z", parsed) && parsed == leap_day);
+    for (const std::u8string_view text :
+         {u8"2023-02-29T00:00:00Z", u8"2024-13-01T00:00:00Z", u8"2024-01-01T24:00:00Z", u8"2024-01-01T00:00:00",
+          u8"2024-01-01T00:00:00.Z", u8"2024-01-01T00:00:00+0530", u8"2024-1-01T00:00:00Z"})
+    {
+        bTEST_ASSERT(!parse_timestamp(text, parsed));
+    }
+
+    milliseconds duration{};
+    bTEST_ASSERT(parse_duration(u8"PT1.500S", duration) && duration == milliseconds{1'500});
+    bTEST_ASSERT(parse_duration(u8"-PT120S", duration) && duration == minutes{-2});
+    bTEST_ASSERT(!parse_duration(u8"PT1M", duration));
+};
+
+/// @brief ensures blobs are written as base64 strings and decoded back (through the vectorized kernels for long data)
+bTEST_FUNCTION(blobs_are_base64_encoded, "serialization")
+{
+    using namespace ben::json;
+
+    // the RFC 4648 test vectors
+    bTEST_ASSERT(serialize(JSONBlob{std::string{""}}) == u8"\"\"");
+    bTEST_ASSERT(serialize(JSONBlob{std::string{"f"}}) == u8"\"Zg==\"");
+    bTEST_ASSERT(serialize(JSONBlob{std::string{"fo"}}) == u8"\"Zm8=\"");
+    bTEST_ASSERT(serialize(JSONBlob{std::string{"foo"}}) == u8"\"Zm9v\"");
+    bTEST_ASSERT(serialize(JSONBlob{std::string{"foobar"}}) == u8"\"Zm9vYmFy\"");
+
+    std::vector<std::uint8_t> bytes(1'000);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::uint8_t>(i * 167 + (i >> 3));
+    }
+    const std::u8string serialized{serialize(JSONBlob{bytes})};
+    bTEST_ASSERT(serialized.size() == JSONBase64::encoded_size(bytes.size()) + 2);
+    bTEST_ASSERT(serialized.substr(1, 8) == u8"AKdO9ZxD");
+
+    // decoding
+    const std::u8string_view  text{serialized.data() + 1, serialized.size() - 2};
+    std::vector<std::uint8_t> decoded{};
+    bTEST_ASSERT(decode_base64(text, decoded) && decoded == bytes);
+
+    std::string string{"unchanged"};
+    bTEST_ASSERT(decode_base64(u8"Zm9vYg==", string) && string == "foob");
+    bTEST_ASSERT(!decode_base64(u8"Zm9vYg=", string) && string == "foob");
+    bTEST_ASSERT(!decode_base64(u8"Zm9vYh==", string));
+    bTEST_ASSERT(!decode_base64(u8"Zm9=Yg==", string));
+
+    // a character outside of the alphabet, deep inside long text
+    std::u8string corrupted{text};
+    corrupted[500] = u8'-';
+    bTEST_ASSERT(!decode_base64(corrupted, decoded) && decoded == bytes);
+};
+
+/// @brief ensures registered enums are written as their names and read back through the perfect hash
+bTEST_FUNCTION(enums_are_serialized_by_name, "serialization")
+{
+    using namespace ben::json;
+
+    bTEST_ASSERT(is_json_serializable_v<Color>);
+    bTEST_ASSERT(serialize(Color::red) == u8"\"red\"");
+    bTEST_ASSERT(serialize(Color::blue) == u8"\"blue\"");
+    bTEST_ASSERT(serialize(Status::failed) == u8"\"failed\"");
+    bTEST_ASSERT(serialize(Status::done) == u8"\"done\"");
+    bTEST_ASSERT(serialize(static_cast<Color>(3)).empty());
+    bTEST_ASSERT(serialize(static_cast<Status>(15)).empty());
+    bTEST_ASSERT(JSONEnumTable<Status>::quoted(Status::pending) == u8"\"pending\"");
+
+    Color color{Color::red};
+    bTEST_ASSERT(parse_enum(u8"green", color) && color == Color::green);
+    bTEST_ASSERT(!parse_enum(u8"Green", color) && color == Color::green);
+    bTEST_ASSERT(!parse_enum(u8"gree", color));
+    bTEST_ASSERT(!parse_enum(u8"", color));
+
+    Status status{Status::failed};
+    bTEST_ASSERT(parse_enum(u8"pending", status) && status == Status::pending);
+    bTEST_ASSERT(!parse_enum(u8"\"done\"", status) && status == Status::pending);
+};
+
+/// @brief ensures registered aggregates are written as objects of their members (in the default format)
+bTEST_FUNCTION(aggregates_are_serialized_by_member, "serialization")
+{
+    using namespace ben::json;
+
+    bTEST_ASSERT(is_json_aggregate_v<Point>);
+    bTEST_ASSERT(!is_json_aggregate_v<Example>);
+    bTEST_ASSERT(JSONAggregateBuilder::member_count<Shape>() == 6);
+
+    const Point point{-3, 0.5, u8"a \"quoted\" label"};
+    bTEST_ASSERT(serialize(point) == u8R"({ "x" : -3, "y" : 0.5, "label" : "a \"quoted\" label" })");
+
+    // nested aggregates, enums, floats, std::strings, and durations
+    const Shape shape{{1, 2, u8"origin"}, Color::blue, true, 0.1f, "square", std::chrono::milliseconds{250}};
+    bTEST_ASSERT(
+        serialize(shape) ==
+        u8R"({ "origin" : { "x" : 1, "y" : 2, "label" : "origin" }, "color" : "blue", "filled" : true, )"
+        u8R"("scale" : 0.1, "name" : "square", "lifetime" : "PT0.250S" })");
+
+    // nothing at all if a member can not be serialized
+    const Shape unnamed{{}, static_cast<Color>(7)};
+    bTEST_ASSERT(serialize(unnamed).empty());
+};
+
+/// @brief ensures the pull reader reads typed values (as the generated deserializers do) and rejects malformed text
+bTEST_FUNCTION(pull_reader_reads_typed_values, "parsing")
+{
+    using namespace ben::json;
+
+    JSONPullReader reader{
+        u8R"( { "id" : 42, "name" : "tab\there 😀", "skipped" : [1, {"a" : [true, null]}, "x"],
+                "color" : "blue", "ratio" : -2.5e-1, "data" : "Zm9v", "note" : null, "tags" : ["a", "b"] } )"};
+    std::uint32_t             id{0};
+    std::u8string             name{};
+    Color                     color{Color::red};
+    double                    ratio{0};
+    std::vector<std::uint8_t> data{};
+    bool                      note_is_null{false};
+    std::vector<std::string>  tags{};
+
+    reader.begin_object();
+    while (reader.next_member())
+    {
+        const std::u8string_view key{reader.key()};
+        if (key == u8"id")
+        {
+            reader.read(id);
+        }
+        else if (key == u8"name")
+        {
+            reader.read(name);
+        }
+        else if (key == u8"color")
+        {
+            reader.read(color);
+        }
+        else if (key == u8"ratio")
+        {
+            reader.read(ratio);
+        }
+        else if (key == u8"data")
+        {
+            reader.read(data);
+        }
+        else if (key == u8"note")
+        {
+            note_is_null = reader.read_null();
+        }
+        else if (key == u8"tags")
+        {
+            reader.begin_array();
+            while (reader.next_element())
+            {
+                reader.read(tags.emplace_back());
+            }
+        }
+        else
+        {
+            reader.skip();
+        }
+    }
+    reader.finish();
+
+    const std::vector<std::string> expected_tags{"a", "b"};
+    bTEST_ASSERT(id == 42 && color == Color::blue && ratio == -0.25 && note_is_null);
+    bTEST_ASSERT(name == u8"tab\there \U0001F600");
+    bTEST_ASSERT(data.size() == 3 && data[0] == 'f');
+    bTEST_ASSERT(tags == expected_tags);
+
+    // malformed text, and values of the wrong type
+    const auto fails{[](std::u8string_view text) {
+        try
+        {
+            JSONPullReader malformed{text};
+            malformed.begin_object();
+            while (malformed.next_member())
+            {
+                std::uint8_t small{0};
+                malformed.read(small);
+            }
+            malformed.finish();
+        }
+        catch (const std::exception &)
+        {
+            return true;
+        }
+        return false;
+    }};
+    bTEST_ASSERT(!fails(u8R"({ "a" : 1, "b" : 255 })"));
+    bTEST_ASSERT(fails(u8R"({ "a" : 1 "b" : 2 })"));
+    bTEST_ASSERT(fails(u8R"({ "a" : 1, })"));
+    bTEST_ASSERT(fails(u8R"({ "a" : 256 })"));
+    bTEST_ASSERT(fails(u8R"({ "a" : 1.5 })"));
+    bTEST_ASSERT(fails(u8R"({ "a" : 01 })"));
+    bTEST_ASSERT(fails(u8R"({ "a" : "1" })"));
+    bTEST_ASSERT(fails(u8R"({ "a" : 1 } trailing)"));
+
+    // failures name the expected type
+    const auto message{[](std::u8string_view text, auto value) {
+        try
+        {
+            JSONPullReader single{text};
+            single.read(value);
+        }
+        catch (const std::exception &error)
+        {
+            return std::string{error.what()};
+        }
+        return std::string{};
+    }};
+    bTEST_ASSERT(message(u8"1.5", int{0}).find("expected an integer") != std::string::npos);
+    bTEST_ASSERT(message(u8"1e999", double{0}).find("out of range") != std::string::npos);
+};
+
+/// @brief ensures the code bjsongen generates (see tests/bjsongen/catalog.idl) writes the expected JSON and reads it
+/// back: enums, nested structs, optionals, bytes, and lists (including lists of bools and lists of lists)
+bTEST_FUNCTION(generated_code_round_trips, "parsing")
+{
+    using namespace catalog;
+
+    const Product product{
+        .id    = 18'446'744'073'709'551'615ull,
+        .name  = u8"desk \"oak\"",
+        .price = 249.5,
+        .tags  = {u8"office", u8"wood"},
+        .variants =
+            {Variant{
+                 .sku = u8"D-1", .size = Size::large, .dimensions = Dimensions{120, 75.5}, .flags = {true, false}},
+             Variant{.sku = u8"D-2", .size = Size::small}},
+        .sizes     = std::vector<Size>{Size::small, Size::large},
+        .matrix    = {{1, -2}, {}},
+        .thumbnail = {0xde, 0xad, 0xbe, 0xef},
+        .active    = true};
+
+    std::u8string text{};
+    write_json(text, product);
+    bTEST_ASSERT(
+        text == u8R"""({ "id" : 18446744073709551615, "name" : "desk \"oak\"", "price" : 249.5, )"""
+                u8R"""("tags" : [ "office", "wood" ], "variants" : [ { "sku" : "D-1", "size" : "large", )"""
+                u8R"""("dimensions" : { "width" : 120, "height" : 75.5 }, "flags" : [ true, false ] }, )"""
+                u8R"""({ "sku" : "D-2", "size" : "small", "dimensions" : null, "flags" : [ ] } ], )"""
+                u8R"""("sizes" : [ "small", "large" ], "matrix" : [ [ 1, -2 ], [ ] ], "thumbnail" : "3q2+7w==", )"""
+                u8R"""("active" : true })""");
+    bTEST_ASSERT(ben::json::serialize(product) == text);
+
+    Product back{};
+    parse_json(text, back);
+    std::u8string again{};
+    write_json(again, back);
+    bTEST_ASSERT(again == text);
+    const std::vector<bool> flags{true, false};
+    bTEST_ASSERT(back.variants.size() == 2 && back.variants[0].flags == flags);
+    bTEST_ASSERT(back.variants[0].dimensions && back.variants[0].dimensions->height == 75.5);
+    bTEST_ASSERT(!back.variants[1].dimensions);
+
+    // unknown members are skipped and missing ones keep their values
+    Product partial{.name = u8"kept"};
+    parse_json(u8R"""({ "extra" : { "a" : [ 1, null ] }, "id" : 7, "sizes" : null, "matrix" : [ [ 3 ] ] })""", partial);
+    bTEST_ASSERT(partial.id == 7 && partial.name == u8"kept" && !partial.sizes);
+    bTEST_ASSERT(partial.matrix.size() == 1 && partial.matrix[0].size() == 1 && partial.matrix[0][0] == 3);
+
+    bool threw{false};
+    try
+    {
+        parse_json(u8R"""({ "variants" : [ { "size" : "huge" } ] })""", partial);
+    }
+    catch (const std::exception &)
+    {
+        threw = true;
+    }
+    bTEST_ASSERT(threw);
 };
\ No newline at end of file
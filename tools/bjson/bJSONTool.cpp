@@ -0,0 +1,132 @@
+/// @file bJSONTool.cpp
+/// @brief a command line tool which minifies/re-formats JSON files (or pipes) in constant memory.
+///
+/// Usage:
+///     bjson minify [input [output]]
+///     bjson format [--indent N] [--crlf] [--standard] [input [output]]
+///
+/// the input and output default to stdin and stdout (as does "-"). Returns 0 on success, 1 if the input is malformed
+/// (the error is printed to stderr and the output is incomplete), and 2 for usage errors.
+
+#include "bJSON.h"
+
+#include <cstdio>      // for the standard streams' file descriptors
+#include <fstream>     // for file input/output
+#include <string>      // for paths
+#include <string_view> // for arguments
+
+#ifdef _WIN32
+#    include <fcntl.h> // for _O_BINARY
+#    include <io.h>    // for _setmode
+#endif
+
+namespace
+{
+    /// @brief prints the usage to stderr
+    /// @return the usage error exit code
+    int usage()
+    {
+        std::cerr << "usage: bjson minify [input [output]]\n"
+                     "       bjson format [--indent N] [--crlf] [--standard] [input [output]]\n";
+        return 2;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    using namespace ben::json;
+
+    if (argc < 2)
+    {
+        return usage();
+    }
+
+    const std::string    command{argv[1]};
+    JSONSerializeOptions options{.style = JSONOutputStyle::pretty};
+    if (command == "minify")
+    {
+        options.style = JSONOutputStyle::compact;
+    }
+    else if (command != "format")
+    {
+        return usage();
+    }
+
+    // options (format only), then at most two paths
+    int arg{2};
+    for (; arg < argc && std::string_view{argv[arg]}.starts_with("--"); ++arg)
+    {
+        const std::string_view option{argv[arg]};
+        if (command == "format" && option == "--indent" && arg + 1 < argc)
+        {
+            const std::string_view width{argv[++arg]};
+            if (std::from_chars(width.data(), width.data() + width.size(), options.indent_width).ec != std::errc{})
+            {
+                return usage();
+            }
+        }
+        else if (command == "format" && option == "--crlf")
+        {
+            options.crlf = true;
+        }
+        else if (command == "format" && option == "--standard")
+        {
+            options.style = JSONOutputStyle::standard;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (argc - arg > 2)
+    {
+        return usage();
+    }
+    const std::string input_path{arg < argc ? argv[arg] : "-"};
+    const std::string output_path{arg + 1 < argc ? argv[arg + 1] : "-"};
+
+#ifdef _WIN32
+    // the standard streams must not translate line endings
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    std::ios::sync_with_stdio(false);
+
+    std::ifstream input_file{};
+    std::ofstream output_file{};
+    if (input_path != "-")
+    {
+        input_file.open(input_path, std::ios::binary);
+        if (!input_file)
+        {
+            std::cerr << "bjson: can not open " << input_path << "\n";
+            return 2;
+        }
+    }
+    if (output_path != "-")
+    {
+        output_file.open(output_path, std::ios::binary);
+        if (!output_file)
+        {
+            std::cerr << "bjson: can not open " << output_path << "\n";
+            return 2;
+        }
+    }
+    std::istream  &input{input_path != "-" ? static_cast<std::istream &>(input_file) : std::cin};
+    std::ostream  &output{output_path != "-" ? static_cast<std::ostream &>(output_file) : std::cout};
+    JSONStreamSink sink{output};
+
+    try
+    {
+        reformat(input, sink, options);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "bjson: " << e.what() << "\n";
+        return 1;
+    }
+
+    output.put('\n');
+    output.flush();
+    return output ? 0 : 1;
+}
@@ -0,0 +1,851 @@
+/// @file bJSONGen.cpp
+/// @brief a command line tool which generates C++ headers of structs and their (de)serializers from a simple IDL.
+///
+/// Usage:
+///     bjsongen input [output]
+///
+/// the input and output default to stdin and stdout (as does "-"). Returns 0 on success, 1 if the input is malformed
+/// (the error is printed to stderr with its line), and 2 for usage errors.
+///
+/// The IDL declares enums and structs (a type must be declared before it is used):
+///
+///     // the namespace of the generated types (optional)
+///     namespace shop;
+///
+///     enum Color { red, green, blue }
+///
+///     struct Item
+///     {
+///         u64 id;
+///         string name;
+///         Color color;
+///         optional<f64> price;
+///         list<string> tags;
+///         bytes thumbnail;
+///     }
+///
+/// the types of fields are bool, i8, i16, i32, i64, u8, u16, u32, u64, f32, f64, string (std::u8string), bytes
+/// (std::vector<std::uint8_t>, written as base64), the enums and structs declared before, list<T> (std::vector<T>),
+/// and optional<T> (std::optional<T>, written as null when empty). Fields are written under their names. The names of
+/// the namespace, types, fields, and enumerators become C++ names, so they can not be C++ keywords.
+///
+/// For every struct the header holds:
+///     - write_json(std::u8string &, const T &); one unrolled sequence of appends, with every key (and the
+///     punctuation around it) a string literal of known size, after one reservation of the known size of the output
+///     - read_json(ben::json::JSONPullReader &, T &); a loop over the members which dispatches on the size of each
+///     key with a switch (members which are not fields are skipped; fields which are missing keep their values)
+///     - parse_json(std::u8string_view, T &); read_json(...) of a whole text
+///     - a specialization of ben::json::JSONSerializationInfo<T> (so serialize(...) uses write_json(...))
+/// and every enum is registered with bJSON_ENUM(...).
+
+#include "bJSON.h"
+
+#include <fstream>     // for file input/output
+#include <iostream>    // for the standard streams
+#include <map>         // for grouping keys by size
+#include <set>         // for the C++ keywords
+#include <sstream>     // for reading the input and building the output
+#include <string>      // for names and generated code
+#include <string_view> // for tokens
+#include <vector>      // for declarations
+
+namespace
+{
+    /// @brief an error in the input
+    struct IdlError
+    {
+        std::size_t line; ///< the line of the error
+        std::string what; ///< the error
+    };
+
+    /// @brief the type of a field
+    struct Type
+    {
+        /// @brief the kinds of types
+        enum struct Kind
+        {
+            scalar,
+            enumeration,
+            structure,
+            list,
+            optional,
+        };
+
+        Kind              kind{Kind::scalar}; ///< the kind of the type
+        std::string       name{};             ///< the IDL name (of scalars, enums, and structs)
+        std::string       cpp{};              ///< the C++ type
+        std::size_t       size{0};            ///< the longest output of a scalar or enum
+        std::vector<Type> element{};          ///< the element type of lists and optionals (one type)
+    };
+
+    /// @brief a field of a struct
+    struct Field
+    {
+        Type        type{}; ///< the type of the field
+        std::string name{}; ///< the name of the field (and its key)
+    };
+
+    /// @brief a declared enum
+    struct Enum
+    {
+        std::string              name{};   ///< the name of the enum
+        std::vector<std::string> values{}; ///< the names of its enumerators
+    };
+
+    /// @brief a declared struct
+    struct Struct
+    {
+        std::string        name{};   ///< the name of the struct
+        std::vector<Field> fields{}; ///< its fields, in order
+    };
+
+    /// @brief the declarations of an IDL file
+    struct Idl
+    {
+        std::string         name_space{}; ///< the namespace of the generated types (may be empty)
+        std::vector<Enum>   enums{};      ///< the enums, in order
+        std::vector<Struct> structs{};    ///< the structs, in order
+    };
+
+    /// @brief the scalar types: their IDL names, C++ types, and longest outputs (for strings and bytes, the quotes)
+    const std::map<std::string, std::pair<std::string, std::size_t>> scalars{
+        {"bool", {"bool", 5}},
+        {"i8", {"std::int8_t", 4}},
+        {"i16", {"std::int16_t", 6}},
+        {"i32", {"std::int32_t", 11}},
+        {"i64", {"std::int64_t", 20}},
+        {"u8", {"std::uint8_t", 3}},
+        {"u16", {"std::uint16_t", 5}},
+        {"u32", {"std::uint32_t", 10}},
+        {"u64", {"std::uint64_t", 20}},
+        {"f32", {"float", 16}},
+        {"f64", {"double", 24}},
+        {"string", {"std::u8string", 2}},
+        {"bytes", {"std::vector<std::uint8_t>", 2}},
+    };
+
+    /// @brief the keywords (and alternative tokens) of C++, which can not be used as names
+    const std::set<std::string_view> keywords{
+        "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+        "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr",
+        "constinit", "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete",
+        "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+        "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+        "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+        "requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch",
+        "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+        "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+    };
+
+    /// @brief reads the declarations of IDL text
+    class Parser
+    {
+      public:
+        explicit Parser(std::string_view text) : text{text} { };
+
+        /// @throws IdlError if the text is malformed
+        Idl parse()
+        {
+            if (peek() == "namespace")
+            {
+                next();
+                idl.name_space = cpp_name();
+                while (peek() == "::")
+                {
+                    next();
+                    idl.name_space.append("::").append(cpp_name());
+                }
+                expect(";");
+            }
+            while (!peek().empty())
+            {
+                const std::string_view keyword{next()};
+                if (keyword == "enum")
+                {
+                    parse_enum();
+                }
+                else if (keyword == "struct")
+                {
+                    parse_struct();
+                }
+                else
+                {
+                    fail("expected enum or struct");
+                }
+            }
+            return idl;
+        }
+
+      private:
+        std::string_view text;    ///< the IDL text
+        std::size_t      pos{0};  ///< the offset of the next unit to read
+        std::size_t      line{1}; ///< the line of the next unit to read
+        Idl              idl{};   ///< the declarations read so far
+
+        [[noreturn]] void fail(const std::string &what) const { throw IdlError{line, what}; }
+
+        void skip_whitespace()
+        {
+            while (pos < text.size())
+            {
+                if (text[pos] == '\n')
+                {
+                    ++line;
+                }
+                if (text.substr(pos, 2) == "//")
+                {
+                    pos = std::min(text.find('\n', pos), text.size());
+                }
+                else if (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')
+                {
+                    ++pos;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        static bool identifier_unit(char unit, bool first)
+        {
+            return (unit >= 'a' && unit <= 'z') || (unit >= 'A' && unit <= 'Z') || unit == '_' ||
+                   (!first && unit >= '0' && unit <= '9');
+        }
+
+        /// @brief the next token (an identifier, "::", or a single punctuation unit), or empty at the end
+        std::string_view peek()
+        {
+            skip_whitespace();
+            if (pos == text.size())
+            {
+                return {};
+            }
+            std::size_t end{pos + 1};
+            if (identifier_unit(text[pos], true))
+            {
+                while (end < text.size() && identifier_unit(text[end], false))
+                {
+                    ++end;
+                }
+            }
+            else if (text.substr(pos, 2) == "::")
+            {
+                end = pos + 2;
+            }
+            return text.substr(pos, end - pos);
+        }
+
+        std::string_view next()
+        {
+            const std::string_view token{peek()};
+            pos += token.size();
+            return token;
+        }
+
+        void expect(std::string_view token)
+        {
+            if (next() != token)
+            {
+                fail("expected '" + std::string{token} + "'");
+            }
+        }
+
+        std::string name()
+        {
+            const std::string_view token{next()};
+            if (token.empty() || !identifier_unit(token.front(), true))
+            {
+                fail("expected a name");
+            }
+            return std::string{token};
+        }
+
+        /// @brief a name which becomes a C++ name (of the namespace, a type, a field, or an enumerator)
+        std::string cpp_name()
+        {
+            std::string declared{name()};
+            if (keywords.contains(declared))
+            {
+                fail("'" + declared + "' is a C++ keyword");
+            }
+            return declared;
+        }
+
+        std::string declared_name()
+        {
+            std::string declared{cpp_name()};
+            if (scalars.contains(declared) || declared == "list" || declared == "optional" || find(declared))
+            {
+                fail("'" + declared + "' is already a type");
+            }
+            return declared;
+        }
+
+        /// @brief the declared type of a name (nullptr if it is not declared)
+        const void *find(const std::string &type_name) const
+        {
+            for (const Enum &declared : idl.enums)
+            {
+                if (declared.name == type_name)
+                {
+                    return &declared;
+                }
+            }
+            for (const Struct &declared : idl.structs)
+            {
+                if (declared.name == type_name)
+                {
+                    return &declared;
+                }
+            }
+            return nullptr;
+        }
+
+        void parse_enum()
+        {
+            Enum declared{declared_name()};
+            expect("{");
+            while (peek() != "}")
+            {
+                declared.values.push_back(cpp_name());
+                if (peek() != ",")
+                {
+                    break;
+                }
+                next();
+            }
+            expect("}");
+            if (declared.values.empty())
+            {
+                fail("enum '" + declared.name + "' has no enumerators");
+            }
+            idl.enums.push_back(std::move(declared));
+        }
+
+        void parse_struct()
+        {
+            Struct declared{declared_name()};
+            expect("{");
+            while (peek() != "}" && !peek().empty())
+            {
+                Field field{type()};
+                field.name = cpp_name();
+                for (const Field &other : declared.fields)
+                {
+                    if (other.name == field.name)
+                    {
+                        fail("field '" + field.name + "' is declared twice");
+                    }
+                }
+                expect(";");
+                declared.fields.push_back(std::move(field));
+            }
+            expect("}");
+            idl.structs.push_back(std::move(declared));
+        }
+
+        Type type()
+        {
+            Type parsed{};
+            parsed.name = name();
+            if (parsed.name == "list" || parsed.name == "optional")
+            {
+                parsed.kind = parsed.name == "list" ? Type::Kind::list : Type::Kind::optional;
+                expect("<");
+                parsed.element.push_back(type());
+                expect(">");
+                parsed.cpp = (parsed.kind == Type::Kind::list ? "std::vector<" : "std::optional<") +
+                             parsed.element.front().cpp + ">";
+                return parsed;
+            }
+
+            const auto scalar{scalars.find(parsed.name)};
+            if (scalar != scalars.end())
+            {
+                parsed.cpp  = scalar->second.first;
+                parsed.size = scalar->second.second;
+                return parsed;
+            }
+            for (const Enum &declared : idl.enums)
+            {
+                if (declared.name == parsed.name)
+                {
+                    parsed.kind = Type::Kind::enumeration;
+                    parsed.cpp  = parsed.name;
+                    for (const std::string &value : declared.values)
+                    {
+                        parsed.size = std::max(parsed.size, value.size() + 2);
+                    }
+                    return parsed;
+                }
+            }
+            for (const Struct &declared : idl.structs)
+            {
+                if (declared.name == parsed.name)
+                {
+                    parsed.kind = Type::Kind::structure;
+                    parsed.cpp  = parsed.name;
+                    return parsed;
+                }
+            }
+            fail("unknown type '" + parsed.name + "' (types must be declared before they are used)");
+        }
+    };
+
+    /// @brief writes the header of the declarations of an IDL file
+    class Generator
+    {
+      public:
+        Generator(Idl idl, std::string source) : idl{std::move(idl)}, source{std::move(source)} { };
+
+        std::string generate()
+        {
+            out << "/// @file\n"
+                << "/// @brief structs and JSON (de)serializers generated by bjsongen from " << source
+                << " (do not edit)\n\n"
+                << "#pragma once\n\n"
+                << "#include \"bJSON.h\"\n\n"
+                << "#include <cstdint>     // for fixed width integers\n"
+                << "#include <optional>    // for optional fields\n"
+                << "#include <string>      // for strings\n"
+                << "#include <string_view> // for the text to parse\n"
+                << "#include <vector>      // for lists and bytes\n";
+
+            // the types and the declarations of their functions (so structs may be used before they are written)
+            open_namespace();
+            for (const Enum &declared : idl.enums)
+            {
+                write_enum(declared);
+            }
+            for (const Struct &declared : idl.structs)
+            {
+                write_struct(declared);
+            }
+            for (const Struct &declared : idl.structs)
+            {
+                out << "\n"
+                    << indent() << "inline void write_json(std::u8string &out, const " << declared.name
+                    << " &value);\n"
+                    << indent() << "inline void read_json(ben::json::JSONPullReader &reader, " << declared.name
+                    << " &value);\n";
+            }
+            close_namespace();
+
+            // the registrations (outside of any namespace, like the helper macros require)
+            for (const Enum &declared : idl.enums)
+            {
+                out << "\nbJSON_ENUM(" << qualified(declared.name);
+                for (const std::string &value : declared.values)
+                {
+                    out << ", " << value;
+                }
+                out << ");\n";
+            }
+            for (const Struct &declared : idl.structs)
+            {
+                out << "\nbJSON_MAKE_SERIALIZABLE_INLINE(" << qualified(declared.name) << ")\n"
+                    << "{\n"
+                    << "    std::u8string serialized{u8\"\"};\n"
+                    << "    " << qualified("write_json") << "(serialized, val);\n"
+                    << "    return serialized;\n"
+                    << "}\n";
+            }
+
+            open_namespace();
+            for (const Struct &declared : idl.structs)
+            {
+                write_writer(declared);
+                write_reader(declared);
+            }
+            close_namespace();
+            return out.str();
+        }
+
+      private:
+        Idl                idl;      ///< the declarations
+        std::string        source;   ///< the name of the IDL file
+        std::ostringstream out{};    ///< the header
+        std::size_t        depth{0}; ///< the indentation level
+
+        std::string indent() const { return std::string(depth * 4, ' '); }
+
+        /// @brief a type name with its article ("a Point", "an Item")
+        static std::string article(const std::string &name)
+        {
+            return (std::string_view{"AEIOUaeiou"}.find(name.front()) == std::string_view::npos ? "a " : "an ") +
+                   name;
+        }
+
+        std::string qualified(const std::string &name) const
+        {
+            return idl.name_space.empty() ? name : idl.name_space + "::" + name;
+        }
+
+        void open_namespace()
+        {
+            if (!idl.name_space.empty())
+            {
+                out << "\nnamespace " << idl.name_space << "\n{";
+                ++depth;
+            }
+        }
+
+        void close_namespace()
+        {
+            if (!idl.name_space.empty())
+            {
+                --depth;
+                out << "} // namespace " << idl.name_space << "\n";
+            }
+        }
+
+        /// @brief a string of C++ code with its units written as a string literal (keys are identifiers, so only
+        /// quotes are escaped)
+        static std::string literal(const std::string &units)
+        {
+            std::string escaped{"u8\""};
+            for (const char unit : units)
+            {
+                if (unit == '\"')
+                {
+                    escaped.push_back('\\');
+                }
+                escaped.push_back(unit);
+            }
+            return escaped + "\"";
+        }
+
+        /// @brief a line appending a constant fragment
+        void append(const std::string &fragment)
+        {
+            out << indent() << "out.append(" << literal(fragment) << ", " << fragment.size() << ");\n";
+        }
+
+        void write_enum(const Enum &declared)
+        {
+            out << "\n" << indent() << "enum struct " << declared.name << "\n" << indent() << "{\n";
+            for (const std::string &value : declared.values)
+            {
+                out << indent() << "    " << value << ",\n";
+            }
+            out << indent() << "};\n";
+        }
+
+        void write_struct(const Struct &declared)
+        {
+            // the names are aligned, as clang-format would
+            std::size_t width{0};
+            for (const Field &field : declared.fields)
+            {
+                width = std::max(width, field.type.cpp.size());
+            }
+            out << "\n" << indent() << "struct " << declared.name << "\n" << indent() << "{\n";
+            for (const Field &field : declared.fields)
+            {
+                out << indent() << "    " << field.type.cpp << std::string(width + 1 - field.type.cpp.size(), ' ')
+                    << field.name << "{};\n";
+            }
+            out << indent() << "};\n";
+        }
+
+        /// @brief the code of the known size of a value's output (a constant, plus the sizes of strings, bytes, and
+        /// lists of fixed size elements)
+        static std::string known_size(const Type &type, const std::string &value, std::size_t &constant)
+        {
+            switch (type.kind)
+            {
+            case Type::Kind::scalar:
+                constant += type.size;
+                if (type.name == "string")
+                {
+                    return " + " + value + ".size()";
+                }
+                if (type.name == "bytes")
+                {
+                    return " + ben::json::JSONBase64::encoded_size(" + value + ".size())";
+                }
+                return "";
+            case Type::Kind::enumeration:
+                constant += type.size;
+                return "";
+            case Type::Kind::list:
+            {
+                constant += 4; // "[ " and " ]"
+                const Type &element{type.element.front()};
+                if ((element.kind == Type::Kind::scalar && element.name != "string" && element.name != "bytes") ||
+                    element.kind == Type::Kind::enumeration)
+                {
+                    return " + " + value + ".size() * " + std::to_string(element.size + 2);
+                }
+                return "";
+            }
+            case Type::Kind::optional:
+            {
+                // the size of the value when it is present (so only its constant part)
+                std::size_t element{0};
+                known_size(type.element.front(), value, element);
+                constant += std::max<std::size_t>(element, 4);
+                return "";
+            }
+            case Type::Kind::structure:
+            default:
+                return ""; // (written by its own writer, which makes its own reservation)
+            }
+        }
+
+        /// @brief the code which writes a value
+        void write_value(const Type &type, const std::string &value, std::size_t level)
+        {
+            switch (type.kind)
+            {
+            case Type::Kind::scalar:
+            case Type::Kind::enumeration:
+                out << indent() << "ben::json::JSONMemberWriter::write(out, "
+                    << (type.name == "bytes" ? "ben::json::JSONBlob{" + value + "}" : value) << ");\n";
+                break;
+            case Type::Kind::structure:
+                out << indent() << "write_json(out, " << value << ");\n";
+                break;
+            case Type::Kind::list:
+            {
+                const std::string index{"i" + std::to_string(level)};
+                out << indent() << "out.push_back(u8'[');\n"
+                    << indent() << "for (std::size_t " << index << " = 0; " << index << " < " << value << ".size(); ++"
+                    << index << ")\n"
+                    << indent() << "{\n";
+                ++depth;
+                out << indent() << "out.append(" << index << " == 0 ? u8\" \" : u8\", \", " << index
+                    << " == 0 ? 1 : 2);\n";
+                write_value(type.element.front(), value + "[" + index + "]", level + 1);
+                --depth;
+                out << indent() << "}\n";
+                append(" ]");
+                break;
+            }
+            case Type::Kind::optional:
+            default:
+                out << indent() << "if (" << value << ")\n" << indent() << "{\n";
+                ++depth;
+                write_value(type.element.front(), "(*" + value + ")", level);
+                --depth;
+                out << indent() << "}\n" << indent() << "else\n" << indent() << "{\n";
+                ++depth;
+                append("null");
+                --depth;
+                out << indent() << "}\n";
+                break;
+            }
+        }
+
+        /// @brief the code which reads a value
+        void read_value(const Type &type, const std::string &value, std::size_t level)
+        {
+            switch (type.kind)
+            {
+            case Type::Kind::scalar:
+            case Type::Kind::enumeration:
+                out << indent() << "reader.read(" << value << ");\n";
+                break;
+            case Type::Kind::structure:
+                out << indent() << "read_json(reader, " << value << ");\n";
+                break;
+            case Type::Kind::list:
+            {
+                const std::string element{"element" + std::to_string(level)};
+                out << indent() << value << ".clear();\n"
+                    << indent() << "reader.begin_array();\n"
+                    << indent() << "while (reader.next_element())\n"
+                    << indent() << "{\n";
+                ++depth;
+                if (type.element.front().name == "bool")
+                {
+                    // std::vector<bool> has no references to its elements, so the value is read into a local first
+                    out << indent() << "bool " << element << "{false};\n"
+                        << indent() << "reader.read(" << element << ");\n"
+                        << indent() << value << ".push_back(" << element << ");\n";
+                }
+                else
+                {
+                    out << indent() << "auto &" << element << "{" << value << ".emplace_back()};\n";
+                    read_value(type.element.front(), element, level + 1);
+                }
+                --depth;
+                out << indent() << "}\n";
+                break;
+            }
+            case Type::Kind::optional:
+            default:
+            {
+                const std::string present{"present" + std::to_string(level)};
+                out << indent() << "if (reader.read_null())\n"
+                    << indent() << "{\n"
+                    << indent() << "    " << value << ".reset();\n"
+                    << indent() << "}\n"
+                    << indent() << "else\n"
+                    << indent() << "{\n";
+                ++depth;
+                out << indent() << "auto &" << present << "{" << value << ".emplace()};\n";
+                read_value(type.element.front(), present, level + 1);
+                --depth;
+                out << indent() << "}\n";
+                break;
+            }
+            }
+        }
+
+        void write_writer(const Struct &declared)
+        {
+            // the fragments: the punctuation before each key, the key, and the colon
+            std::vector<std::string> fragments{};
+            std::size_t              constant{declared.fields.empty() ? 3u : 2u};
+            std::string              sizes{};
+            for (std::size_t i = 0; i < declared.fields.size(); ++i)
+            {
+                const Field &field{declared.fields[i]};
+                fragments.push_back((i == 0 ? "{ \"" : ", \"") + field.name + "\" : ");
+                constant += fragments.back().size();
+                sizes += known_size(field.type, "value." + field.name, constant);
+            }
+
+            out << "\n"
+                << indent() << "/// @brief writes " << article(declared.name) << " as a JSON object\n"
+                << indent() << "inline void write_json(std::u8string &out, const " << declared.name
+                << (declared.fields.empty() ? " &)\n" : " &value)\n")
+                << indent() << "{\n";
+            ++depth;
+            out << indent() << "out.reserve(out.size() + " << constant << sizes << ");\n";
+            for (std::size_t i = 0; i < declared.fields.size(); ++i)
+            {
+                append(fragments[i]);
+                write_value(declared.fields[i].type, "value." + declared.fields[i].name, 0);
+            }
+            append(declared.fields.empty() ? "{ }" : " }");
+            --depth;
+            out << indent() << "}\n";
+        }
+
+        void write_reader(const Struct &declared)
+        {
+            // the fields by the size of their keys, so a key is only compared to the keys of its size
+            std::map<std::size_t, std::vector<const Field *>> by_size{};
+            for (const Field &field : declared.fields)
+            {
+                by_size[field.name.size()].push_back(&field);
+            }
+
+            out << "\n"
+                << indent() << "/// @brief reads " << article(declared.name)
+                << " from a JSON object (members which are not fields are skipped)\n"
+                << indent() << "inline void read_json(ben::json::JSONPullReader &reader, " << declared.name
+                << (declared.fields.empty() ? " &)\n" : " &value)\n")
+                << indent() << "{\n";
+            ++depth;
+            out << indent() << "reader.begin_object();\n"
+                << indent() << "while (reader.next_member())\n"
+                << indent() << "{\n";
+            ++depth;
+            if (!by_size.empty())
+            {
+                out << indent() << "const std::u8string_view key{reader.key()};\n"
+                    << indent() << "switch (key.size())\n"
+                    << indent() << "{\n";
+                for (const auto &[size, fields] : by_size)
+                {
+                    out << indent() << "case " << size << ":\n";
+                    ++depth;
+                    for (const Field *field : fields)
+                    {
+                        out << indent() << "if (key == " << literal(field->name) << ")\n" << indent() << "{\n";
+                        ++depth;
+                        read_value(field->type, "value." + field->name, 0);
+                        out << indent() << "continue;\n";
+                        --depth;
+                        out << indent() << "}\n";
+                    }
+                    out << indent() << "break;\n";
+                    --depth;
+                }
+                out << indent() << "default:\n" << indent() << "    break;\n" << indent() << "}\n";
+            }
+            out << indent() << "reader.skip();\n";
+            --depth;
+            out << indent() << "}\n";
+            --depth;
+            out << indent() << "}\n";
+
+            out << "\n"
+                << indent() << "/// @brief reads " << article(declared.name) << " from JSON text\n"
+                << indent() << "/// @throws std::exception if the text is malformed (or does not hold "
+                << article(declared.name) << ")\n"
+                << indent() << "inline void parse_json(std::u8string_view text, " << declared.name << " &value)\n"
+                << indent() << "{\n"
+                << indent() << "    ben::json::JSONPullReader reader{text};\n"
+                << indent() << "    read_json(reader, value);\n"
+                << indent() << "    reader.finish();\n"
+                << indent() << "}\n";
+        }
+    };
+
+    /// @brief prints the usage to stderr
+    /// @return the usage error exit code
+    int usage()
+    {
+        std::cerr << "usage: bjsongen input [output]\n";
+        return 2;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        return usage();
+    }
+    const std::string input_path{argv[1]};
+    const std::string output_path{argc > 2 ? argv[2] : "-"};
+
+    std::ostringstream text{};
+    if (input_path != "-")
+    {
+        std::ifstream input_file{input_path, std::ios::binary};
+        if (!input_file)
+        {
+            std::cerr << "bjsongen: can not open " << input_path << "\n";
+            return 2;
+        }
+        text << input_file.rdbuf();
+    }
+    else
+    {
+        text << std::cin.rdbuf();
+    }
+
+    std::string header{};
+    try
+    {
+        Parser parser{text.view()};
+        Generator generator{parser.parse(), input_path == "-" ? "stdin" : input_path};
+        header = generator.generate();
+    }
+    catch (const IdlError &error)
+    {
+        std::cerr << "bjsongen: " << input_path << ":" << error.line << ": " << error.what << "\n";
+        return 1;
+    }
+
+    if (output_path == "-")
+    {
+        std::cout << header;
+        std::cout.flush();
+        return std::cout ? 0 : 1;
+    }
+    std::ofstream output_file{output_path, std::ios::binary};
+    if (!output_file)
+    {
+        std::cerr << "bjsongen: can not open " << output_path << "\n";
+        return 2;
+    }
+    output_file << header;
+    return output_file ? 0 : 1;
+}
\ No newline at end of file